@@ -0,0 +1,149 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+	/* required for the cpu affinity functions, must precede the system headers */
+#	define _GNU_SOURCE
+#endif
+#include "async.h"
+#include <stdlib.h>
+#if defined(QSC_SYSTEM_OS_POSIX)
+#	include <unistd.h>
+#endif
+#if defined(QSC_SYSTEM_OS_LINUX)
+#	include <sched.h>
+#endif
+
+typedef struct
+{
+	qsc_async_thread_function func;
+	void* state;
+} async_thread_args;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+
+static unsigned __stdcall async_thread_start(void* args)
+{
+	async_thread_args targs;
+
+	targs = *(async_thread_args*)args;
+	free(args);
+	targs.func(targs.state);
+
+	return 0;
+}
+
+#else
+
+static void* async_thread_start(void* args)
+{
+	async_thread_args targs;
+
+	targs = *(async_thread_args*)args;
+	free(args);
+	targs.func(targs.state);
+
+	return NULL;
+}
+
+#endif
+
+bool qsc_async_thread_create(qsc_thread* handle, qsc_async_thread_function func, void* state)
+{
+	assert(handle != NULL);
+	assert(func != NULL);
+
+	async_thread_args* targs;
+	bool res;
+
+	res = false;
+
+	if (handle != NULL && func != NULL)
+	{
+		targs = (async_thread_args*)malloc(sizeof(async_thread_args));
+
+		if (targs != NULL)
+		{
+			targs->func = func;
+			targs->state = state;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+			*handle = (HANDLE)_beginthreadex(NULL, 0, async_thread_start, targs, 0, NULL);
+			res = (*handle != 0);
+#else
+			res = (pthread_create(handle, NULL, async_thread_start, targs) == 0);
+#endif
+
+			if (res == false)
+			{
+				free(targs);
+			}
+		}
+	}
+
+	return res;
+}
+
+void qsc_async_thread_wait(qsc_thread* handle)
+{
+	assert(handle != NULL);
+
+	if (handle != NULL)
+	{
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+		WaitForSingleObject(*handle, INFINITE);
+		CloseHandle(*handle);
+#else
+		pthread_join(*handle, NULL);
+#endif
+	}
+}
+
+bool qsc_async_thread_affinity(size_t core)
+{
+	bool res;
+
+	res = false;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	if (core < sizeof(DWORD_PTR) * 8)
+	{
+		res = (SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core) != 0);
+	}
+#elif defined(QSC_SYSTEM_OS_LINUX)
+	cpu_set_t cset;
+
+	if (core < CPU_SETSIZE)
+	{
+		CPU_ZERO(&cset);
+		CPU_SET(core, &cset);
+		res = (pthread_setaffinity_np(pthread_self(), sizeof(cset), &cset) == 0);
+	}
+#else
+	/* thread affinity is not supported on this platform */
+	(void)core;
+#endif
+
+	return res;
+}
+
+size_t qsc_async_processor_count(void)
+{
+	size_t res;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	SYSTEM_INFO sysinf;
+
+	GetSystemInfo(&sysinf);
+	res = (size_t)sysinf.dwNumberOfProcessors;
+#else
+	long cnt;
+
+	cnt = sysconf(_SC_NPROCESSORS_ONLN);
+	res = (cnt > 0) ? (size_t)cnt : 1;
+#endif
+
+	if (res == 0)
+	{
+		res = 1;
+	}
+
+	return res;
+}
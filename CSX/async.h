@@ -0,0 +1,89 @@
+/* The AGPL version 3 License (AGPLv3)
+*
+* Copyright (c) 2021 Digital Freedom Defence Inc.
+* This file is part of the QSC Cryptographic library
+*
+* This program is free software : you can redistribute it and / or modify
+* it under the terms of the GNU Affero General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef QSC_ASYNC_H
+#define QSC_ASYNC_H
+
+#include "common.h"
+
+/*
+* \file async.h
+* \brief Contains portable thread creation and synchronization functions
+*/
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+#	include <Windows.h>
+#	include <process.h>
+/*!
+* \def qsc_thread
+* \brief The native thread handle type
+*/
+#	define qsc_thread HANDLE
+#elif defined(QSC_SYSTEM_OS_POSIX)
+#	include <pthread.h>
+#	define qsc_thread pthread_t
+#else
+#	error The operating system is not supported!
+#endif
+
+/*!
+* \def QSC_ASYNC_THREADS_MAX
+* \brief The maximum number of threads used by the library parallel functions
+*/
+#define QSC_ASYNC_THREADS_MAX 64
+
+/**
+* \brief The thread function prototype
+*/
+typedef void (*qsc_async_thread_function)(void*);
+
+/**
+* \brief Create a thread and start it executing the function
+*
+* \param handle: [out] The thread handle
+* \param func: The function executed by the thread
+* \param state: The argument passed to the function
+* \return Returns true if the thread was created
+*/
+QSC_EXPORT_API bool qsc_async_thread_create(qsc_thread* handle, qsc_async_thread_function func, void* state);
+
+/**
+* \brief Wait for a thread to complete, and release the thread handle
+*
+* \param handle: The thread handle
+*/
+QSC_EXPORT_API void qsc_async_thread_wait(qsc_thread* handle);
+
+/**
+* \brief Pin the calling thread to a single logical processor.
+* Supported on Windows and Linux, on other systems the thread is not pinned and the function returns false.
+*
+* \param core: The zero-based logical processor index
+* \return Returns true if the thread affinity was set
+*/
+QSC_EXPORT_API bool qsc_async_thread_affinity(size_t core);
+
+/**
+* \brief Get the number of logical processors available to this process
+*
+* \return Returns the processor count, minimum of one
+*/
+QSC_EXPORT_API size_t qsc_async_processor_count(void);
+
+#endif
@@ -1,14 +1,291 @@
 #include "benchmark.h"
 #include "testutils.h"
 #include "timerex.h"
+#include "async.h"
 #include "csp.h"
+#include "cpuidex.h"
 #include "csx.h"
+#include "intutils.h"
+#include "memutils.h"
+#include "perfcounters.h"
 #include "sha3.h"
+#include <stdio.h>
+#include <stdlib.h>
+#if defined(QSC_SYSTEM_OS_POSIX)
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
 
 /* bs*sc = 1GB */
 #define BUFFER_SIZE 1024
 #define SAMPLE_COUNT 1000000
 #define ONE_GIGABYTE 1024000000
+/* tree-mode message size, hashed 16 times = 1GB */
+#define TREE_BUFFER_SIZE 64000000
+#define TREE_SAMPLE_COUNT 16
+/* kangarootwelve and parallelhash message size, nine 8192 byte chunks; after the first chunk
+   kangarootwelve has eight full leaves for the 8-way leaf path, hashed 14000 times = ~1GB */
+#define KT_BUFFER_SIZE (9 * QSC_KT_CHUNK_SIZE)
+#define KT_SAMPLE_COUNT 14000
+#define PARALLELHASH_BLOCK_SIZE QSC_KT_CHUNK_SIZE
+/* csx size sweep; 16 bytes to 64 MiB, each size timed until the byte budget or sample limit is reached */
+#define SWEEP_SIZE_MIN 16
+#define SWEEP_SIZE_MAX 67108864
+#define SWEEP_BYTE_BUDGET 67108864
+#define SWEEP_SAMPLES_MIN 8
+#define SWEEP_SAMPLES_MAX 10000
+#define SWEEP_WARMUP_DIVISOR 10
+/* multi-core scaling; every thread processes 128MB of independent 16KB messages */
+#define SCALING_BUFFER_SIZE 16384
+#define SCALING_THREAD_BYTES 134217728
+/* hardware counter measurements; one million chained calls per permutation kernel */
+#define COUNTERS_PERMUTATION_COUNT 1000000
+/* raw permutation timing, a warm-up then one million chained calls per kernel */
+#define PERMUTATION_SAMPLE_COUNT 1000000
+#define PERMUTATION_WARMUP_COUNT 10000
+#define PERMUTATION_CSX_ROUNDS 40
+/* key-setup latency, the median of individually timed calls */
+#define SETUP_SAMPLE_COUNT 100000
+#define SETUP_ARENA_CAPACITY 1024
+
+/* a decryption that moves half of a typical last level cache through it, interleaved with a cache-resident working set */
+#define STREAM_MESSAGE_SIZE 16777216
+#define STREAM_VICTIM_SIZE 4194304
+#define STREAM_SAMPLE_COUNT 9
+/* drbg throughput, 1MB requests for 256MB; small request latency uses the setup sample count */
+#define DRBG_REQUEST_SIZE 1048576
+#define DRBG_REQUEST_COUNT 256
+/* machine-readable report and baseline comparison */
+#define BENCHMARK_CPU_MAX 64
+#define BENCHMARK_FIELDS_MAX 8
+#define BENCHMARK_LINE_MAX 512
+#define BENCHMARK_NAME_MAX 96
+#define BENCHMARK_ROWS_MAX 512
+#define BENCHMARK_CSV_HEADER "algorithm,backend,size,threads,cycles_per_byte,ns_per_op,cpu,flags"
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+#	define BENCHMARK_BACKEND "avx512"
+#elif defined(QSC_SYSTEM_HAS_AVX2)
+#	define BENCHMARK_BACKEND "avx2"
+#else
+#	define BENCHMARK_BACKEND "scalar"
+#endif
+
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+#	define BENCHMARK_COMPILER "msc"
+#elif defined(QSC_SYSTEM_COMPILER_CLANG)
+#	define BENCHMARK_COMPILER "clang"
+#elif defined(QSC_SYSTEM_COMPILER_GCC)
+#	define BENCHMARK_COMPILER "gcc"
+#else
+#	define BENCHMARK_COMPILER "unknown"
+#endif
+
+#if defined(QSC_DEBUG_MODE)
+#	define BENCHMARK_BUILD "debug"
+#else
+#	define BENCHMARK_BUILD "release"
+#endif
+
+#if !defined(QSC_CSX_AUTHENTICATED)
+#	define BENCHMARK_MAC "none"
+#elif defined(QSC_CSX_KPA_AUTHENTICATION)
+#	define BENCHMARK_MAC "kpa"
+#else
+#	define BENCHMARK_MAC "kmac"
+#endif
+
+/* space separated so the field does not need quoting in csv */
+#define BENCHMARK_FLAGS BENCHMARK_COMPILER " " BENCHMARK_BUILD " " BENCHMARK_BACKEND " mac-" BENCHMARK_MAC
+
+typedef struct
+{
+	uint64_t cycles;	/* the counter at the start, then the elapsed cycles */
+	uint64_t nsec;		/* the monotonic time at the start, then the elapsed nanoseconds */
+} benchmark_timer;
+
+typedef struct
+{
+	FILE* file;								/* the open report file, or NULL when reporting is disabled */
+	qsctest_benchmark_format format;		/* the report record format */
+	size_t records;							/* the number of records written */
+	char cpu[BENCHMARK_CPU_MAX];			/* the cpu description written to every record */
+} benchmark_report_state;
+
+typedef struct
+{
+	char algorithm[BENCHMARK_NAME_MAX];
+	char backend[BENCHMARK_NAME_MAX];
+	uint64_t size;
+	uint64_t threads;
+	double cpb;
+	double nsop;
+} benchmark_report_row;
+
+typedef enum
+{
+	scaling_csx_seal = 0,	/* csx encryption and mac generation */
+	scaling_csx_open = 1,	/* csx mac verification and decryption */
+	scaling_kmac256 = 2,	/* kmac-256 message authentication */
+} benchmark_scaling_mode;
+
+typedef struct
+{
+	benchmark_scaling_mode mode;	/* the operation run by the thread */
+	size_t core;					/* the logical processor the thread is pinned to */
+	uint64_t bytes;					/* the number of bytes processed by the thread */
+	bool pinned;					/* the thread affinity was set */
+} benchmark_scaling_args;
+
+static benchmark_report_state benchmark_report = { NULL, qsctest_benchmark_format_csv, 0, { 0 } };
+
+static void benchmark_start(benchmark_timer* tmr)
+{
+	tmr->nsec = qsc_timerex_monotonic_ns();
+	tmr->cycles = qsc_timerex_cycles_start();
+}
+
+static void benchmark_stop(benchmark_timer* tmr)
+{
+	tmr->cycles = qsc_timerex_cycles_stop() - tmr->cycles;
+	tmr->nsec = qsc_timerex_stopwatch_elapsed_ns(tmr->nsec);
+}
+
+static void benchmark_clock_print()
+{
+	/* calibrates the cycle counter before the first timed region */
+	qsctest_print_safe("Cycle counter frequency: ");
+	qsctest_print_ulong(qsc_timerex_cycles_frequency() / 1000000);
+	qsctest_print_line(" MHz");
+}
+
+static void benchmark_field_write(FILE* fp, const char* field, qsctest_benchmark_format format)
+{
+	/* a json string escapes quotes and backslashes; a csv field containing a comma or quote is quoted, with its quotes doubled */
+	if (format == qsctest_benchmark_format_json)
+	{
+		fputc('"', fp);
+
+		for (const char* p = field; *p != 0; ++p)
+		{
+			if (*p == '"' || *p == '\\')
+			{
+				fputc('\\', fp);
+			}
+
+			fputc(*p, fp);
+		}
+
+		fputc('"', fp);
+	}
+	else if (strpbrk(field, ",\"") != NULL)
+	{
+		fputc('"', fp);
+
+		for (const char* p = field; *p != 0; ++p)
+		{
+			if (*p == '"')
+			{
+				fputc('"', fp);
+			}
+
+			fputc(*p, fp);
+		}
+
+		fputc('"', fp);
+	}
+	else
+	{
+		fputs(field, fp);
+	}
+}
+
+static void benchmark_record(const char* algorithm, uint64_t size, size_t threads, double cpb, double nsop)
+{
+	FILE* fp;
+
+	fp = benchmark_report.file;
+
+	if (fp != NULL)
+	{
+		if (benchmark_report.format == qsctest_benchmark_format_json)
+		{
+			fprintf(fp, "%s\n  { \"algorithm\": ", (benchmark_report.records == 0) ? "[" : ",");
+			benchmark_field_write(fp, algorithm, qsctest_benchmark_format_json);
+			fprintf(fp, ", \"backend\": \"%s\", \"size\": %llu, \"threads\": %llu, \"cycles_per_byte\": %.4f, \"ns_per_op\": %.2f, \"cpu\": ",
+				BENCHMARK_BACKEND, (unsigned long long)size, (unsigned long long)threads, cpb, nsop);
+			benchmark_field_write(fp, benchmark_report.cpu, qsctest_benchmark_format_json);
+			fprintf(fp, ", \"flags\": \"%s\" }", BENCHMARK_FLAGS);
+		}
+		else
+		{
+			benchmark_field_write(fp, algorithm, qsctest_benchmark_format_csv);
+			fprintf(fp, ",%s,%llu,%llu,%.4f,%.2f,", BENCHMARK_BACKEND, (unsigned long long)size, (unsigned long long)threads, cpb, nsop);
+			benchmark_field_write(fp, benchmark_report.cpu, qsctest_benchmark_format_csv);
+			fprintf(fp, ",%s\n", BENCHMARK_FLAGS);
+		}
+
+		fflush(fp);
+		++benchmark_report.records;
+	}
+}
+
+static void benchmark_print(const char* algorithm, size_t threads, const benchmark_timer* tmr, uint64_t bytes, uint64_t ops)
+{
+	qsctest_print_safe(algorithm);
+
+	if (threads > 1)
+	{
+		qsctest_print_safe(" with ");
+		qsctest_print_ulong(threads);
+		qsctest_print_safe(" threads");
+	}
+
+	qsctest_print_safe(" processed ");
+	qsctest_print_ulong(bytes / 1000000);
+	qsctest_print_safe("MB of data in ");
+	qsctest_print_double((double)tmr->nsec / 1000000000.0);
+	qsctest_print_safe(" seconds, ");
+	qsctest_print_double((double)tmr->cycles / (double)bytes);
+	qsctest_print_safe(" cycles/byte, ");
+	qsctest_print_double((double)tmr->nsec / (double)ops);
+	qsctest_print_line(" ns/op");
+
+	benchmark_record(algorithm, bytes / ops, threads, (double)tmr->cycles / (double)bytes, (double)tmr->nsec / (double)ops);
+}
+
+#if defined(QSC_CSX_STATISTICS)
+static void csx_stats_print()
+{
+	const char* NAMES[QSC_CSX_STATS_STAGES] = { "nonce     ", "keystream ", "absorb    ", "finalize  " };
+	qsc_csx_stats stats;
+	uint64_t total;
+	size_t i;
+
+	qsc_csx_stats_snapshot(&stats);
+	total = 0;
+
+	for (i = 0; i < QSC_CSX_STATS_STAGES; ++i)
+	{
+		total += stats.cycles[i];
+	}
+
+	for (i = 0; i < QSC_CSX_STATS_STAGES && total != 0; ++i)
+	{
+		if (stats.calls[i] != 0)
+		{
+			qsctest_print_safe("  ");
+			qsctest_print_safe(NAMES[i]);
+			qsctest_print_double((double)stats.cycles[i] / (double)stats.calls[i]);
+			qsctest_print_safe(" cycles/call, ");
+			qsctest_print_double((double)stats.cycles[i] / (double)stats.bytes[i]);
+			qsctest_print_safe(" cycles/byte, ");
+			qsctest_print_double(((double)stats.cycles[i] * 100.0) / (double)total);
+			qsctest_print_line("% of the transform");
+		}
+	}
+}
+#endif
 
 static void csx_benchmark_test()
 {
@@ -18,8 +295,7 @@ static void csx_benchmark_test()
 	uint8_t nonce[QSC_CSX_NONCE_SIZE] = { 0 };
 	qsc_csx_state ctx;
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	/* generate the message, key and nonce */
 	qsc_csp_generate(key, sizeof(key));
@@ -30,22 +306,593 @@ static void csx_benchmark_test()
 	/* encryption */
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	qsc_csx_initialize(&ctx, &kp, true);
 
+#if defined(QSC_CSX_STATISTICS)
+	qsc_csx_stats_reset();
+#endif
+
 	while (tctr < SAMPLE_COUNT)
 	{
 		qsc_csx_transform(&ctx, enc, msg, sizeof(msg));
 		++tctr;
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("CSX-512 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("CSX-512", 1, &tmr, (uint64_t)tctr * sizeof(msg), tctr);
+
+#if defined(QSC_CSX_STATISTICS)
+	csx_stats_print();
+#endif
+}
+
+
+typedef enum
+{
+	csx_sweep_seal = 0,		/* encryption and mac generation */
+	csx_sweep_open = 1,		/* mac verification and decryption */
+	csx_sweep_reject = 2,	/* decryption of a message with an invalid mac */
+} csx_sweep_mode;
+
+static int benchmark_sample_compare(const void* a, const void* b)
+{
+	const uint64_t x = *(const uint64_t*)a;
+	const uint64_t y = *(const uint64_t*)b;
+
+	return (x > y) - (x < y);
+}
+
+static uint64_t csx_sweep_sample(csx_sweep_mode mode, const qsc_csx_keyparams* kp, uint8_t* output, const uint8_t* input, size_t length)
+{
+	qsc_csx_state ctx;
+	uint64_t cycles;
+
+	/* initialization is not timed, every sample starts from the same key and nonce */
+	qsc_csx_initialize(&ctx, kp, (mode == csx_sweep_seal));
+	cycles = qsc_timerex_cycles_start();
+	qsc_csx_transform(&ctx, output, input, length);
+	cycles = qsc_timerex_cycles_stop() - cycles;
+	qsc_csx_dispose(&ctx);
+
+	return cycles;
+}
+
+static void csx_sweep_size(const qsc_csx_keyparams* kp, uint8_t* msg, uint8_t* enc, uint8_t* dec, uint64_t* samples, size_t length)
+{
+	const char* MODES[3] = { "seal  ", "open  ", "reject" };
+	const char* NAMES[3] = { "CSX-512 seal", "CSX-512 open", "CSX-512 reject" };
+	const double FRQ = (double)qsc_timerex_cycles_frequency();
+	const uint8_t* inp;
+	size_t count;
+	size_t i;
+	size_t p99;
+
+	count = qsc_intutils_min(qsc_intutils_max(SWEEP_BYTE_BUDGET / length, SWEEP_SAMPLES_MIN), SWEEP_SAMPLES_MAX);
+	p99 = ((count * 99) + 99) / 100 - 1;
+
+	/* the reference cipher-text for the open tests */
+	csx_sweep_sample(csx_sweep_seal, kp, enc, msg, length);
+
+	for (size_t m = csx_sweep_seal; m <= csx_sweep_reject; ++m)
+	{
+		inp = (m == csx_sweep_seal) ? msg : enc;
+
+		if (m == csx_sweep_reject)
+		{
+			/* corrupt the mac so the verification fails */
+			enc[length] ^= 0x01U;
+		}
+
+		for (i = 0; i < (count / SWEEP_WARMUP_DIVISOR) + 1; ++i)
+		{
+			csx_sweep_sample((csx_sweep_mode)m, kp, dec, inp, length);
+		}
+
+		for (i = 0; i < count; ++i)
+		{
+			samples[i] = csx_sweep_sample((csx_sweep_mode)m, kp, dec, inp, length);
+		}
+
+		qsort(samples, count, sizeof(uint64_t), benchmark_sample_compare);
+
+		qsctest_print_safe("CSX-512 ");
+		qsctest_print_safe(MODES[m]);
+		qsctest_print_safe(" ");
+		qsctest_print_ulong(length);
+		qsctest_print_safe(" bytes: median ");
+		qsctest_print_double((double)samples[count / 2] / (double)length);
+		qsctest_print_safe(" cycles/byte, p99 ");
+		qsctest_print_double((double)samples[p99] / (double)length);
+		qsctest_print_safe(" cycles/byte, ");
+		qsctest_print_ulong((uint64_t)(FRQ / (double)samples[count / 2]));
+		qsctest_print_line(" messages/s");
+
+		benchmark_record(NAMES[m], length, 1, (double)samples[count / 2] / (double)length,
+			((double)samples[count / 2] * 1000000000.0) / FRQ);
+	}
+
+	enc[length] ^= 0x01U;
+}
+
+#if defined(QSC_CSX_AUTHENTICATED)
+static void csx_tile_benchmark()
+{
+	qsc_cpuidex_cpu_features cfeat;
+	uint64_t nsec;
+	size_t tile;
+
+	if (qsc_cpuidex_features_set(&cfeat) == true)
+	{
+		qsctest_print_safe("L1 data cache ");
+		qsctest_print_ulong(cfeat.l1cache);
+		qsctest_print_safe("KB, L2 cache ");
+		qsctest_print_ulong(cfeat.l2cache);
+		qsctest_print_line("KB");
+	}
+
+	qsc_csx_tile_set(0);
+	qsctest_print_safe("Default transform tile size: ");
+	qsctest_print_ulong(qsc_csx_tile_size());
+	qsctest_print_line(" bytes");
+
+	nsec = qsc_timerex_monotonic_ns();
+	tile = qsc_csx_tile_autotune();
+	nsec = qsc_timerex_stopwatch_elapsed_ns(nsec);
+
+	qsctest_print_safe("Auto-tuned transform tile size: ");
+	qsctest_print_ulong(tile);
+	qsctest_print_safe(" bytes, selected in ");
+	qsctest_print_ulong(nsec / 1000000);
+	qsctest_print_line(" ms");
+}
+#endif
+
+static void csx_setup_print(const char* name, uint64_t* samples)
+{
+	const double FRQ = (double)qsc_timerex_cycles_frequency();
+	uint64_t med;
+
+	qsort(samples, SETUP_SAMPLE_COUNT, sizeof(uint64_t), benchmark_sample_compare);
+	med = samples[SETUP_SAMPLE_COUNT / 2];
+
+	qsctest_print_safe(name);
+	qsctest_print_safe(": median ");
+	qsctest_print_ulong(med);
+	qsctest_print_safe(" cycles, p99 ");
+	qsctest_print_ulong(samples[(SETUP_SAMPLE_COUNT * 99) / 100]);
+	qsctest_print_safe(" cycles, ");
+	qsctest_print_double(((double)med * 1000000000.0) / FRQ);
+	qsctest_print_line(" ns");
+
+	/* a latency record has no byte count; its cycles field holds the median cycles per call, so the baseline compare can gate it */
+	benchmark_record(name, 0, 1, (double)med, ((double)med * 1000000000.0) / FRQ);
+}
+
+static void csx_setup_benchmark()
+{
+	uint8_t key[QSC_CSX_KEY_SIZE] = { 0 };
+	uint8_t nonce[QSC_CSX_NONCE_SIZE] = { 0 };
+	qsc_csx_state ctx;
+	uint64_t* dsamples;
+	uint64_t* isamples;
+	uint64_t cycles;
+
+	isamples = (uint64_t*)qsc_memutils_malloc(SETUP_SAMPLE_COUNT * sizeof(uint64_t));
+	dsamples = (uint64_t*)qsc_memutils_malloc(SETUP_SAMPLE_COUNT * sizeof(uint64_t));
+
+	if (isamples != NULL && dsamples != NULL)
+	{
+		qsc_csp_generate(key, sizeof(key));
+		qsc_csp_generate(nonce, sizeof(nonce));
+		qsc_csx_keyparams kp = { key, sizeof(key), nonce, NULL, 0 };
+
+		for (size_t i = 0; i < SETUP_SAMPLE_COUNT; ++i)
+		{
+			cycles = qsc_timerex_cycles_start();
+			qsc_csx_initialize(&ctx, &kp, true);
+			isamples[i] = qsc_timerex_cycles_stop() - cycles;
+
+			cycles = qsc_timerex_cycles_start();
+			qsc_csx_dispose(&ctx);
+			dsamples[i] = qsc_timerex_cycles_stop() - cycles;
+		}
+
+		csx_setup_print("CSX-512 initialize", isamples);
+		csx_setup_print("CSX-512 dispose", dsamples);
+	}
+
+	if (isamples != NULL && dsamples != NULL)
+	{
+		qsc_memutils_arena arena;
+		qsc_csx_state* pctx;
+
+		/* the per-connection state allocation, from the heap and from the locked arena */
+		for (size_t i = 0; i < SETUP_SAMPLE_COUNT; ++i)
+		{
+			cycles = qsc_timerex_cycles_start();
+			pctx = (qsc_csx_state*)qsc_memutils_malloc(sizeof(qsc_csx_state));
+			qsc_memutils_clear(pctx, sizeof(qsc_csx_state));
+			qsc_memutils_alloc_free(pctx);
+			isamples[i] = qsc_timerex_cycles_stop() - cycles;
+		}
+
+		csx_setup_print("CSX-512 state heap allocate and free", isamples);
+
+		if (qsc_memutils_arena_create(&arena, sizeof(qsc_csx_state), SETUP_ARENA_CAPACITY) == true)
+		{
+			for (size_t i = 0; i < SETUP_SAMPLE_COUNT; ++i)
+			{
+				cycles = qsc_timerex_cycles_start();
+				pctx = (qsc_csx_state*)qsc_memutils_arena_alloc(&arena);
+				qsc_memutils_arena_free(&arena, pctx);
+				dsamples[i] = qsc_timerex_cycles_stop() - cycles;
+			}
+
+			csx_setup_print("CSX-512 state arena allocate and free", dsamples);
+			qsc_memutils_arena_destroy(&arena);
+		}
+	}
+
+	if (isamples != NULL)
+	{
+		qsc_memutils_alloc_free(isamples);
+	}
+
+	if (dsamples != NULL)
+	{
+		qsc_memutils_alloc_free(dsamples);
+	}
+}
+
+static void csx_stream_victim_create(uint8_t* victim)
+{
+	const size_t LINES = STREAM_VICTIM_SIZE / QSC_MEMUTILS_CACHE_LINE_SIZE;
+	uint32_t* order;
+	uint32_t tmp;
+	uint64_t rnd;
+	size_t j;
+
+	order = (uint32_t*)qsc_memutils_malloc(LINES * sizeof(uint32_t));
+
+	if (order != NULL)
+	{
+		/* link the cache lines into one cycle in a random order, defeating the hardware prefetchers */
+		rnd = 0x9E3779B97F4A7C15ULL;
+
+		for (size_t i = 0; i < LINES; ++i)
+		{
+			order[i] = (uint32_t)i;
+		}
+
+		for (size_t i = LINES - 1; i > 0; --i)
+		{
+			rnd = (rnd * 6364136223846793005ULL) + 1442695040888963407ULL;
+			j = (size_t)((rnd >> 33) % (i + 1));
+			tmp = order[i];
+			order[i] = order[j];
+			order[j] = tmp;
+		}
+
+		for (size_t i = 0; i < LINES; ++i)
+		{
+			((uint32_t*)(victim + ((size_t)order[i] * QSC_MEMUTILS_CACHE_LINE_SIZE)))[0] = order[(i + 1) % LINES];
+		}
+
+		qsc_memutils_alloc_free(order);
+	}
+}
+
+static uint64_t csx_stream_victim(const uint8_t* victim, uint64_t* sum)
+{
+	const size_t LINES = STREAM_VICTIM_SIZE / QSC_MEMUTILS_CACHE_LINE_SIZE;
+	uint64_t cycles;
+	uint32_t idx;
+
+	idx = 0;
+	cycles = qsc_timerex_cycles_start();
+
+	/* a dependent load per cache line, the access pattern of a cache-sensitive hash table or index */
+	for (size_t i = 0; i < LINES; ++i)
+	{
+		idx = ((const uint32_t*)(victim + ((size_t)idx * QSC_MEMUTILS_CACHE_LINE_SIZE)))[0];
+	}
+
+	cycles = qsc_timerex_cycles_stop() - cycles;
+	*sum += idx;
+
+	return cycles;
+}
+
+static void csx_stream_benchmark()
+{
+	const char* MODES[2] = { "cached stores", "streaming stores" };
+	const char* NAMES[2] = { "CSX-512 open cached", "CSX-512 open streamed" };
+	const char* VNAMES[2] = { "Working set after cached open", "Working set after streamed open" };
+	const double FRQ = (double)qsc_timerex_cycles_frequency();
+	const double LINES = (double)(STREAM_VICTIM_SIZE / QSC_MEMUTILS_CACHE_LINE_SIZE);
+	uint8_t key[QSC_CSX_KEY_SIZE] = { 0 };
+	uint8_t nonce[QSC_CSX_NONCE_SIZE] = { 0 };
+	uint64_t dsamples[STREAM_SAMPLE_COUNT];
+	uint64_t vsamples[STREAM_SAMPLE_COUNT];
+	qsc_csx_state ctx;
+	uint8_t* dec;
+	uint8_t* enc;
+	uint8_t* victim;
+	uint64_t cycles;
+	uint64_t sum;
+
+	dec = (uint8_t*)qsc_memutils_aligned_alloc(64, STREAM_MESSAGE_SIZE);
+	enc = (uint8_t*)qsc_memutils_aligned_alloc(64, STREAM_MESSAGE_SIZE + QSC_CSX_MAC_SIZE);
+	victim = (uint8_t*)qsc_memutils_aligned_alloc(64, STREAM_VICTIM_SIZE);
+	sum = 0;
+
+	if (dec != NULL && enc != NULL && victim != NULL)
+	{
+		qsc_csp_generate(key, sizeof(key));
+		qsc_csp_generate(nonce, sizeof(nonce));
+		qsc_memutils_clear(victim, STREAM_VICTIM_SIZE);
+		csx_stream_victim_create(victim);
+		qsc_memutils_clear(dec, STREAM_MESSAGE_SIZE);
+		qsc_csx_keyparams kp = { key, sizeof(key), nonce, NULL, 0 };
+
+		qsc_csx_initialize(&ctx, &kp, true);
+		qsc_csx_transform(&ctx, enc, dec, STREAM_MESSAGE_SIZE);
+		qsc_csx_dispose(&ctx);
+
+		for (size_t m = 0; m < 2; ++m)
+		{
+			/* SIZE_MAX disables streaming, zero restores the default threshold */
+			qsc_memutils_stream_threshold_set((m == 0) ? SIZE_MAX : 0);
+
+			for (size_t i = 0; i < STREAM_SAMPLE_COUNT; ++i)
+			{
+				csx_stream_victim(victim, &sum);
+
+				cycles = qsc_timerex_cycles_start();
+				qsc_csx_initialize(&ctx, &kp, false);
+				qsc_csx_transform(&ctx, dec, enc, STREAM_MESSAGE_SIZE);
+				qsc_csx_dispose(&ctx);
+				dsamples[i] = qsc_timerex_cycles_stop() - cycles;
+
+				/* the cost of the working set lines the decryption evicted */
+				vsamples[i] = csx_stream_victim(victim, &sum);
+			}
+
+			qsort(dsamples, STREAM_SAMPLE_COUNT, sizeof(uint64_t), benchmark_sample_compare);
+			qsort(vsamples, STREAM_SAMPLE_COUNT, sizeof(uint64_t), benchmark_sample_compare);
+
+			qsctest_print_safe("CSX-512 decrypt 16MB with ");
+			qsctest_print_safe(MODES[m]);
+			qsctest_print_safe(": ");
+			qsctest_print_double((double)dsamples[STREAM_SAMPLE_COUNT / 2] / (double)STREAM_MESSAGE_SIZE);
+			qsctest_print_safe(" cycles/byte, 4MB working set re-read: ");
+			qsctest_print_double((double)vsamples[STREAM_SAMPLE_COUNT / 2] / LINES);
+			qsctest_print_line(" cycles/line");
+
+			benchmark_record(NAMES[m], STREAM_MESSAGE_SIZE, 1, (double)dsamples[STREAM_SAMPLE_COUNT / 2] / (double)STREAM_MESSAGE_SIZE,
+				((double)dsamples[STREAM_SAMPLE_COUNT / 2] * 1000000000.0) / FRQ);
+			benchmark_record(VNAMES[m], STREAM_VICTIM_SIZE, 1, (double)vsamples[STREAM_SAMPLE_COUNT / 2] / (double)STREAM_VICTIM_SIZE,
+				((double)vsamples[STREAM_SAMPLE_COUNT / 2] * 1000000000.0) / FRQ);
+		}
+
+		qsc_memutils_stream_threshold_set(0);
+
+		/* the chase result is consumed, so the walk cannot be elided */
+		if (sum == UINT64_MAX)
+		{
+			qsctest_print_line("");
+		}
+	}
+
+	if (dec != NULL)
+	{
+		qsc_memutils_aligned_free(dec);
+	}
+
+	if (enc != NULL)
+	{
+		qsc_memutils_aligned_free(enc);
+	}
+
+	if (victim != NULL)
+	{
+		qsc_memutils_aligned_free(victim);
+	}
+}
+
+#if defined(QSC_SYSTEM_OS_POSIX)
+static bool csp_urandom_generate(uint8_t* output, size_t length)
+{
+	int fd;
+	bool res;
+
+	/* the earlier system provider path, a descriptor opened and closed on every request */
+	res = false;
+	fd = open("/dev/urandom", O_RDONLY);
+
+	if (fd >= 0)
+	{
+		res = (read(fd, output, length) == (ssize_t)length);
+		close(fd);
+	}
+
+	return res;
+}
+#endif
+
+static void csp_nonce_benchmark()
+{
+	uint8_t nonce[QSC_CSX_NONCE_SIZE] = { 0 };
+	uint64_t* samples;
+	uint64_t cycles;
+
+	samples = (uint64_t*)qsc_memutils_malloc(SETUP_SAMPLE_COUNT * sizeof(uint64_t));
+
+	if (samples != NULL)
+	{
+#if defined(QSC_SYSTEM_OS_POSIX)
+		for (size_t i = 0; i < SETUP_SAMPLE_COUNT; ++i)
+		{
+			cycles = qsc_timerex_cycles_start();
+			csp_urandom_generate(nonce, sizeof(nonce));
+			samples[i] = qsc_timerex_cycles_stop() - cycles;
+		}
+
+		csx_setup_print("CSX-512 nonce from /dev/urandom open, read, close", samples);
+#endif
+
+		for (size_t i = 0; i < SETUP_SAMPLE_COUNT; ++i)
+		{
+			cycles = qsc_timerex_cycles_start();
+			qsc_csp_generate(nonce, sizeof(nonce));
+			samples[i] = qsc_timerex_cycles_stop() - cycles;
+		}
+
+		csx_setup_print("CSX-512 nonce from qsc_csp_generate", samples);
+
+		for (size_t i = 0; i < SETUP_SAMPLE_COUNT; ++i)
+		{
+			cycles = qsc_timerex_cycles_start();
+			qsc_csp_buffered_generate(nonce, sizeof(nonce));
+			samples[i] = qsc_timerex_cycles_stop() - cycles;
+		}
+
+		csx_setup_print("CSX-512 nonce from qsc_csp_buffered_generate", samples);
+		qsc_csp_buffered_dispose();
+
+		if (qsc_csp_source_set(qsc_csp_source_hardware) == true)
+		{
+			for (size_t i = 0; i < SETUP_SAMPLE_COUNT; ++i)
+			{
+				cycles = qsc_timerex_cycles_start();
+				qsc_csp_buffered_generate(nonce, sizeof(nonce));
+				samples[i] = qsc_timerex_cycles_stop() - cycles;
+			}
+
+			csx_setup_print("CSX-512 nonce from qsc_csp_buffered_generate, hardware source", samples);
+			qsc_csp_source_set(qsc_csp_source_system);
+			qsc_csp_buffered_dispose();
+		}
+		else
+		{
+			qsctest_print_line("The hardware entropy source is not available on this system.");
+		}
+		qsc_memutils_alloc_free(samples);
+	}
+}
+
+static void csx_drbg_benchmark()
+{
+	uint8_t seed[QSC_CSX_DRBG_SEED_MIN] = { 0 };
+	uint8_t small[16] = { 0 };
+	qsc_csx_drbg_state ctx;
+	benchmark_timer tmr;
+	uint64_t* samples;
+	uint64_t cycles;
+	uint8_t* output;
+
+	output = (uint8_t*)qsc_memutils_malloc(DRBG_REQUEST_SIZE);
+	samples = (uint64_t*)qsc_memutils_malloc(SETUP_SAMPLE_COUNT * sizeof(uint64_t));
+
+	if (output != NULL && samples != NULL)
+	{
+		qsc_csp_generate(seed, sizeof(seed));
+		qsc_csx_drbg_instantiate(&ctx, seed, sizeof(seed), NULL, 0);
+		/* fault in the output pages before the timed region */
+		qsc_csx_drbg_generate(&ctx, output, DRBG_REQUEST_SIZE);
+
+		benchmark_start(&tmr);
+
+		for (size_t i = 0; i < DRBG_REQUEST_COUNT; ++i)
+		{
+			qsc_csx_drbg_generate(&ctx, output, DRBG_REQUEST_SIZE);
+		}
+
+		benchmark_stop(&tmr);
+		benchmark_print("CSX-512 DRBG 1MB requests", 1, &tmr, (uint64_t)DRBG_REQUEST_COUNT * DRBG_REQUEST_SIZE, DRBG_REQUEST_COUNT);
+
+		for (size_t i = 0; i < SETUP_SAMPLE_COUNT; ++i)
+		{
+			cycles = qsc_timerex_cycles_start();
+			qsc_csx_drbg_generate(&ctx, small, sizeof(small));
+			samples[i] = qsc_timerex_cycles_stop() - cycles;
+		}
+
+		csx_setup_print("CSX-512 DRBG 16 byte request", samples);
+		qsc_csx_drbg_dispose(&ctx);
+	}
+
+	if (output != NULL)
+	{
+		qsc_memutils_alloc_free(output);
+	}
+
+	if (samples != NULL)
+	{
+		qsc_memutils_alloc_free(samples);
+	}
 }
 
+static void csx_sweep_benchmark()
+{
+	/* the typical ethernet mtu and jumbo frame payload sizes */
+	const size_t ODDSIZES[2] = { 1500, 9000 };
+	uint8_t key[QSC_CSX_KEY_SIZE] = { 0 };
+	uint8_t nonce[QSC_CSX_NONCE_SIZE] = { 0 };
+	uint64_t* samples;
+	uint8_t* dec;
+	uint8_t* enc;
+	uint8_t* msg;
+
+	msg = (uint8_t*)qsc_memutils_malloc(SWEEP_SIZE_MAX);
+	enc = (uint8_t*)qsc_memutils_malloc(SWEEP_SIZE_MAX + QSC_CSX_MAC_SIZE);
+	dec = (uint8_t*)qsc_memutils_malloc(SWEEP_SIZE_MAX + QSC_CSX_MAC_SIZE);
+	samples = (uint64_t*)qsc_memutils_malloc(SWEEP_SAMPLES_MAX * sizeof(uint64_t));
+
+	if (msg != NULL && enc != NULL && dec != NULL && samples != NULL)
+	{
+		qsc_csp_generate(key, sizeof(key));
+		qsc_csp_generate(nonce, sizeof(nonce));
+		qsc_csx_keyparams kp = { key, sizeof(key), nonce, NULL, 0 };
+
+		for (size_t i = 0; i < SWEEP_SIZE_MAX; ++i)
+		{
+			msg[i] = (uint8_t)i;
+		}
+
+		for (size_t len = SWEEP_SIZE_MIN; len <= SWEEP_SIZE_MAX; len *= 2)
+		{
+			csx_sweep_size(&kp, msg, enc, dec, samples, len);
+		}
+
+		for (size_t i = 0; i < sizeof(ODDSIZES) / sizeof(size_t); ++i)
+		{
+			csx_sweep_size(&kp, msg, enc, dec, samples, ODDSIZES[i]);
+		}
+	}
+
+	if (msg != NULL)
+	{
+		qsc_memutils_alloc_free(msg);
+	}
+
+	if (enc != NULL)
+	{
+		qsc_memutils_alloc_free(enc);
+	}
+
+	if (dec != NULL)
+	{
+		qsc_memutils_alloc_free(dec);
+	}
+
+	if (samples != NULL)
+	{
+		qsc_memutils_alloc_free(samples);
+	}
+}
 
 static void kmac128_benchmark()
 {
@@ -54,11 +901,10 @@ static void kmac128_benchmark()
 	uint8_t key[16] = { 0 };
 	qsc_keccak_state ctx;
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	qsc_kmac_initialize(&ctx, QSC_KECCAK_128_RATE, key, sizeof(key), NULL, 0);
 
@@ -69,10 +915,8 @@ static void kmac128_benchmark()
 		++tctr;
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("KMAC-128 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("KMAC-128", 1, &tmr, (uint64_t)tctr * sizeof(msg), tctr);
 }
 
 static void kmac256_benchmark()
@@ -82,11 +926,10 @@ static void kmac256_benchmark()
 	uint8_t key[32] = { 0 };
 	qsc_keccak_state ctx;
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	qsc_kmac_initialize(&ctx, QSC_KECCAK_256_RATE, key, sizeof(key), NULL, 0);
 
@@ -97,10 +940,8 @@ static void kmac256_benchmark()
 		++tctr;
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("KMAC-256 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("KMAC-256", 1, &tmr, (uint64_t)tctr * sizeof(msg), tctr);
 }
 
 static void kmac512_benchmark()
@@ -110,11 +951,10 @@ static void kmac512_benchmark()
 	uint8_t key[64] = { 0 };
 	qsc_keccak_state ctx;
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	qsc_kmac_initialize(&ctx, QSC_KECCAK_512_RATE, key, sizeof(key), NULL, 0);
 
@@ -125,10 +965,8 @@ static void kmac512_benchmark()
 		++tctr;
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("KMAC-512 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("KMAC-512", 1, &tmr, (uint64_t)tctr * sizeof(msg), tctr);
 }
 
 #if defined(QSC_SYSTEM_HAS_AVX2)
@@ -138,11 +976,10 @@ static void kmac128x4_benchmark()
 	uint8_t tag[4][16] = { 0 };
 	uint8_t key[4][16] = { 0 };
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	while (tctr < ONE_GIGABYTE)
 	{
@@ -151,10 +988,8 @@ static void kmac128x4_benchmark()
 		tctr += (4 * BUFFER_SIZE);
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("KMAC-128x4 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("KMAC-128x4", 1, &tmr, tctr, tctr / (4 * BUFFER_SIZE));
 }
 
 static void kmac256x4_benchmark()
@@ -163,11 +998,10 @@ static void kmac256x4_benchmark()
 	uint8_t tag[4][32] = { 0 };
 	uint8_t key[4][32] = { 0 };
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	while (tctr < ONE_GIGABYTE)
 	{
@@ -176,10 +1010,8 @@ static void kmac256x4_benchmark()
 		tctr += (4 * BUFFER_SIZE);
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("KMAC-256x4 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("KMAC-256x4", 1, &tmr, tctr, tctr / (4 * BUFFER_SIZE));
 }
 
 static void kmac512x4_benchmark()
@@ -188,11 +1020,10 @@ static void kmac512x4_benchmark()
 	uint8_t tag[4][64] = { 0 };
 	uint8_t key[4][64] = { 0 };
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	while (tctr < ONE_GIGABYTE)
 	{
@@ -201,10 +1032,8 @@ static void kmac512x4_benchmark()
 		tctr += (4 * BUFFER_SIZE);
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("KMAC-512x4 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("KMAC-512x4", 1, &tmr, tctr, tctr / (4 * BUFFER_SIZE));
 }
 #endif
 
@@ -215,11 +1044,10 @@ static void kmac128x8_benchmark()
 	uint8_t tag[8][16] = { 0 };
 	uint8_t key[8][16] = { 0 };
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	while (tctr < ONE_GIGABYTE)
 	{
@@ -230,10 +1058,8 @@ static void kmac128x8_benchmark()
 		tctr += (8 * BUFFER_SIZE);
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("KMAC-128x8 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("KMAC-128x8", 1, &tmr, tctr, tctr / (8 * BUFFER_SIZE));
 }
 
 static void kmac256x8_benchmark()
@@ -242,11 +1068,10 @@ static void kmac256x8_benchmark()
 	uint8_t tag[8][32] = { 0 };
 	uint8_t key[8][32] = { 0 };
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	while (tctr < ONE_GIGABYTE)
 	{
@@ -257,10 +1082,8 @@ static void kmac256x8_benchmark()
 		tctr += (8 * BUFFER_SIZE);
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("KMAC-256x8 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("KMAC-256x8", 1, &tmr, tctr, tctr / (8 * BUFFER_SIZE));
 }
 
 static void kmac512x8_benchmark()
@@ -269,11 +1092,10 @@ static void kmac512x8_benchmark()
 	uint8_t tag[8][64] = { 0 };
 	uint8_t key[8][64] = { 0 };
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	while (tctr < ONE_GIGABYTE)
 	{
@@ -284,10 +1106,8 @@ static void kmac512x8_benchmark()
 		tctr += (8 * BUFFER_SIZE);
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("KMAC-512x8 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("KMAC-512x8", 1, &tmr, tctr, tctr / (8 * BUFFER_SIZE));
 }
 #endif
 
@@ -298,11 +1118,10 @@ static void kpa128_benchmark()
 	uint8_t key[16] = { 0 };
 	qsc_kpa_state ctx;
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	qsc_kpa_initialize(&ctx, key, sizeof(key), NULL, 0);
 
@@ -313,10 +1132,8 @@ static void kpa128_benchmark()
 		++tctr;
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("KPA-128 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("KPA-128", 1, &tmr, (uint64_t)tctr * sizeof(msg), tctr);
 }
 
 static void kpa256_benchmark()
@@ -326,11 +1143,10 @@ static void kpa256_benchmark()
 	uint8_t key[32] = { 0 };
 	qsc_kpa_state ctx;
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	qsc_kpa_initialize(&ctx, key, sizeof(key), NULL, 0);
 
@@ -341,10 +1157,8 @@ static void kpa256_benchmark()
 		++tctr;
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("KPA-256 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("KPA-256", 1, &tmr, (uint64_t)tctr * sizeof(msg), tctr);
 }
 
 static void kpa512_benchmark()
@@ -354,11 +1168,10 @@ static void kpa512_benchmark()
 	uint8_t key[64] = { 0 };
 	qsc_kpa_state ctx;
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	qsc_kpa_initialize(&ctx, key, sizeof(key), NULL, 0);
 
@@ -369,10 +1182,78 @@ static void kpa512_benchmark()
 		++tctr;
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("KPA-512 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("KPA-512", 1, &tmr, (uint64_t)tctr * sizeof(msg), tctr);
+}
+
+static void state_size_print(const char* name, size_t size)
+{
+	qsctest_print_safe(name);
+	qsctest_print_safe(" per-instance size: ");
+	qsctest_print_ulong(size);
+	qsctest_print_line(" bytes");
+}
+
+static void kpa_state_sizes()
+{
+	state_size_print("qsc_keccak_state", sizeof(qsc_keccak_state));
+	state_size_print("qsc_kpa_state", sizeof(qsc_kpa_state));
+	state_size_print("qsc_kpa16_state", sizeof(qsc_kpa16_state));
+	state_size_print("qsc_csx_state", sizeof(qsc_csx_state));
+}
+
+static void kpa16_256_benchmark()
+{
+	uint8_t msg[BUFFER_SIZE] = { 0 };
+	uint8_t tag[32] = { 0 };
+	uint8_t key[32] = { 0 };
+	qsc_kpa16_state ctx;
+	size_t tctr;
+	benchmark_timer tmr;
+
+	tctr = 0;
+	benchmark_start(&tmr);
+
+	qsc_kpa16_initialize(&ctx, key, sizeof(key), NULL, 0);
+
+	while (tctr < SAMPLE_COUNT)
+	{
+		qsc_kpa16_update(&ctx, msg, sizeof(msg));
+		++tctr;
+	}
+
+	qsc_kpa16_finalize(&ctx, tag, sizeof(tag));
+	benchmark_stop(&tmr);
+	benchmark_print("KPA-16-256", 1, &tmr, (uint64_t)tctr * sizeof(msg), tctr);
+}
+
+static void kpa256_tree_benchmark(size_t threads)
+{
+	uint8_t tag[32] = { 0 };
+	uint8_t key[32] = { 0 };
+	uint8_t* msg;
+	size_t tctr;
+	benchmark_timer tmr;
+
+	msg = (uint8_t*)qsc_memutils_malloc(TREE_BUFFER_SIZE);
+
+	if (msg != NULL)
+	{
+		qsc_memutils_clear(msg, TREE_BUFFER_SIZE);
+		tctr = 0;
+		benchmark_start(&tmr);
+
+		while (tctr < TREE_SAMPLE_COUNT)
+		{
+			qsc_kpa_tree_compute(tag, sizeof(tag), msg, TREE_BUFFER_SIZE, key, sizeof(key), NULL, 0, threads);
+			++tctr;
+		}
+
+		benchmark_stop(&tmr);
+		benchmark_print("KPA-256 tree", threads, &tmr, (uint64_t)tctr * TREE_BUFFER_SIZE, tctr);
+
+		qsc_memutils_alloc_free(msg);
+	}
 }
 
 static void shake128_benchmark()
@@ -381,11 +1262,10 @@ static void shake128_benchmark()
 	uint8_t otp[QSC_KECCAK_128_RATE] = { 0 };
 	qsc_keccak_state ctx;
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	while (tctr < ONE_GIGABYTE)
 	{
@@ -394,10 +1274,8 @@ static void shake128_benchmark()
 		tctr += sizeof(otp);
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("SHAKE-128 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("SHAKE-128", 1, &tmr, tctr, tctr / sizeof(otp));
 }
 
 static void shake256_benchmark()
@@ -406,11 +1284,10 @@ static void shake256_benchmark()
 	uint8_t otp[QSC_KECCAK_256_RATE] = { 0 };
 	qsc_keccak_state ctx;
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	while (tctr < ONE_GIGABYTE)
 	{
@@ -419,10 +1296,8 @@ static void shake256_benchmark()
 		tctr += sizeof(otp);
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("SHAKE-256 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("SHAKE-256", 1, &tmr, tctr, tctr / sizeof(otp));
 }
 
 static void shake512_benchmark()
@@ -431,11 +1306,10 @@ static void shake512_benchmark()
 	uint8_t otp[QSC_KECCAK_512_RATE] = { 0 };
 	qsc_keccak_state ctx;
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	while (tctr < ONE_GIGABYTE)
 	{
@@ -444,10 +1318,8 @@ static void shake512_benchmark()
 		tctr += sizeof(otp);
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("SHAKE-512 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("SHAKE-512", 1, &tmr, tctr, tctr / sizeof(otp));
 }
 
 #if defined(QSC_SYSTEM_HAS_AVX2)
@@ -456,11 +1328,10 @@ static void shake128x4_benchmark()
 	uint8_t key[4][16] = { 0 };
 	uint8_t otp[4][QSC_KECCAK_128_RATE] = { 0 };
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	while (tctr < ONE_GIGABYTE)
 	{
@@ -468,10 +1339,8 @@ static void shake128x4_benchmark()
 		tctr += (4 * QSC_KECCAK_128_RATE);
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("SHAKE-128x4 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("SHAKE-128x4", 1, &tmr, tctr, tctr / (4 * QSC_KECCAK_128_RATE));
 }
 
 static void shake256x4_benchmark()
@@ -479,11 +1348,10 @@ static void shake256x4_benchmark()
 	uint8_t key[4][32] = { 0 };
 	uint8_t otp[4][QSC_KECCAK_256_RATE] = { 0 };
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	while (tctr < ONE_GIGABYTE)
 	{
@@ -491,10 +1359,8 @@ static void shake256x4_benchmark()
 		tctr += (4 * QSC_KECCAK_256_RATE);
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("SHAKE-256x4 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("SHAKE-256x4", 1, &tmr, tctr, tctr / (4 * QSC_KECCAK_256_RATE));
 }
 
 static void shake512x4_benchmark()
@@ -502,11 +1368,10 @@ static void shake512x4_benchmark()
 	uint8_t key[4][64] = { 0 };
 	uint8_t otp[4][QSC_KECCAK_512_RATE] = { 0 };
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	while (tctr < ONE_GIGABYTE)
 	{
@@ -514,10 +1379,8 @@ static void shake512x4_benchmark()
 		tctr += (4 * QSC_KECCAK_512_RATE);
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("SHAKE-512x4 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("SHAKE-512x4", 1, &tmr, tctr, tctr / (4 * QSC_KECCAK_512_RATE));
 }
 #endif
 
@@ -527,11 +1390,10 @@ static void shake128x8_benchmark()
 	uint8_t key[8][16] = { 0 };
 	uint8_t otp[8][QSC_KECCAK_128_RATE] = { 0 };
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	while (tctr < ONE_GIGABYTE)
 	{
@@ -540,10 +1402,8 @@ static void shake128x8_benchmark()
 		tctr += (8 * QSC_KECCAK_128_RATE);
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("SHAKE-128x8 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("SHAKE-128x8", 1, &tmr, tctr, tctr / (8 * QSC_KECCAK_128_RATE));
 }
 
 static void shake256x8_benchmark()
@@ -551,11 +1411,10 @@ static void shake256x8_benchmark()
 	uint8_t key[8][32] = { 0 };
 	uint8_t otp[8][QSC_KECCAK_256_RATE] = { 0 };
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	while (tctr < ONE_GIGABYTE)
 	{
@@ -564,10 +1423,8 @@ static void shake256x8_benchmark()
 		tctr += (8 * QSC_KECCAK_256_RATE);
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("SHAKE-256x8 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("SHAKE-256x8", 1, &tmr, tctr, tctr / (8 * QSC_KECCAK_256_RATE));
 }
 
 static void shake512x8_benchmark()
@@ -575,11 +1432,10 @@ static void shake512x8_benchmark()
 	uint8_t key[8][64] = { 0 };
 	uint8_t otp[8][QSC_KECCAK_512_RATE] = { 0 };
 	size_t tctr;
-	clock_t start;
-	uint64_t elapsed;
+	benchmark_timer tmr;
 
 	tctr = 0;
-	start = qsc_timerex_stopwatch_start();
+	benchmark_start(&tmr);
 
 	while (tctr < ONE_GIGABYTE)
 	{
@@ -588,22 +1444,976 @@ static void shake512x8_benchmark()
 		tctr += (8 * QSC_KECCAK_512_RATE);
 	}
 
-	elapsed = qsc_timerex_stopwatch_elapsed(start);
-	qsctest_print_safe("SHAKE-512x8 processed 1GB of data in ");
-	qsctest_print_double((double)elapsed / 1000.0);
-	qsctest_print_line(" seconds");
+	benchmark_stop(&tmr);
+	benchmark_print("SHAKE-512x8", 1, &tmr, tctr, tctr / (8 * QSC_KECCAK_512_RATE));
 }
 #endif
 
-void qsctest_benchmark_csx_run()
+static void turboshake128_benchmark()
 {
-	qsctest_print_line("Running the CSX-512 performance benchmarks.");
-	csx_benchmark_test();
+	uint8_t hash[32] = { 0 };
+	uint8_t* msg;
+	size_t tctr;
+	benchmark_timer tmr;
+
+	msg = (uint8_t*)qsc_memutils_malloc(KT_BUFFER_SIZE);
+
+	if (msg != NULL)
+	{
+		qsc_memutils_clear(msg, KT_BUFFER_SIZE);
+		tctr = 0;
+		benchmark_start(&tmr);
+
+		while (tctr < KT_SAMPLE_COUNT)
+		{
+			qsc_turboshake128_compute(hash, sizeof(hash), msg, KT_BUFFER_SIZE, QSC_TURBOSHAKE_DOMAIN_ID);
+			++tctr;
+		}
+
+		benchmark_stop(&tmr);
+		benchmark_print("TurboSHAKE-128", 1, &tmr, (uint64_t)tctr * KT_BUFFER_SIZE, tctr);
+		qsc_memutils_alloc_free(msg);
+	}
 }
 
-void qsctest_benchmark_kmac_run()
+static void kt128_benchmark()
 {
-	qsctest_print_line("Running the KMAC-128 performance benchmarks.");
+	uint8_t hash[32] = { 0 };
+	uint8_t* msg;
+	size_t tctr;
+	benchmark_timer tmr;
+
+	msg = (uint8_t*)qsc_memutils_malloc(KT_BUFFER_SIZE);
+
+	if (msg != NULL)
+	{
+		qsc_memutils_clear(msg, KT_BUFFER_SIZE);
+		tctr = 0;
+		benchmark_start(&tmr);
+
+		while (tctr < KT_SAMPLE_COUNT)
+		{
+			qsc_kt128_compute(hash, sizeof(hash), msg, KT_BUFFER_SIZE, NULL, 0);
+			++tctr;
+		}
+
+		benchmark_stop(&tmr);
+		benchmark_print("KT128", 1, &tmr, (uint64_t)tctr * KT_BUFFER_SIZE, tctr);
+		qsc_memutils_alloc_free(msg);
+	}
+}
+
+static void kt256_benchmark()
+{
+	uint8_t hash[64] = { 0 };
+	uint8_t* msg;
+	size_t tctr;
+	benchmark_timer tmr;
+
+	msg = (uint8_t*)qsc_memutils_malloc(KT_BUFFER_SIZE);
+
+	if (msg != NULL)
+	{
+		qsc_memutils_clear(msg, KT_BUFFER_SIZE);
+		tctr = 0;
+		benchmark_start(&tmr);
+
+		while (tctr < KT_SAMPLE_COUNT)
+		{
+			qsc_kt256_compute(hash, sizeof(hash), msg, KT_BUFFER_SIZE, NULL, 0);
+			++tctr;
+		}
+
+		benchmark_stop(&tmr);
+		benchmark_print("KT256", 1, &tmr, (uint64_t)tctr * KT_BUFFER_SIZE, tctr);
+		qsc_memutils_alloc_free(msg);
+	}
+}
+
+static void parallelhash128_benchmark()
+{
+	uint8_t hash[32] = { 0 };
+	uint8_t* msg;
+	size_t tctr;
+	benchmark_timer tmr;
+
+	msg = (uint8_t*)qsc_memutils_malloc(KT_BUFFER_SIZE);
+
+	if (msg != NULL)
+	{
+		qsc_memutils_clear(msg, KT_BUFFER_SIZE);
+		tctr = 0;
+		benchmark_start(&tmr);
+
+		while (tctr < KT_SAMPLE_COUNT)
+		{
+			qsc_parallelhash128_compute(hash, sizeof(hash), msg, KT_BUFFER_SIZE, NULL, 0, PARALLELHASH_BLOCK_SIZE);
+			++tctr;
+		}
+
+		benchmark_stop(&tmr);
+		benchmark_print("ParallelHash128", 1, &tmr, (uint64_t)tctr * KT_BUFFER_SIZE, tctr);
+		qsc_memutils_alloc_free(msg);
+	}
+}
+
+static void parallelhash256_benchmark()
+{
+	uint8_t hash[64] = { 0 };
+	uint8_t* msg;
+	size_t tctr;
+	benchmark_timer tmr;
+
+	msg = (uint8_t*)qsc_memutils_malloc(KT_BUFFER_SIZE);
+
+	if (msg != NULL)
+	{
+		qsc_memutils_clear(msg, KT_BUFFER_SIZE);
+		tctr = 0;
+		benchmark_start(&tmr);
+
+		while (tctr < KT_SAMPLE_COUNT)
+		{
+			qsc_parallelhash256_compute(hash, sizeof(hash), msg, KT_BUFFER_SIZE, NULL, 0, PARALLELHASH_BLOCK_SIZE);
+			++tctr;
+		}
+
+		benchmark_stop(&tmr);
+		benchmark_print("ParallelHash256", 1, &tmr, (uint64_t)tctr * KT_BUFFER_SIZE, tctr);
+		qsc_memutils_alloc_free(msg);
+	}
+}
+
+static void benchmark_scaling_thread(void* state)
+{
+	uint8_t key[QSC_CSX_KEY_SIZE] = { 0 };
+	uint8_t nonce[QSC_CSX_NONCE_SIZE] = { 0 };
+	uint8_t tag[32] = { 0 };
+	benchmark_scaling_args* args;
+	qsc_csx_state ctx;
+	uint8_t* dec;
+	uint8_t* enc;
+	uint8_t* msg;
+	size_t i;
+
+	args = (benchmark_scaling_args*)state;
+	args->pinned = qsc_async_thread_affinity(args->core);
+	args->bytes = 0;
+
+	/* the buffers are allocated by the pinned thread, so they are local to its core */
+	msg = (uint8_t*)qsc_memutils_malloc(SCALING_BUFFER_SIZE);
+	enc = (uint8_t*)qsc_memutils_malloc(SCALING_BUFFER_SIZE + QSC_CSX_MAC_SIZE);
+	dec = (uint8_t*)qsc_memutils_malloc(SCALING_BUFFER_SIZE + QSC_CSX_MAC_SIZE);
+
+	if (msg != NULL && enc != NULL && dec != NULL)
+	{
+		/* each thread is an independent connection with its own key */
+		key[0] = (uint8_t)args->core;
+		nonce[0] = (uint8_t)args->core;
+		qsc_csx_keyparams kp = { key, sizeof(key), nonce, NULL, 0 };
+
+		for (i = 0; i < SCALING_BUFFER_SIZE; ++i)
+		{
+			msg[i] = (uint8_t)(i + args->core);
+		}
+
+		if (args->mode == scaling_csx_open)
+		{
+			qsc_csx_initialize(&ctx, &kp, true);
+			qsc_csx_transform(&ctx, enc, msg, SCALING_BUFFER_SIZE);
+			qsc_csx_dispose(&ctx);
+		}
+
+		for (i = 0; i < SCALING_THREAD_BYTES / SCALING_BUFFER_SIZE; ++i)
+		{
+			if (args->mode == scaling_csx_seal)
+			{
+				qsc_csx_initialize(&ctx, &kp, true);
+				qsc_csx_transform(&ctx, enc, msg, SCALING_BUFFER_SIZE);
+				qsc_csx_dispose(&ctx);
+				args->bytes += SCALING_BUFFER_SIZE;
+			}
+			else if (args->mode == scaling_csx_open)
+			{
+				/* only authenticated messages are counted, a failure shows as lost throughput */
+				qsc_csx_initialize(&ctx, &kp, false);
+
+				if (qsc_csx_transform(&ctx, dec, enc, SCALING_BUFFER_SIZE) == true)
+				{
+					args->bytes += SCALING_BUFFER_SIZE;
+				}
+
+				qsc_csx_dispose(&ctx);
+			}
+			else
+			{
+				qsc_kmac256_compute(tag, sizeof(tag), msg, SCALING_BUFFER_SIZE, key, sizeof(key), NULL, 0);
+				args->bytes += SCALING_BUFFER_SIZE;
+			}
+		}
+	}
+
+	if (msg != NULL)
+	{
+		qsc_memutils_alloc_free(msg);
+	}
+
+	if (enc != NULL)
+	{
+		qsc_memutils_alloc_free(enc);
+	}
+
+	if (dec != NULL)
+	{
+		qsc_memutils_alloc_free(dec);
+	}
+}
+
+static void benchmark_scaling_mode_run(benchmark_scaling_mode mode, const char* name, size_t maxthreads)
+{
+	qsc_thread handles[QSC_ASYNC_THREADS_MAX];
+	benchmark_scaling_args args[QSC_ASYNC_THREADS_MAX];
+	const double FRQ = (double)qsc_timerex_cycles_frequency();
+	double base;
+	double gbps;
+	uint64_t bytes;
+	uint64_t nsec;
+	size_t count;
+	size_t i;
+	size_t threads;
+	bool pinned;
+
+	base = 0.0;
+	threads = 1;
+
+	while (threads <= maxthreads)
+	{
+		count = 0;
+		bytes = 0;
+		pinned = true;
+		nsec = qsc_timerex_monotonic_ns();
+
+		for (i = 0; i < threads; ++i)
+		{
+			args[i].mode = mode;
+			args[i].core = i;
+
+			if (qsc_async_thread_create(&handles[i], benchmark_scaling_thread, &args[i]) == false)
+			{
+				break;
+			}
+
+			++count;
+		}
+
+		for (i = 0; i < count; ++i)
+		{
+			qsc_async_thread_wait(&handles[i]);
+			bytes += args[i].bytes;
+			pinned = pinned && args[i].pinned;
+		}
+
+		nsec = qsc_timerex_stopwatch_elapsed_ns(nsec);
+
+		if (count == 0 || bytes == 0 || nsec == 0)
+		{
+			qsctest_print_safe(name);
+			qsctest_print_line(" scaling benchmark failed!");
+			break;
+		}
+
+		/* bytes per nanosecond is gigabytes per second */
+		gbps = (double)bytes / (double)nsec;
+
+		if (threads == 1)
+		{
+			base = gbps;
+		}
+
+		qsctest_print_safe(name);
+		qsctest_print_safe(" with ");
+		qsctest_print_ulong(count);
+		qsctest_print_safe(pinned ? " pinned threads: " : " unpinned threads: ");
+		qsctest_print_double(gbps);
+		qsctest_print_safe(" GB/s aggregate, ");
+		qsctest_print_double(gbps / (double)count);
+		qsctest_print_safe(" GB/s per core, ");
+		qsctest_print_double((gbps * 100.0) / (base * (double)count));
+		qsctest_print_line("% efficiency");
+
+		/* the cycles spent across all of the cores, per byte and per message */
+		benchmark_record(name, SCALING_BUFFER_SIZE, count, ((double)nsec * (double)count * FRQ) / (1000000000.0 * (double)bytes),
+			((double)nsec * (double)count * SCALING_BUFFER_SIZE) / (double)bytes);
+
+		if (threads == maxthreads)
+		{
+			break;
+		}
+
+		threads = qsc_intutils_min(threads * 2, maxthreads);
+	}
+}
+
+static void counters_print(const char* name, const benchmark_timer* tmr, const qsctest_perfcounters_state* perf, bool available, uint64_t bytes, uint64_t ops)
+{
+	benchmark_print(name, 1, tmr, bytes, ops);
+
+	if (available == true)
+	{
+		qsctest_perfcounters_print(perf, bytes);
+	}
+}
+
+static void counters_csx_benchmark(qsctest_perfcounters_state* perf, bool available)
+{
+	uint64_t state[QSC_CSX_STATE_SIZE] = { 0 };
+	uint8_t output[QSC_CSX_BLOCK_SIZE] = { 0 };
+	size_t tctr;
+	benchmark_timer tmr;
+
+	tctr = 0;
+	qsctest_perfcounters_start(perf);
+	benchmark_start(&tmr);
+
+	while (tctr < COUNTERS_PERMUTATION_COUNT)
+	{
+		qsc_csx_permute_p1024c(state, output);
+		/* feed the output back so every call depends on the previous one */
+		state[0] ^= qsc_intutils_le8to64(output);
+		++tctr;
+	}
+
+	benchmark_stop(&tmr);
+	qsctest_perfcounters_stop(perf);
+
+	counters_print("CSX p1024c", &tmr, perf, available, (uint64_t)tctr * QSC_CSX_BLOCK_SIZE, tctr);
+}
+
+#if defined(QSC_SYSTEM_HAS_AVX2) && !defined(QSC_SYSTEM_HAS_AVX512)
+static void counters_csxx4_benchmark(qsctest_perfcounters_state* perf, bool available)
+{
+	__m256i output[QSC_CSX_STATE_SIZE];
+	__m256i state[QSC_CSX_STATE_SIZE];
+	size_t tctr;
+	benchmark_timer tmr;
+
+	for (size_t i = 0; i < QSC_CSX_STATE_SIZE; ++i)
+	{
+		state[i] = _mm256_setzero_si256();
+	}
+
+	tctr = 0;
+	qsctest_perfcounters_start(perf);
+	benchmark_start(&tmr);
+
+	while (tctr < COUNTERS_PERMUTATION_COUNT)
+	{
+		qsc_csx_permute_p4x1024h(state, output);
+		state[0] = _mm256_xor_si256(state[0], output[0]);
+		++tctr;
+	}
+
+	benchmark_stop(&tmr);
+	qsctest_perfcounters_stop(perf);
+
+	counters_print("CSX p4x1024h", &tmr, perf, available, (uint64_t)tctr * 4 * QSC_CSX_BLOCK_SIZE, tctr);
+}
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+static void counters_csxx8_benchmark(qsctest_perfcounters_state* perf, bool available)
+{
+	__m512i output[QSC_CSX_STATE_SIZE];
+	__m512i state[QSC_CSX_STATE_SIZE];
+	size_t tctr;
+	benchmark_timer tmr;
+
+	for (size_t i = 0; i < QSC_CSX_STATE_SIZE; ++i)
+	{
+		state[i] = _mm512_setzero_si512();
+	}
+
+	tctr = 0;
+	qsctest_perfcounters_start(perf);
+	benchmark_start(&tmr);
+
+	while (tctr < COUNTERS_PERMUTATION_COUNT)
+	{
+		qsc_csx_permute_p8x1024h(state, output);
+		state[0] = _mm512_xor_si512(state[0], output[0]);
+		++tctr;
+	}
+
+	benchmark_stop(&tmr);
+	qsctest_perfcounters_stop(perf);
+
+	counters_print("CSX p8x1024h", &tmr, perf, available, (uint64_t)tctr * 8 * QSC_CSX_BLOCK_SIZE, tctr);
+}
+#endif
+
+static void counters_keccak_benchmark(qsctest_perfcounters_state* perf, bool available)
+{
+	uint64_t state[QSC_KECCAK_STATE_SIZE] = { 0 };
+	size_t tctr;
+	benchmark_timer tmr;
+
+	tctr = 0;
+	qsctest_perfcounters_start(perf);
+	benchmark_start(&tmr);
+
+	while (tctr < COUNTERS_PERMUTATION_COUNT)
+	{
+		qsc_keccak_permute_p1600c(state, QSC_KECCAK_PERMUTATION_ROUNDS);
+		++tctr;
+	}
+
+	benchmark_stop(&tmr);
+	qsctest_perfcounters_stop(perf);
+
+	counters_print("Keccak p1600c", &tmr, perf, available, (uint64_t)tctr * QSC_KECCAK_STATE_BYTE_SIZE, tctr);
+}
+
+#if defined(QSC_SYSTEM_HAS_AVX2)
+static void counters_keccakx4_benchmark(qsctest_perfcounters_state* perf, bool available)
+{
+	__m256i state[QSC_KECCAK_STATE_SIZE];
+	size_t tctr;
+	benchmark_timer tmr;
+
+	for (size_t i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		state[i] = _mm256_setzero_si256();
+	}
+
+	tctr = 0;
+	qsctest_perfcounters_start(perf);
+	benchmark_start(&tmr);
+
+	while (tctr < COUNTERS_PERMUTATION_COUNT)
+	{
+		qsc_keccak_permute_p4x1600(state, QSC_KECCAK_PERMUTATION_ROUNDS);
+		++tctr;
+	}
+
+	benchmark_stop(&tmr);
+	qsctest_perfcounters_stop(perf);
+
+	counters_print("Keccak p4x1600", &tmr, perf, available, (uint64_t)tctr * 4 * QSC_KECCAK_STATE_BYTE_SIZE, tctr);
+}
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+static void counters_keccakx8_benchmark(qsctest_perfcounters_state* perf, bool available)
+{
+	__m512i state[QSC_KECCAK_STATE_SIZE];
+	size_t tctr;
+	benchmark_timer tmr;
+
+	for (size_t i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		state[i] = _mm512_setzero_si512();
+	}
+
+	tctr = 0;
+	qsctest_perfcounters_start(perf);
+	benchmark_start(&tmr);
+
+	while (tctr < COUNTERS_PERMUTATION_COUNT)
+	{
+		qsc_keccak_permute_p8x1600(state, QSC_KECCAK_PERMUTATION_ROUNDS);
+		++tctr;
+	}
+
+	benchmark_stop(&tmr);
+	qsctest_perfcounters_stop(perf);
+
+	counters_print("Keccak p8x1600", &tmr, perf, available, (uint64_t)tctr * 8 * QSC_KECCAK_STATE_BYTE_SIZE, tctr);
+}
+#endif
+
+static void permutation_print(const char* name, size_t rounds, const benchmark_timer* tmr, size_t lanes, size_t width)
+{
+	char alg[BENCHMARK_NAME_MAX] = { 0 };
+	const uint64_t PERMS = (uint64_t)PERMUTATION_SAMPLE_COUNT * lanes;
+
+	snprintf(alg, sizeof(alg), "%s r%u", name, (unsigned int)rounds);
+
+	qsctest_print_safe(alg);
+	qsctest_print_safe(": ");
+	qsctest_print_double((double)tmr->cycles / (double)PERMUTATION_SAMPLE_COUNT);
+	qsctest_print_safe(" cycles/call, ");
+	qsctest_print_double((double)tmr->cycles / (double)PERMS);
+	qsctest_print_safe(" cycles/permutation, ");
+	qsctest_print_double((double)tmr->cycles / (double)(PERMS * width));
+	qsctest_print_line(" cycles/byte");
+
+	benchmark_record(alg, lanes * width, 1, (double)tmr->cycles / (double)(PERMS * width), (double)tmr->nsec / (double)PERMUTATION_SAMPLE_COUNT);
+}
+
+static void permutation_csx_p1024c_benchmark()
+{
+	uint64_t state[QSC_CSX_STATE_SIZE] = { 0 };
+	uint8_t output[QSC_CSX_BLOCK_SIZE] = { 0 };
+	benchmark_timer tmr;
+
+	for (size_t i = 0; i < PERMUTATION_WARMUP_COUNT + PERMUTATION_SAMPLE_COUNT; ++i)
+	{
+		if (i == PERMUTATION_WARMUP_COUNT)
+		{
+			benchmark_start(&tmr);
+		}
+
+		qsc_csx_permute_p1024c(state, output);
+		/* feed the output back so every call depends on the previous one */
+		state[0] ^= qsc_intutils_le8to64(output);
+	}
+
+	benchmark_stop(&tmr);
+	permutation_print("CSX p1024c", PERMUTATION_CSX_ROUNDS, &tmr, 1, QSC_CSX_BLOCK_SIZE);
+}
+
+#if defined(QSC_SYSTEM_HAS_AVX2) && !defined(QSC_SYSTEM_HAS_AVX512)
+static void permutation_csx_p4x1024h_benchmark()
+{
+	__m256i output[QSC_CSX_STATE_SIZE];
+	__m256i state[QSC_CSX_STATE_SIZE];
+	benchmark_timer tmr;
+
+	for (size_t i = 0; i < QSC_CSX_STATE_SIZE; ++i)
+	{
+		state[i] = _mm256_setzero_si256();
+	}
+
+	for (size_t i = 0; i < PERMUTATION_WARMUP_COUNT + PERMUTATION_SAMPLE_COUNT; ++i)
+	{
+		if (i == PERMUTATION_WARMUP_COUNT)
+		{
+			benchmark_start(&tmr);
+		}
+
+		qsc_csx_permute_p4x1024h(state, output);
+		state[0] = _mm256_xor_si256(state[0], output[0]);
+	}
+
+	benchmark_stop(&tmr);
+	permutation_print("CSX p4x1024h", PERMUTATION_CSX_ROUNDS, &tmr, 4, QSC_CSX_BLOCK_SIZE);
+}
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+static void permutation_csx_p8x1024h_benchmark()
+{
+	__m512i output[QSC_CSX_STATE_SIZE];
+	__m512i state[QSC_CSX_STATE_SIZE];
+	benchmark_timer tmr;
+
+	for (size_t i = 0; i < QSC_CSX_STATE_SIZE; ++i)
+	{
+		state[i] = _mm512_setzero_si512();
+	}
+
+	for (size_t i = 0; i < PERMUTATION_WARMUP_COUNT + PERMUTATION_SAMPLE_COUNT; ++i)
+	{
+		if (i == PERMUTATION_WARMUP_COUNT)
+		{
+			benchmark_start(&tmr);
+		}
+
+		qsc_csx_permute_p8x1024h(state, output);
+		state[0] = _mm512_xor_si512(state[0], output[0]);
+	}
+
+	benchmark_stop(&tmr);
+	permutation_print("CSX p8x1024h", PERMUTATION_CSX_ROUNDS, &tmr, 8, QSC_CSX_BLOCK_SIZE);
+}
+#endif
+
+static void permutation_keccak_p1600c_benchmark(size_t rounds)
+{
+	uint64_t state[QSC_KECCAK_STATE_SIZE] = { 0 };
+	benchmark_timer tmr;
+
+	/* the permutation is in place, so each call consumes the previous output */
+	for (size_t i = 0; i < PERMUTATION_WARMUP_COUNT + PERMUTATION_SAMPLE_COUNT; ++i)
+	{
+		if (i == PERMUTATION_WARMUP_COUNT)
+		{
+			benchmark_start(&tmr);
+		}
+
+		qsc_keccak_permute_p1600c(state, rounds);
+	}
+
+	benchmark_stop(&tmr);
+	permutation_print("Keccak p1600c", rounds, &tmr, 1, QSC_KECCAK_STATE_BYTE_SIZE);
+}
+
+static void permutation_keccak_p1600u_benchmark()
+{
+	uint64_t state[QSC_KECCAK_STATE_SIZE] = { 0 };
+	benchmark_timer tmr;
+
+	for (size_t i = 0; i < PERMUTATION_WARMUP_COUNT + PERMUTATION_SAMPLE_COUNT; ++i)
+	{
+		if (i == PERMUTATION_WARMUP_COUNT)
+		{
+			benchmark_start(&tmr);
+		}
+
+		qsc_keccak_permute_p1600u(state);
+	}
+
+	benchmark_stop(&tmr);
+	permutation_print("Keccak p1600u", QSC_KECCAK_PERMUTATION_ROUNDS, &tmr, 1, QSC_KECCAK_STATE_BYTE_SIZE);
+}
+
+#if defined(QSC_SYSTEM_HAS_AVX2)
+static void permutation_keccak_p4x1600_benchmark(size_t rounds)
+{
+	__m256i state[QSC_KECCAK_STATE_SIZE];
+	benchmark_timer tmr;
+
+	for (size_t i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		state[i] = _mm256_setzero_si256();
+	}
+
+	for (size_t i = 0; i < PERMUTATION_WARMUP_COUNT + PERMUTATION_SAMPLE_COUNT; ++i)
+	{
+		if (i == PERMUTATION_WARMUP_COUNT)
+		{
+			benchmark_start(&tmr);
+		}
+
+		qsc_keccak_permute_p4x1600(state, rounds);
+	}
+
+	benchmark_stop(&tmr);
+	permutation_print("Keccak p4x1600", rounds, &tmr, 4, QSC_KECCAK_STATE_BYTE_SIZE);
+}
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+static void permutation_keccak_p8x1600_benchmark(size_t rounds)
+{
+	__m512i state[QSC_KECCAK_STATE_SIZE];
+	benchmark_timer tmr;
+
+	for (size_t i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		state[i] = _mm512_setzero_si512();
+	}
+
+	for (size_t i = 0; i < PERMUTATION_WARMUP_COUNT + PERMUTATION_SAMPLE_COUNT; ++i)
+	{
+		if (i == PERMUTATION_WARMUP_COUNT)
+		{
+			benchmark_start(&tmr);
+		}
+
+		qsc_keccak_permute_p8x1600(state, rounds);
+	}
+
+	benchmark_stop(&tmr);
+	permutation_print("Keccak p8x1600", rounds, &tmr, 8, QSC_KECCAK_STATE_BYTE_SIZE);
+}
+#endif
+
+static size_t benchmark_csv_split(char* line, char** fields, size_t maxfields)
+{
+	char* rd;
+	char* wr;
+	size_t count;
+	bool res;
+
+	count = 0;
+	rd = line;
+	res = true;
+
+	/* the fields are unquoted in place; a quoted field may contain commas, and a doubled quote is a quote */
+	while (res == true && count < maxfields)
+	{
+		fields[count] = rd;
+		wr = rd;
+
+		if (*rd == '"')
+		{
+			++rd;
+
+			while (*rd != 0 && (*rd != '"' || rd[1] == '"'))
+			{
+				rd += (*rd == '"') ? 1 : 0;
+				*wr = *rd;
+				++wr;
+				++rd;
+			}
+
+			/* an unterminated quote */
+			res = (*rd == '"');
+			rd += (res == true) ? 1 : 0;
+		}
+		else
+		{
+			while (*rd != 0 && *rd != ',' && *rd != '"')
+			{
+				*wr = *rd;
+				++wr;
+				++rd;
+			}
+		}
+
+		/* a field ends at a comma or the end of the line; anything else is a stray quote */
+		res = res && (*rd == ',' || *rd == 0);
+
+		if (res == true)
+		{
+			++count;
+
+			if (*rd == 0)
+			{
+				*wr = 0;
+				break;
+			}
+
+			*wr = 0;
+			++rd;
+		}
+	}
+
+	/* a malformed line, or more fields than a record has */
+	if (res == false || *rd != 0)
+	{
+		count = 0;
+	}
+
+	return count;
+}
+
+static bool benchmark_row_parse(char* line, benchmark_report_row* row)
+{
+	char* fields[BENCHMARK_FIELDS_MAX];
+	char* end;
+	size_t count;
+	bool res;
+
+	res = false;
+	count = benchmark_csv_split(line, fields, BENCHMARK_FIELDS_MAX);
+
+	/* algorithm, backend, size, threads, cycles_per_byte, ns_per_op, cpu, flags */
+	if (count == 8 && strlen(fields[0]) != 0 && strlen(fields[0]) < sizeof(row->algorithm) && strlen(fields[1]) != 0 &&
+		strlen(fields[1]) < sizeof(row->backend))
+	{
+		qsc_memutils_clear(row, sizeof(benchmark_report_row));
+		qsc_memutils_copy(row->algorithm, fields[0], strlen(fields[0]));
+		qsc_memutils_copy(row->backend, fields[1], strlen(fields[1]));
+		res = true;
+		row->size = strtoull(fields[2], &end, 10);
+		res = res && (end != fields[2] && *end == 0);
+		row->threads = strtoull(fields[3], &end, 10);
+		res = res && (end != fields[3] && *end == 0);
+		row->cpb = strtod(fields[4], &end);
+		res = res && (end != fields[4] && *end == 0 && row->cpb >= 0.0);
+		row->nsop = strtod(fields[5], &end);
+		res = res && (end != fields[5] && *end == 0 && row->nsop >= 0.0);
+	}
+
+	return res;
+}
+
+static size_t benchmark_read_rows(const char* path, benchmark_report_row* rows, size_t maxrows, bool* valid, size_t* malformed)
+{
+	char line[BENCHMARK_LINE_MAX] = { 0 };
+	FILE* fp;
+	size_t count;
+	size_t len;
+	size_t num;
+	bool partial;
+
+	count = 0;
+	num = 0;
+	partial = false;
+	*malformed = 0;
+	*valid = false;
+
+#if defined(_MSC_VER)
+	if (fopen_s(&fp, path, "r") != 0)
+	{
+		fp = NULL;
+	}
+#else
+	fp = fopen(path, "r");
+#endif
+
+	if (fp != NULL)
+	{
+		*valid = true;
+
+		while (fgets(line, sizeof(line), fp) != NULL)
+		{
+			len = strlen(line);
+
+			/* the remainder of a line longer than the buffer was reported with its start */
+			if (partial == true)
+			{
+				partial = (len != 0 && line[len - 1] != '\n');
+				continue;
+			}
+
+			++num;
+			partial = (len != 0 && line[len - 1] != '\n' && feof(fp) == 0);
+
+			while (len != 0 && (line[len - 1] == '\n' || line[len - 1] == '\r'))
+			{
+				--len;
+				line[len] = 0;
+			}
+
+			/* only the header and blank lines are skipped; a record that cannot be read is a failure, not a missing row */
+			if (len == 0 || (num == 1 && strcmp(line, BENCHMARK_CSV_HEADER) == 0))
+			{
+				continue;
+			}
+
+			if (partial == false && count < maxrows && benchmark_row_parse(line, &rows[count]) == true)
+			{
+				++count;
+			}
+			else
+			{
+				qsctest_print_safe("Malformed! ");
+				qsctest_print_safe(path);
+				qsctest_print_safe(" line ");
+				qsctest_print_ulong(num);
+				qsctest_print_line((count < maxrows) ? ": the record could not be read" : ": too many records");
+				++*malformed;
+			}
+		}
+
+		fclose(fp);
+	}
+
+	return count;
+}
+
+void qsctest_benchmark_csx_run()
+{
+	benchmark_clock_print();
+
+#if defined(QSC_CSX_AUTHENTICATED)
+	qsctest_print_line("Sizing the CSX-512 transform tile from the cache topology.");
+	csx_tile_benchmark();
+
+#endif
+	qsctest_print_line("Running the CSX-512 performance benchmarks.");
+	csx_benchmark_test();
+
+	qsctest_print_line("Running the CSX-512 key-setup latency benchmarks.");
+	csx_setup_benchmark();
+
+	qsctest_print_line("Running the CSX-512 nonce generation latency benchmarks.");
+	csp_nonce_benchmark();
+
+	qsctest_print_line("Running the CSX-512 DRBG throughput and small request latency benchmarks.");
+	csx_drbg_benchmark();
+
+	qsctest_print_line("Running the CSX-512 message size sweep; median and 99th percentile of repeated runs.");
+	csx_sweep_benchmark();
+
+	qsctest_print_line("Running the CSX-512 streaming store benchmark; decryption interleaved with a cache-resident working set.");
+	csx_stream_benchmark();
+}
+
+void qsctest_benchmark_scaling_run()
+{
+	size_t maxthr;
+
+	maxthr = qsc_intutils_min(qsc_async_processor_count(), QSC_ASYNC_THREADS_MAX);
+	benchmark_clock_print();
+
+	qsctest_print_safe("Running the multi-core scaling benchmarks on the ");
+	qsctest_print_safe(BENCHMARK_BACKEND);
+	qsctest_print_safe(" backend with ");
+	qsctest_print_safe(BENCHMARK_MAC);
+	qsctest_print_line(" authentication; independent 16KB messages, one thread per core.");
+
+	benchmark_scaling_mode_run(scaling_csx_seal, "CSX-512 seal", maxthr);
+	benchmark_scaling_mode_run(scaling_csx_open, "CSX-512 open", maxthr);
+	benchmark_scaling_mode_run(scaling_kmac256, "KMAC-256", maxthr);
+}
+
+void qsctest_benchmark_counters_run()
+{
+	qsctest_perfcounters_state perf;
+	bool available;
+
+	benchmark_clock_print();
+	available = qsctest_perfcounters_open(&perf);
+
+	if (available == false)
+	{
+		qsctest_print_line("Hardware performance counters are not available on this system, reporting timing only.");
+	}
+
+	qsctest_print_line("Running the permutation kernel hardware counter benchmarks.");
+	counters_csx_benchmark(&perf, available);
+
+#if defined(QSC_SYSTEM_HAS_AVX2) && !defined(QSC_SYSTEM_HAS_AVX512)
+	counters_csxx4_benchmark(&perf, available);
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+	counters_csxx8_benchmark(&perf, available);
+#endif
+
+	counters_keccak_benchmark(&perf, available);
+
+#if defined(QSC_SYSTEM_HAS_AVX2)
+	counters_keccakx4_benchmark(&perf, available);
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+	counters_keccakx8_benchmark(&perf, available);
+#endif
+
+	qsctest_perfcounters_close(&perf);
+}
+
+void qsctest_benchmark_permutation_run()
+{
+	benchmark_clock_print();
+
+	qsctest_print_line("Running the raw permutation benchmarks; chained calls with no buffer handling.");
+	qsctest_print_line("The CSX-512 permutations have a fixed 40 rounds, the Keccak permutations run at 12 and 24 rounds.");
+	permutation_csx_p1024c_benchmark();
+
+#if defined(QSC_SYSTEM_HAS_AVX2) && !defined(QSC_SYSTEM_HAS_AVX512)
+	permutation_csx_p4x1024h_benchmark();
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+	permutation_csx_p8x1024h_benchmark();
+#endif
+
+	permutation_keccak_p1600c_benchmark(QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
+	permutation_keccak_p1600c_benchmark(QSC_KECCAK_PERMUTATION_ROUNDS);
+	permutation_keccak_p1600u_benchmark();
+
+#if defined(QSC_SYSTEM_HAS_AVX2)
+	permutation_keccak_p4x1600_benchmark(QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
+	permutation_keccak_p4x1600_benchmark(QSC_KECCAK_PERMUTATION_ROUNDS);
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+	permutation_keccak_p8x1600_benchmark(QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
+	permutation_keccak_p8x1600_benchmark(QSC_KECCAK_PERMUTATION_ROUNDS);
+#endif
+}
+
+void qsctest_benchmark_kmac_run()
+{
+	benchmark_clock_print();
+
+	qsctest_print_line("Running the KMAC-128 performance benchmarks.");
 	kmac128_benchmark();
 
 	qsctest_print_line("Running the KMAC-256 performance benchmarks.");
@@ -612,6 +2422,12 @@ void qsctest_benchmark_kmac_run()
 	qsctest_print_line("Running the KMAC-512 performance benchmarks.");
 	kmac512_benchmark();
 
+	qsctest_print_line("Running the ParallelHash128 performance benchmarks.");
+	parallelhash128_benchmark();
+
+	qsctest_print_line("Running the ParallelHash256 performance benchmarks.");
+	parallelhash256_benchmark();
+
 #if defined(QSC_SYSTEM_HAS_AVX2)
 	qsctest_print_line("Running the AVX2 4X KMAC-128 performance benchmarks.");
 	kmac128x4_benchmark();
@@ -637,6 +2453,11 @@ void qsctest_benchmark_kmac_run()
 
 void qsctest_benchmark_kpa_run()
 {
+	benchmark_clock_print();
+
+	qsctest_print_line("KPA state memory footprint:");
+	kpa_state_sizes();
+
 	qsctest_print_line("Running the KPA-128 performance benchmarks.");
 	kpa128_benchmark();
 
@@ -645,10 +2466,22 @@ void qsctest_benchmark_kpa_run()
 
 	qsctest_print_line("Running the KPA-512 performance benchmarks.");
 	kpa512_benchmark();
+
+	qsctest_print_line("Running the KPA-16-256 performance benchmarks.");
+	kpa16_256_benchmark();
+
+	qsctest_print_line("Running the KPA-256 tree mode performance benchmarks.");
+
+	for (size_t i = 1; i <= qsc_intutils_min(qsc_async_processor_count(), QSC_ASYNC_THREADS_MAX); ++i)
+	{
+		kpa256_tree_benchmark(i);
+	}
 }
 
 void qsctest_benchmark_shake_run()
 {
+	benchmark_clock_print();
+
 	qsctest_print_line("Running the SHAKE-128 performance benchmarks.");
 	shake128_benchmark();
 
@@ -658,6 +2491,15 @@ void qsctest_benchmark_shake_run()
 	qsctest_print_line("Running the SHAKE-512 performance benchmarks.");
 	shake512_benchmark();
 
+	qsctest_print_line("Running the TurboSHAKE-128 performance benchmarks.");
+	turboshake128_benchmark();
+
+	qsctest_print_line("Running the KangarooTwelve KT128 performance benchmarks.");
+	kt128_benchmark();
+
+	qsctest_print_line("Running the KangarooTwelve KT256 performance benchmarks.");
+	kt256_benchmark();
+
 #if defined(QSC_SYSTEM_HAS_AVX2)
 	qsctest_print_line("Running the AVX2 4X SHAKE-128 performance benchmarks.");
 	shake128x4_benchmark();
@@ -680,3 +2522,175 @@ void qsctest_benchmark_shake_run()
 	shake512x8_benchmark();
 #endif
 }
+
+bool qsctest_benchmark_report_open(const char* path, qsctest_benchmark_format format)
+{
+	assert(path != NULL);
+
+	qsc_cpuidex_cpu_features cfeat;
+	char vendor[QSC_CPUIDEX_VENDOR_LENGTH + 1] = { 0 };
+	bool res;
+
+	res = false;
+
+	if (path != NULL && benchmark_report.file == NULL)
+	{
+#if defined(_MSC_VER)
+		if (fopen_s(&benchmark_report.file, path, "w") != 0)
+		{
+			benchmark_report.file = NULL;
+		}
+#else
+		benchmark_report.file = fopen(path, "w");
+#endif
+
+		if (benchmark_report.file != NULL)
+		{
+			benchmark_report.format = format;
+			benchmark_report.records = 0;
+
+			/* the vendor string is not terminated, and the cpuid frequency is often not reported */
+			qsc_memutils_clear(&cfeat, sizeof(cfeat));
+			qsc_cpuidex_features_set(&cfeat);
+			qsc_memutils_copy(vendor, cfeat.vendor, QSC_CPUIDEX_VENDOR_LENGTH);
+			snprintf(benchmark_report.cpu, sizeof(benchmark_report.cpu), "%s %u cores %llu MHz", vendor,
+				(unsigned int)cfeat.cores, (unsigned long long)(qsc_timerex_cycles_frequency() / 1000000));
+
+			if (format == qsctest_benchmark_format_csv)
+			{
+				fprintf(benchmark_report.file, "%s\n", BENCHMARK_CSV_HEADER);
+			}
+
+			res = true;
+		}
+	}
+
+	return res;
+}
+
+void qsctest_benchmark_report_close()
+{
+	if (benchmark_report.file != NULL)
+	{
+		if (benchmark_report.format == qsctest_benchmark_format_json)
+		{
+			fprintf(benchmark_report.file, "%s\n", (benchmark_report.records == 0) ? "[]" : "\n]");
+		}
+
+		fclose(benchmark_report.file);
+		benchmark_report.file = NULL;
+		benchmark_report.records = 0;
+	}
+}
+
+static size_t benchmark_row_find(const benchmark_report_row* row, const benchmark_report_row* rows, size_t count)
+{
+	size_t i;
+
+	/* rows are matched on the algorithm, backend, message size, and thread count */
+	for (i = 0; i < count; ++i)
+	{
+		if (strcmp(row->algorithm, rows[i].algorithm) == 0 && strcmp(row->backend, rows[i].backend) == 0 &&
+			row->size == rows[i].size && row->threads == rows[i].threads)
+		{
+			break;
+		}
+	}
+
+	return i;
+}
+
+int32_t qsctest_benchmark_compare(const char* baseline, const char* current, double threshold)
+{
+	assert(baseline != NULL);
+	assert(current != NULL);
+
+	benchmark_report_row* brows;
+	benchmark_report_row* crows;
+	size_t bbad;
+	size_t bcnt;
+	size_t cbad;
+	size_t ccnt;
+	size_t i;
+	size_t j;
+	int32_t res;
+	bool bvalid;
+	bool cvalid;
+
+	res = -1;
+
+	if (baseline != NULL && current != NULL)
+	{
+		brows = (benchmark_report_row*)qsc_memutils_malloc(BENCHMARK_ROWS_MAX * sizeof(benchmark_report_row));
+		crows = (benchmark_report_row*)qsc_memutils_malloc(BENCHMARK_ROWS_MAX * sizeof(benchmark_report_row));
+
+		if (brows != NULL && crows != NULL)
+		{
+			bcnt = benchmark_read_rows(baseline, brows, BENCHMARK_ROWS_MAX, &bvalid, &bbad);
+			ccnt = benchmark_read_rows(current, crows, BENCHMARK_ROWS_MAX, &cvalid, &cbad);
+
+			/* an empty report is a failed run, not a run without regressions */
+			if (bvalid == true && cvalid == true && ccnt != 0)
+			{
+				res = (int32_t)(bbad + cbad);
+
+				for (i = 0; i < ccnt; ++i)
+				{
+					j = benchmark_row_find(&crows[i], brows, bcnt);
+
+					if (j == bcnt)
+					{
+						qsctest_print_safe("No baseline for ");
+						qsctest_print_line(crows[i].algorithm);
+					}
+					else if (crows[i].cpb > brows[j].cpb * (1.0 + threshold) || crows[i].nsop > brows[j].nsop * (1.0 + threshold))
+					{
+						/* either measure can regress alone; the cycle counter does not follow frequency changes */
+						qsctest_print_safe("Regression! ");
+						qsctest_print_safe(crows[i].algorithm);
+						qsctest_print_safe(" ");
+						qsctest_print_ulong(crows[i].size);
+						qsctest_print_safe(" bytes: ");
+						qsctest_print_double(crows[i].cpb);
+						qsctest_print_safe((crows[i].size != 0) ? " cycles/byte, " : " cycles/op, ");
+						qsctest_print_double(crows[i].nsop);
+						qsctest_print_safe(" ns/op, baseline ");
+						qsctest_print_double(brows[j].cpb);
+						qsctest_print_safe((brows[j].size != 0) ? " cycles/byte, " : " cycles/op, ");
+						qsctest_print_double(brows[j].nsop);
+						qsctest_print_line(" ns/op");
+						++res;
+					}
+				}
+
+				/* a baseline row missing from the current report is a suite that crashed or was dropped */
+				for (j = 0; j < bcnt; ++j)
+				{
+					if (benchmark_row_find(&brows[j], crows, ccnt) == ccnt)
+					{
+						qsctest_print_safe("Missing! ");
+						qsctest_print_safe(brows[j].algorithm);
+						qsctest_print_safe(" ");
+						qsctest_print_ulong(brows[j].size);
+						qsctest_print_safe(" bytes, ");
+						qsctest_print_ulong(brows[j].threads);
+						qsctest_print_line(" threads: not in the current report");
+						++res;
+					}
+				}
+			}
+		}
+
+		if (brows != NULL)
+		{
+			qsc_memutils_alloc_free(brows);
+		}
+
+		if (crows != NULL)
+		{
+			qsc_memutils_alloc_free(crows);
+		}
+	}
+
+	return res;
+}
@@ -11,6 +11,47 @@
 
 #include "common.h"
 
+/*!
+* \enum qsctest_benchmark_format
+* \brief The benchmark report record formats
+*/
+typedef enum
+{
+	qsctest_benchmark_format_csv = 0,	/*!< One comma separated line per result, with a header line; fields containing commas are quoted */
+	qsctest_benchmark_format_json = 1,	/*!< A json array with one object per result */
+} qsctest_benchmark_format;
+
+/**
+* \brief Open a machine-readable benchmark report.
+* While the report is open, every benchmark result is also written to the file as a record containing
+* the algorithm, backend, message size, thread count, cycles per byte, nanoseconds per operation, cpu, and build flags.
+* A latency record has a message size of zero, and its cycles per byte field holds the median cycles per call.
+*
+* \param path: The report file path; an existing file is overwritten
+* \param format: The record format
+* \return Returns true if the report file was opened
+*/
+bool qsctest_benchmark_report_open(const char* path, qsctest_benchmark_format format);
+
+/**
+* \brief Complete and close the benchmark report
+*/
+void qsctest_benchmark_report_close();
+
+/**
+* \brief Compare a csv benchmark report against a baseline report.
+* Rows are matched on algorithm, backend, size, and thread count, and a row has regressed
+* if its cycles per byte or its nanoseconds per operation exceed the baseline by more than the threshold.
+* A baseline row with no matching row in the current report, and a line in either report that is not
+* the header or a readable record, are counted as failures, and a current report with no rows is rejected.
+*
+* \param baseline: The baseline csv report path
+* \param current: The current csv report path
+* \param threshold: The allowed slowdown as a fraction, ex. 0.05 for 5 percent
+* \return Returns the number of regressed, missing, and malformed rows, or -1 if either report could not be read or the current report is empty
+*/
+int32_t qsctest_benchmark_compare(const char* baseline, const char* current, double threshold);
+
 /**
 * \brief Tests the RHX implementations performance.
 * Tests the AEX; CBC, CTR, and HBA modes for performance timing.
@@ -29,6 +70,13 @@ void qsctest_benchmark_rhx_run();
 */
 void qsctest_benchmark_chacha_run();
 
+/**
+* \brief Measures the permutation kernels with the hardware performance counters.
+* Reports instructions per cycle, and cache and branch misses per KiB, alongside the timing.
+* Falls back to timing only if the counters are not available.
+*/
+void qsctest_benchmark_counters_run();
+
 /**
 * \brief Tests the CSX implementations performance.
 * Tests the CSX stream cipher for performance timing.
@@ -47,12 +95,26 @@ void qsctest_benchmark_kmac_run();
 */
 void qsctest_benchmark_kpa_run();
 
+/**
+* \brief Times the raw CSX and Keccak permutation kernels.
+* Each kernel runs a chain of calls that depend on the previous output, with no xor or buffer handling,
+* and reports the cycles per call, per permutation, and per byte of permutation output.
+*/
+void qsctest_benchmark_permutation_run();
+
 /**
 * \brief Tests the RCS implementations performance.
 * Tests the RCS authenticated stream cipher for performance timing.
 */
 void qsctest_benchmark_rcs_run();
 
+/**
+* \brief Tests the multi-core throughput scaling of CSX and KMAC.
+* Runs independent message loops on 1 to N threads, each pinned to its own core,
+* and reports the aggregate throughput and the per-core scaling efficiency.
+*/
+void qsctest_benchmark_scaling_run();
+
 /**
 * \brief Tests the SHAKE implementations performance.
 * Tests the various SHAKE implementations for performance timing.
@@ -299,20 +299,17 @@
 */
 #define QSC_SYSTEM_IS_LITTLE_ENDIAN (((union { uint32_t x; uint8_t c; }){1}).c)
 
-#if (!defined(QSC_SYSTEM_IS_LITTLE_ENDIAN))
-#	if defined(__sparc) || defined(__sparc__) || defined(__hppa__) || defined(__PPC__) || defined(__mips__) || defined(__MWERKS__) && (!defined(__INTEL__))
-		/*!
-		\def QSC_SYSTEM_IS_BIG_ENDIAN
-		* \brief The system is big endian
-		*/
+/*!
+\def QSC_SYSTEM_IS_BIG_ENDIAN
+* \brief The system is big endian.
+* A compile-time test for the byte-order specific code paths; QSC_SYSTEM_IS_LITTLE_ENDIAN is a run-time expression, and is always defined
+*/
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__)
+#	if (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
 #		define QSC_SYSTEM_IS_BIG_ENDIAN
-#	else
-		/*!
-		\def QSC_SYSTEM_IS_LITTLE_ENDIAN
-		* \brief The system is little endian
-		*/
-#		define QSC_SYSTEM_IS_LITTLE_ENDIAN
 #	endif
+#elif defined(__sparc) || defined(__sparc__) || defined(__hppa__) || defined(__PPC__) || defined(__mips__) || defined(__MWERKS__) && (!defined(__INTEL__))
+#	define QSC_SYSTEM_IS_BIG_ENDIAN
 #endif
 
 /*!
@@ -11,6 +11,7 @@ QSC_SYSTEM_CONDITION_IGNORE(5105)
 #   include <Windows.h>
 #	include <intrin.h>
 #	pragma intrinsic(__cpuid)
+#	pragma intrinsic(__cpuidex)
 #elif defined(QSC_SYSTEM_COMPILER_GCC) && defined(QSC_SYSTEM_OS_POSIX)
 #	if defined(QSC_SYSTEM_OS_APPLE)
 #   	include <sys/param.h>
@@ -92,7 +93,7 @@ static void osx_get_features(qsc_cpuidex_cpu_features* features)
 
 	if (sysctlbyname("hw.l1dcachesize", &pval, &plen, NULL, 0) == 0)
 	{
-		features->l1cache = pval;
+		features->l1cache = (uint32_t)(pval / 1024);
 	}
 
 	pval = 0;
@@ -108,7 +109,7 @@ static void osx_get_features(qsc_cpuidex_cpu_features* features)
 
 	if (sysctlbyname("hw.l2cachesize", &pval, &plen, NULL, 0) == 0)
 	{
-		features->l2cache = pval;
+		features->l2cache = (uint32_t)(pval / 1024);
 	}
 
 	pval = 0;
@@ -210,6 +211,7 @@ static void osx_get_features(qsc_cpuidex_cpu_features* features)
 #define CPUID_EBX_BMI1       	(1UL <<  3)
 #define CPUID_EBX_BMI2       	(1UL <<  8)
 #define CPUID_EBX_ADX        	(1UL << 19)
+#define CPUID_EBX_RDSEED     	(1UL << 18)
 #define CPUID_EBX_SHA        	(1UL << 29)
 #define CPUID_EBX_PREFETCHWT1	(1UL <<  0)
 #define CPUID_ECX_SSE3      	0x00000001UL
@@ -271,16 +273,81 @@ static void bus_info(qsc_cpuidex_cpu_features* features)
     }
 }
 
+static void cpuid_info_ex(uint32_t info[4], const uint32_t infotype, const uint32_t subtype)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+    __cpuidex((int*)info, infotype, subtype);
+#elif defined(QSC_SYSTEM_COMPILER_GCC)
+    __cpuid_count(infotype, subtype, info[0], info[1], info[2], info[3]);
+#endif
+}
+
+static uint32_t intel_cache_size(uint32_t level)
+{
+    uint32_t info[4] = { 0 };
+    uint32_t ctype;
+    uint32_t i;
+    uint32_t size;
+
+    size = 0;
+    cpuid_info(info, 0x00000000UL);
+
+    if (info[0] >= 0x00000004UL)
+    {
+        /* walk the deterministic cache parameters until the null descriptor */
+        for (i = 0; i < 16; ++i)
+        {
+            cpuid_info_ex(info, 0x00000004UL, i);
+            ctype = read_bits(info[0], 0, 5);
+
+            if (ctype == 0)
+            {
+                break;
+            }
+
+            /* data or unified cache at the requested level */
+            if ((ctype == 1 || ctype == 3) && read_bits(info[0], 5, 3) == level)
+            {
+                /* ways * partitions * line size * sets, in KiB */
+                size = ((read_bits(info[1], 22, 10) + 1) * (read_bits(info[1], 12, 10) + 1) *
+                    (read_bits(info[1], 0, 12) + 1) * (info[2] + 1)) / 1024;
+                break;
+            }
+        }
+    }
+
+    return size;
+}
+
 static void cpu_cache(qsc_cpuidex_cpu_features* features)
 {
     uint32_t info[4] = { 0 };
 
-    cpuid_info(info, 0x80000006UL);
+    cpuid_info(info, 0x80000000UL);
 
-    features->l1cache = read_bits(info[2], 0, 8);
-    features->l1cacheline = read_bits(info[2], 0, 11);
-    features->l2associative = read_bits(info[2], 12, 4);
-    features->l2cache = read_bits(info[2], 16, 16);
+    if (info[0] >= 0x80000006UL)
+    {
+        cpuid_info(info, 0x80000006UL);
+        features->l1cacheline = read_bits(info[2], 0, 8);
+        features->l2associative = read_bits(info[2], 12, 4);
+        features->l2cache = read_bits(info[2], 16, 16);
+    }
+
+    if (features->cputype == qsc_cpuid_amd)
+    {
+        /* the l1 data cache size in KiB */
+        cpuid_info(info, 0x80000005UL);
+        features->l1cache = read_bits(info[2], 24, 8);
+    }
+    else
+    {
+        features->l1cache = intel_cache_size(1);
+
+        if (features->l2cache == 0)
+        {
+            features->l2cache = intel_cache_size(2);
+        }
+    }
 }
 
 static uint32_t cpu_count()
@@ -309,6 +376,7 @@ static uint32_t cpu_count()
 
 static void cpu_topology(qsc_cpuidex_cpu_features* features)
 {
+    uint32_t ext[4] = { 0 };
     uint32_t info[4] = { 0 };
 
     /* total cpu cores */
@@ -328,6 +396,15 @@ static void cpu_topology(qsc_cpuidex_cpu_features* features)
     features->rdrand = ((info[2] & CPUID_ECX_RDRAND) != 0x00000000UL);
     features->rdtcsp = ((info[3] & CPUID_EDX_RDTCSP) != 0x00000000UL);
 
+    /* the structured extended feature flags */
+    cpuid_info(ext, 0x00000000UL);
+
+    if (ext[0] >= 0x00000007UL)
+    {
+        cpuid_info_ex(ext, 0x00000007UL, 0x00000000UL);
+        features->rdseed = ((ext[1] & CPUID_EBX_RDSEED) != 0x00000000UL);
+    }
+
 #if defined(QSC_SYSTEM_HAS_AVX)
     bool havx;
 
@@ -358,8 +435,7 @@ static void cpu_topology(qsc_cpuidex_cpu_features* features)
     }
     else if (features->cputype == qsc_cpuid_amd)
     {
-        cpuid_info(info, 0x80000005UL);
-        features->cacheline = read_bits(info[2], 24, 8);
+        features->cacheline = features->l1cacheline;
     }
 
     if (features->avx == true)
@@ -453,6 +529,7 @@ bool qsc_cpuidex_features_set(qsc_cpuidex_cpu_features* features)
     features->hyperthread = false;
     features->pcmul = false;
     features->rdrand = false;
+    features->rdseed = false;
     features->rdtcsp = false;
     features->cacheline = 0;
     features->cores = 0;
@@ -522,6 +599,9 @@ void qsc_cpuidex_print_stats()
 		qsc_consoleutils_print_safe("RDRAND: ");
 		qsc_consoleutils_print_line(cfeat.rdrand == true ? st : sf);
 
+		qsc_consoleutils_print_safe("RDSEED: ");
+		qsc_consoleutils_print_line(cfeat.rdseed == true ? st : sf);
+
 		qsc_consoleutils_print_safe("RDTCSP: ");
 		qsc_consoleutils_print_line(cfeat.rdtcsp == true ? st : sf);
 
@@ -69,17 +69,18 @@ QSC_EXPORT_API typedef struct
     bool hyperthread;                       	/*!< The hyper-thread flag */
     bool pcmul;                             	/*!< The PCLMULQDQ flag */
     bool rdrand;                            	/*!< The RDRAND flag */
+    bool rdseed;                            	/*!< The RDSEED flag */
     bool rdtcsp;                            	/*!< The RDTCSP flag */
-    uint32_t cacheline;                     	/*!< The number of cache lines */
+    uint32_t cacheline;                     	/*!< The cache line size in bytes */
     uint32_t cores;                         	/*!< The number of cores */
     uint32_t cpus;                          	/*!< The number of CPUs */
     uint32_t freqbase;                      	/*!< The frequency base */
     uint32_t freqmax;                       	/*!< The frequency maximum */
     uint32_t freqref;                       	/*!< The frequency reference */
-    uint32_t l1cache;                       	/*!< The L1 cache size */
+    uint32_t l1cache;                       	/*!< The L1 data cache size in KiB */
     uint32_t l1cacheline;                   	/*!< The L1 cache line size */
     uint32_t l2associative;                 	/*!< The L2 associative size */
-    uint32_t l2cache;                       	/*!< The L2 cache size */
+    uint32_t l2cache;                       	/*!< The L2 cache size in KiB */
     char serial[QSC_CPUIDEX_SERIAL_LENGTH];   	/*!< The CPU serial number */
     char vendor[QSC_CPUIDEX_VENDOR_LENGTH];   	/*!< The CPU vendor name */
     qsc_cpuidex_cpu_type cputype;             	/*!< The CPU manufacturer */
@@ -1,4 +1,10 @@
 #include "csp.h"
+#include "memutils.h"
+#include "sha3.h"
+#if defined(QSC_RDRAND_COMPATIBLE)
+#	include "cpuidex.h"
+#	include "intrinsics.h"
+#endif
 
 #if defined(QSC_SYSTEM_OS_WINDOWS)
 #	include <Windows.h>
@@ -18,12 +24,260 @@
 #	if !defined(O_NOCTTY)
 #		define O_NOCTTY 0
 #	endif
+#	if !defined(O_CLOEXEC)
+#		define O_CLOEXEC 0
+#	endif
+#	if defined(QSC_SYSTEM_OS_LINUX)
+#		include <sys/syscall.h>
+#	endif
+#	if defined(QSC_SYSTEM_OS_POSIX)
+#		include <pthread.h>
+#	endif
+#endif
+
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+#	define CSP_THREAD_LOCAL __declspec(thread)
+#else
+#	define CSP_THREAD_LOCAL __thread
+#endif
+
+#define CSP_KEY_SIZE 32
+/* the TurboSHAKE domain byte of the buffered generator output */
+#define CSP_GENERATOR_DOMAIN 0x0C
+/* the number of words drawn by the hardware start-up health test */
+#define CSP_HARDWARE_TEST_WORDS 16
+/* rdseed fails transiently when the conditioner is drained; rdrand only on a hardware fault */
+#define CSP_RDSEED_RETRIES 100
+#define CSP_RDRAND_RETRIES 10
+
+typedef struct
+{
+	uint8_t buffer[QSC_CSP_BUFFER_SIZE];	/* the unused generator output, consumed from the end */
+	uint8_t key[CSP_KEY_SIZE];				/* the generator key, replaced on every refill */
+	size_t position;						/* the number of unused bytes in the buffer */
+	size_t generated;						/* the bytes output since the last system reseed */
+	uint64_t hardware;						/* the last hardware word, for the repetition test */
+	size_t hgenerated;						/* the bytes output since the last reseed from either source */
+	uint32_t generation;					/* the fork generation the generator was seeded in */
+	bool seeded;							/* the generator has been seeded */
+} csp_buffered_state;
+
+static CSP_THREAD_LOCAL csp_buffered_state csp_buffered;
+/* incremented in the child process by the fork handler, it invalidates every inherited generator */
+static volatile uint32_t csp_fork_generation = 0;
+/* the source mixed into every thread's generator, returned to the system source by a failed health test */
+static volatile qsc_csp_source csp_source = qsc_csp_source_system;
+
+#if defined(QSC_SYSTEM_OS_POSIX)
+static pthread_once_t csp_fork_once = PTHREAD_ONCE_INIT;
+
+static void csp_fork_child()
+{
+	++csp_fork_generation;
+}
+
+static void csp_fork_register()
+{
+	pthread_atfork(NULL, NULL, csp_fork_child);
+}
+#endif
+
+#if defined(QSC_RDRAND_COMPATIBLE)
+
+#	if defined(QSC_SYSTEM_COMPILER_GCC)
+#		define CSP_TARGET_RDRAND __attribute__((target("rdrnd")))
+#		define CSP_TARGET_RDSEED __attribute__((target("rdseed")))
+#	else
+#		define CSP_TARGET_RDRAND
+#		define CSP_TARGET_RDSEED
+#	endif
+
+#	if defined(QSC_SYSTEM_ARCH_X64)
+typedef unsigned long long csp_hardware_word;
+#		define CSP_RDRAND_STEP _rdrand64_step
+#		define CSP_RDSEED_STEP _rdseed64_step
+#	else
+typedef unsigned int csp_hardware_word;
+#		define CSP_RDRAND_STEP _rdrand32_step
+#		define CSP_RDSEED_STEP _rdseed32_step
+#	endif
+
+static volatile bool csp_has_rdseed = false;
+
+static CSP_TARGET_RDSEED bool csp_rdseed_word(csp_hardware_word* word)
+{
+	bool res;
+
+	res = false;
+
+	for (size_t i = 0; i < CSP_RDSEED_RETRIES; ++i)
+	{
+		if (CSP_RDSEED_STEP(word) == 1)
+		{
+			res = true;
+			break;
+		}
+
+		_mm_pause();
+	}
+
+	return res;
+}
+
+static CSP_TARGET_RDRAND bool csp_rdrand_word(csp_hardware_word* word)
+{
+	bool res;
+
+	res = false;
+
+	for (size_t i = 0; i < CSP_RDRAND_RETRIES; ++i)
+	{
+		if (CSP_RDRAND_STEP(word) == 1)
+		{
+			res = true;
+			break;
+		}
+	}
+
+	return res;
+}
+
+static bool csp_hardware_word_read(csp_hardware_word* word, bool seed)
+{
+	bool res;
+
+	res = false;
+
+	if (seed == true && csp_has_rdseed == true)
+	{
+		res = csp_rdseed_word(word);
+	}
+
+	if (res == false)
+	{
+		res = csp_rdrand_word(word);
+	}
+
+	/* some processors return all-one or all-zero words with the carry flag set after a firmware fault */
+	if (res == true)
+	{
+		res = (*word != 0 && *word != (csp_hardware_word)~(csp_hardware_word)0);
+	}
+
+	return res;
+}
+
+static bool csp_hardware_read(csp_buffered_state* ctx, uint8_t* output, size_t length, bool seed)
+{
+	csp_hardware_word word;
+	size_t pos;
+	bool res;
+
+	res = true;
+	word = 0;
+
+	for (pos = 0; pos < length && res == true; pos += sizeof(word))
+	{
+		res = csp_hardware_word_read(&word, seed);
+
+		/* the repetition test, a stuck generator returns the same word */
+		if (res == true && (uint64_t)word != ctx->hardware)
+		{
+			ctx->hardware = (uint64_t)word;
+			qsc_memutils_copy(output + pos, &word, sizeof(word));
+		}
+		else
+		{
+			res = false;
+		}
+	}
+
+	word = 0;
+
+	return res;
+}
+
+static bool csp_hardware_test()
+{
+	csp_hardware_word words[CSP_HARDWARE_TEST_WORDS];
+	qsc_cpuidex_cpu_features cfeat;
+	bool res;
+
+	res = qsc_cpuidex_features_set(&cfeat);
+
+	if (res == true && cfeat.rdrand == true)
+	{
+		csp_has_rdseed = cfeat.rdseed;
+
+		/* every word must be read, must pass the word test, and must be distinct from every other word */
+		for (size_t i = 0; i < CSP_HARDWARE_TEST_WORDS && res == true; ++i)
+		{
+			res = csp_hardware_word_read(&words[i], false);
+
+			for (size_t j = 0; j < i && res == true; ++j)
+			{
+				res = (words[i] != words[j]);
+			}
+		}
+
+		qsc_memutils_clear(words, sizeof(words));
+	}
+	else
+	{
+		res = false;
+	}
+
+	return res;
+}
+
 #endif
 
 #if defined(__OpenBSD__) || defined(__CloudABI__) || defined(__wasi__)
 #	define HAVE_SAFE_ARC4RANDOM
 #endif
 
+#if !defined(QSC_SYSTEM_OS_WINDOWS) && !defined(HAVE_SAFE_ARC4RANDOM)
+static bool csp_urandom_read(uint8_t* output, size_t length)
+{
+	ssize_t r;
+	size_t pos;
+	int fd;
+	bool res;
+
+	res = false;
+	fd = open("/dev/urandom", O_RDONLY | O_NOCTTY | O_CLOEXEC);
+
+	if (fd >= 0)
+	{
+		pos = 0;
+
+		/* a read may return fewer bytes than requested, or be interrupted by a signal */
+		while (pos < length)
+		{
+			r = read(fd, output + pos, length - pos);
+
+			if (r > 0)
+			{
+				pos += (size_t)r;
+			}
+			else if (r < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		res = (pos == length);
+		close(fd);
+	}
+
+	return res;
+}
+#endif
+
 bool qsc_csp_generate(uint8_t* output, size_t length)
 {
 	assert(output != 0);
@@ -60,25 +314,219 @@ bool qsc_csp_generate(uint8_t* output, size_t length)
 
 #else
 
-	int32_t fd = open("/dev/urandom", O_RDONLY);
+#	if defined(QSC_SYSTEM_OS_LINUX) && defined(SYS_getrandom)
+	size_t pos;
+	long r;
+
+	pos = 0;
 
-	if (fd <= 0)
+	/* the getrandom call needs no file descriptor, and blocks only until the kernel pool is first initialized */
+	while (pos < length)
 	{
-		res = false;
+		r = syscall(SYS_getrandom, output + pos, length - pos, 0);
+
+		if (r > 0)
+		{
+			pos += (size_t)r;
+		}
+		else if (r < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	/* kernels older than 3.17 do not implement getrandom */
+	if (pos != length)
+	{
+		res = csp_urandom_read(output + pos, length - pos);
+	}
+#	else
+	res = csp_urandom_read(output, length);
+#	endif
+
+#endif
+
+	return res;
+}
+
+static bool csp_buffered_reseed(csp_buffered_state* ctx)
+{
+	uint8_t seed[CSP_KEY_SIZE * 2];
+	bool res;
+
+	/* the new key is derived from the old key and fresh system entropy, so a weak reseed cannot weaken the generator */
+	qsc_memutils_copy(seed, ctx->key, CSP_KEY_SIZE);
+	res = qsc_csp_generate(seed + CSP_KEY_SIZE, CSP_KEY_SIZE);
+
+	if (res == true)
+	{
+		qsc_shake256_compute(ctx->key, CSP_KEY_SIZE, seed, sizeof(seed));
+		qsc_memutils_clear(ctx->buffer, sizeof(ctx->buffer));
+		ctx->position = 0;
+		ctx->generated = 0;
+		ctx->hgenerated = 0;
+		ctx->generation = csp_fork_generation;
+		ctx->seeded = true;
+	}
+
+	qsc_memutils_clear(seed, sizeof(seed));
+
+	return res;
+}
+
+#if defined(QSC_RDRAND_COMPATIBLE)
+static void csp_hardware_reseed(csp_buffered_state* ctx)
+{
+	uint8_t seed[CSP_KEY_SIZE * 2];
+
+	/* between system reseeds the key is reseeded from rdseed, which draws on the entropy conditioner directly */
+	qsc_memutils_copy(seed, ctx->key, CSP_KEY_SIZE);
+
+	if (csp_hardware_read(ctx, seed + CSP_KEY_SIZE, CSP_KEY_SIZE, true) == true)
+	{
+		qsc_shake256_compute(ctx->key, CSP_KEY_SIZE, seed, sizeof(seed));
+		qsc_memutils_clear(ctx->buffer, sizeof(ctx->buffer));
+		ctx->position = 0;
+		ctx->hgenerated = 0;
 	}
 	else
 	{
-		int32_t r = read(fd, output, length);
+		csp_source = qsc_csp_source_system;
+		ctx->generated = QSC_CSP_HARDWARE_RESEED_BYTES;
+	}
+
+	qsc_memutils_clear(seed, sizeof(seed));
+}
+#endif
 
-		if (r != length)
+static void csp_buffered_refill(csp_buffered_state* ctx)
+{
+	uint8_t tmp[CSP_KEY_SIZE + QSC_CSP_BUFFER_SIZE];
+	uint8_t seed[CSP_KEY_SIZE * 2];
+	size_t slen;
+
+	qsc_memutils_copy(seed, ctx->key, CSP_KEY_SIZE);
+	slen = CSP_KEY_SIZE;
+
+#if defined(QSC_RDRAND_COMPATIBLE)
+	/* hardware output is absorbed with the key, so a faulty or backdoored generator cannot weaken the output */
+	if (csp_source == qsc_csp_source_hardware)
+	{
+		if (csp_hardware_read(ctx, seed + CSP_KEY_SIZE, CSP_KEY_SIZE, false) == true)
 		{
-			res = false;
+			slen = sizeof(seed);
+		}
+		else
+		{
+			/* a failed health test returns every thread to the system source, and forces this thread to reseed */
+			csp_source = qsc_csp_source_system;
+			ctx->generated = QSC_CSP_HARDWARE_RESEED_BYTES;
 		}
+	}
+#endif
 
-		close(fd);
+	/* fast key erasure: the key is expanded into its replacement and the output, then erased;
+	   the key and buffer are four TurboSHAKE256 rate blocks */
+	qsc_turboshake256_compute(tmp, sizeof(tmp), seed, slen, CSP_GENERATOR_DOMAIN);
+	qsc_memutils_copy(ctx->key, tmp, CSP_KEY_SIZE);
+	qsc_memutils_copy(ctx->buffer, tmp + CSP_KEY_SIZE, QSC_CSP_BUFFER_SIZE);
+	qsc_memutils_clear(seed, sizeof(seed));
+	qsc_memutils_clear(tmp, sizeof(tmp));
+	ctx->position = QSC_CSP_BUFFER_SIZE;
+}
+
+bool qsc_csp_buffered_generate(uint8_t* output, size_t length)
+{
+	assert(output != NULL);
+
+	csp_buffered_state* ctx;
+	size_t blen;
+	size_t limit;
+	size_t pos;
+	bool res;
+
+	ctx = &csp_buffered;
+	res = false;
+
+	if (output != NULL)
+	{
+		res = true;
+		pos = 0;
+
+#if defined(QSC_SYSTEM_OS_POSIX)
+		pthread_once(&csp_fork_once, csp_fork_register);
+#endif
+
+		while (pos < length && res == true)
+		{
+			/* with hardware entropy mixed into every refill, the system provider is needed less often */
+			limit = (csp_source == qsc_csp_source_hardware) ? QSC_CSP_HARDWARE_RESEED_BYTES : QSC_CSP_RESEED_BYTES;
+
+			if (ctx->seeded == false || ctx->generation != csp_fork_generation || ctx->generated >= limit)
+			{
+				res = csp_buffered_reseed(ctx);
+			}
+#if defined(QSC_RDRAND_COMPATIBLE)
+			else if (csp_source == qsc_csp_source_hardware && ctx->hgenerated >= QSC_CSP_RESEED_BYTES)
+			{
+				csp_hardware_reseed(ctx);
+			}
+#endif
+
+			if (res == true)
+			{
+				if (ctx->position == 0)
+				{
+					csp_buffered_refill(ctx);
+				}
+
+				/* bytes are taken from the end of the unused region, and erased once copied */
+				blen = (length - pos < ctx->position) ? length - pos : ctx->position;
+				ctx->position -= blen;
+				qsc_memutils_copy(output + pos, ctx->buffer + ctx->position, blen);
+				qsc_memutils_clear(ctx->buffer + ctx->position, blen);
+				ctx->generated += blen;
+				ctx->hgenerated += blen;
+				pos += blen;
+			}
+		}
 	}
 
+	return res;
+}
+
+void qsc_csp_buffered_dispose()
+{
+	qsc_memutils_clear(&csp_buffered, sizeof(csp_buffered_state));
+}
+
+bool qsc_csp_source_set(qsc_csp_source source)
+{
+	bool res;
+
+	res = false;
+
+	if (source == qsc_csp_source_system)
+	{
+		csp_source = qsc_csp_source_system;
+		res = true;
+	}
+#if defined(QSC_RDRAND_COMPATIBLE)
+	else if (source == qsc_csp_source_hardware)
+	{
+		res = csp_hardware_test();
+		csp_source = (res == true) ? qsc_csp_source_hardware : qsc_csp_source_system;
+	}
 #endif
 
 	return res;
 }
+
+qsc_csp_source qsc_csp_source_get()
+{
+	return csp_source;
+}
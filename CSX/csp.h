@@ -23,8 +23,10 @@
 /**
 * \file csp.h
 * \brief Cryptographic System entropy Provider
-* Provides access to either the Windows CryptGenRandom provider or
-* the /dev/urandom pool on Posix systems.
+* Provides access to either the Windows CryptGenRandom provider,
+* the getrandom system call on Linux, or the /dev/urandom pool on other Posix systems.
+* A per-thread buffered generator, seeded from the system provider, serves small requests without a system call.
+* The buffered generator can optionally mix RDSEED or RDRAND output into every refill, selected at runtime.
 * This provider is not recommended for stand-alone use, but should be combined
 * with another entropy provider to seed a MAC or DRBG function to provide quality
 * random output.
@@ -54,4 +56,76 @@ QSC_SYSTEM_CONDITION_IGNORE(5105)
 */
 QSC_EXPORT_API bool qsc_csp_generate(uint8_t* output, size_t length);
 
+/*!
+* \def QSC_CSP_BUFFER_SIZE
+* \brief The number of generator output bytes each thread buffers between generator updates
+*/
+#define QSC_CSP_BUFFER_SIZE 512
+
+/*!
+* \def QSC_CSP_RESEED_BYTES
+* \brief The number of bytes a thread's buffered generator outputs before it is reseeded from the system provider
+*/
+#define QSC_CSP_RESEED_BYTES 1048576
+
+/*!
+* \def QSC_CSP_HARDWARE_RESEED_BYTES
+* \brief The number of bytes a thread's buffered generator outputs before it is reseeded from the system provider,
+* when the hardware source is selected
+*/
+#define QSC_CSP_HARDWARE_RESEED_BYTES 16777216
+
+/*!
+* \enum qsc_csp_source
+* \brief The entropy sources mixed into the buffered generator
+*/
+typedef enum
+{
+	qsc_csp_source_system = 0x00U,		/*!< The generator key is seeded and reseeded from the system provider only */
+	qsc_csp_source_hardware = 0x01U,	/*!< RDRAND and RDSEED output is also mixed into the key */
+} qsc_csp_source;
+
+/**
+* \brief Get an array of pseudo-random bytes from the calling thread's buffered generator.
+* A fast-key-erasure generator built on TurboSHAKE256, seeded from qsc_csp_generate:
+* each refill expands a 256-bit key into a new key and a buffer of output, and the old key is erased,
+* output bytes are erased from the buffer as they are returned.
+* The generator is reseeded from the system provider every QSC_CSP_RESEED_BYTES, and in the child after a fork,
+* so a parent and child never return the same bytes. Intended for the many small requests of nonce and key generation,
+* without a system call per request.
+*
+* \param output: Pointer to the output byte array
+* \param length: The number of bytes to copy
+* \return Returns true for success
+*/
+QSC_EXPORT_API bool qsc_csp_buffered_generate(uint8_t* output, size_t length);
+
+/**
+* \brief Erase the calling thread's buffered generator state.
+* Call before a thread that used qsc_csp_buffered_generate exits; the next request from the thread reseeds the generator.
+*/
+QSC_EXPORT_API void qsc_csp_buffered_dispose(void);
+
+/**
+* \brief Select the entropy sources of the buffered generator, for every thread.
+* The hardware source mixes 256 bits of RDRAND output with the generator key on every refill, and reseeds the key
+* from RDSEED, or RDRAND when RDSEED is unavailable or exhausted, every QSC_CSP_RESEED_BYTES.
+* Hardware output is never used alone; the generator is still seeded from the system provider on first use,
+* after a fork, and every QSC_CSP_HARDWARE_RESEED_BYTES.
+* The hardware source is selected only if the CPU supports RDRAND and its output passes a start-up health test.
+* Continuous health tests reject a repeated, all-zero, or all-one word; a failure, or a retry limit reached,
+* returns the generator to the system source.
+*
+* \param source: The entropy source
+* \return Returns true if the source was selected
+*/
+QSC_EXPORT_API bool qsc_csp_source_set(qsc_csp_source source);
+
+/**
+* \brief Get the entropy source currently used by the buffered generator.
+*
+* \return Returns the selected source
+*/
+QSC_EXPORT_API qsc_csp_source qsc_csp_source_get(void);
+
 #endif
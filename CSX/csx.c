@@ -1,11 +1,25 @@
 #include "csx.h"
+#include "cpuidex.h"
 #include "intutils.h"
 #include "memutils.h"
+#include "timerex.h"
 
 #if defined(QSC_SYSTEM_HAS_AVX)
 #	include "intrinsics.h"
 #endif
 #include <stdlib.h>
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+#	include <intrin.h>
+#endif
+#if defined(QSC_CSX_STATISTICS)
+#	if defined(QSC_SYSTEM_ARCH_X86_X64)
+#		if defined(QSC_SYSTEM_COMPILER_MSC)
+#			include <intrin.h>
+#		else
+#			include <x86intrin.h>
+#		endif
+#	endif
+#endif
 
 /*!
 \def CSX_ROUND_COUNT
@@ -22,6 +36,55 @@
 #define CSX_AVX512_BLOCK (8 * QSC_CSX_BLOCK_SIZE)
 #define CSX_AVX2_BLOCK (4 * QSC_CSX_BLOCK_SIZE)
 
+/*!
+\def CSX_PREFETCH_BATCHES
+* \brief The number of batches ahead of the transform that the input is prefetched
+*/
+#if !defined(CSX_PREFETCH_BATCHES)
+#	define CSX_PREFETCH_BATCHES 2
+#endif
+
+#if	defined(QSC_CSX_AUTHENTICATED)
+/*!
+\def CSX_TILE_ALIGN
+* \brief The tile size granularity; a multiple of the widest parallel block
+*/
+#	define CSX_TILE_ALIGN CSX_AVX512_BLOCK
+
+/*!
+\def CSX_AUTOTUNE_CANDIDATES
+* \brief The number of tile sizes measured by the auto-tune function
+*/
+#	define CSX_AUTOTUNE_CANDIDATES 5
+
+/*!
+\def CSX_AUTOTUNE_MIN
+* \brief The minimum auto-tune message length in bytes
+*/
+#	define CSX_AUTOTUNE_MIN 262144
+
+/*!
+\def CSX_AUTOTUNE_MAX
+* \brief The maximum auto-tune message length in bytes
+*/
+#	define CSX_AUTOTUNE_MAX 4194304
+
+/*!
+\def CSX_AUTOTUNE_PASSES
+* \brief The number of timed passes per candidate, the fastest pass is used
+*/
+#	define CSX_AUTOTUNE_PASSES 3
+
+/*!
+\def CSX_AUTOTUNE_MARGIN
+* \brief A candidate replaces the current tile size only if it is faster by more than 1/CSX_AUTOTUNE_MARGIN
+*/
+#	define CSX_AUTOTUNE_MARGIN 32
+
+/* the encryption tile size in bytes, zero until sized from the detected cache; read and written atomically */
+static volatile size_t csx_tile_length = 0;
+#endif
+
 static const uint8_t csx_info[QSC_CSX_INFO_SIZE] =
 {
 	0x43, 0x53, 0x58, 0x35, 0x31, 0x32, 0x20, 0x4B, 0x4D, 0x41, 0x43, 0x20, 0x61, 0x75, 0x74, 0x68,
@@ -30,18 +93,90 @@ static const uint8_t csx_info[QSC_CSX_INFO_SIZE] =
 };
 
 #if	defined(QSC_CSX_AUTHENTICATED)
-static const uint8_t csx_name[CSX_NAME_LENGTH] =
+/* the cSHAKE-512 state after the name block; encoded rate, name length, the name 'CSX512-KMAC512',
+   and an empty customization, is absorbed and permuted. This is the first permutation of every
+   key expansion that uses the default info string, the state is the same for every key. */
+static const uint64_t csx_cshake_prefix[QSC_KECCAK_STATE_SIZE] =
 {
-	0x43, 0x53, 0x58, 0x35, 0x31, 0x32, 0x2D, 0x4B, 0x4D, 0x41, 0x43, 0x35, 0x31, 0x32
+	0x23748563489684C4ULL, 0x0E8E8E11EB16226EULL, 0x435A286E21435C11ULL, 0x374150C8AA983FDCULL,
+	0xEB7CA81A349A1011ULL, 0x082988B4CB306103ULL, 0x3A7B5C1D70E4BE19ULL, 0x5115A0E2E2CDB5ACULL,
+	0x5DBCCF199F97C072ULL, 0x043C9D1465E801FFULL, 0x6748E37715BF3F00ULL, 0xDC4847952A83A272ULL,
+	0x958CACE8E67B1608ULL, 0x91BEE543E17897F8ULL, 0x07774E4BE16A766FULL, 0x2015A0CEC52E5D2CULL,
+	0x1C5C53FD278F6BCCULL, 0x7C0FCCB2C4DF4C3BULL, 0xE5BCC0FADD4D2372ULL, 0xC6D9BF485708C712ULL,
+	0x59D4C967046E1F48ULL, 0x1D55A413825D42FCULL, 0xB8E17927CDA5E59AULL, 0x065D2E574CA58788ULL,
+	0x4EC0466272ABB338ULL
 };
 
 #	if defined(QSC_CSX_AUTH_KMACR12)
-#		define QSC_CSX_AUTH_KMACR12
-static const uint8_t csx_kmacr12_name[CSX_NAME_LENGTH] =
+/* the KMAC-R12 state after the name block with the name 'CSX512-KMACR12' is absorbed and permuted with 12 rounds */
+static const uint64_t csx_kmac_prefix[QSC_KECCAK_STATE_SIZE] =
 {
-	0x43, 0x53, 0x58, 0x35, 0x31, 0x32, 0x2D, 0x4B, 0x4D, 0x41, 0x43, 0x52, 0x31, 0x32
+	0x4729CCEE9A6C47A6ULL, 0x8D9199B00662D05AULL, 0x06F4D13AA127924FULL, 0x7748D8DD8BA83F40ULL,
+	0xFF58148BCD7F88B5ULL, 0x03C833F7DD8DFF09ULL, 0x060456CAB2FA5F49ULL, 0x7887C6DDE54F14C5ULL,
+	0xA24F0482509AEF55ULL, 0x0134B89F55F42DA3ULL, 0x6EA9AF5FF4EA2C57ULL, 0x8C873F0DDBE83F60ULL,
+	0x0E10705EC58D5200ULL, 0xAADA99A65B36C11DULL, 0x25249591043D1136ULL, 0x06A145C127114916ULL,
+	0x157210CA00D4C69AULL, 0xE26203F7AD728CDFULL, 0xDAB08BA52E91A125ULL, 0x9F40F4674F672CA0ULL,
+	0xF6F88D70A68F0701ULL, 0x6B245658F7FF8B4AULL, 0x7EB761F9862CCCE3ULL, 0xD541A1CCAED0C498ULL,
+	0xBD4EAF8DDB3D2D7CULL
 };
+#	else
+/* the KMAC-512 state after the name block with the name 'KMAC' is absorbed and permuted */
+static const uint64_t csx_kmac_prefix[QSC_KECCAK_STATE_SIZE] =
+{
+	0x57A7961417A62DFAULL, 0x6771656C5732049CULL, 0x9DD305C460F012B0ULL, 0x989F85F634EC5E9AULL,
+	0xD7989B129A369294ULL, 0x925AE8D6D07BDE30ULL, 0x9B930A35D4614A55ULL, 0xDE0897076DBB2946ULL,
+	0x422E9241F2A9657BULL, 0x3E16EACDB7B08547ULL, 0x70C6821D2AC5FBECULL, 0xBAD5477697743AD2ULL,
+	0x2D4F75A704D2ECD1ULL, 0xBE6EDDF39CC6E92BULL, 0x7BA79A24C3D36356ULL, 0xA1839FA187F9B0E8ULL,
+	0x23406472B82D5ED6ULL, 0x2EC9A16542C1D9CAULL, 0xF65CAED129F85FE4ULL, 0xC72888D649AB9384ULL,
+	0xC377008D0EF0951AULL, 0x1BE31B78E108E30DULL, 0xA87ABEE6AA95644EULL, 0x7D70B34C5A0D861CULL,
+	0xCDF0C616EB3B1E9FULL
+};
+#	endif
+#endif
+
+#if defined(QSC_CSX_STATISTICS)
+
+#	if defined(QSC_SYSTEM_COMPILER_MSC)
+#		define CSX_THREAD_LOCAL __declspec(thread)
+#	else
+#		define CSX_THREAD_LOCAL __thread
+#	endif
+
+typedef struct
+{
+	qsc_csx_stats stats;
+	uint64_t start;
+} csx_stats_state;
+
+static CSX_THREAD_LOCAL csx_stats_state csx_stats;
+
+static uint64_t csx_stats_clock()
+{
+#	if defined(QSC_SYSTEM_ARCH_X86_X64)
+	/* unfenced, the counters are meant to stay enabled in production builds */
+	return __rdtsc();
+#	else
+	return qsc_timerex_monotonic_ns();
 #	endif
+}
+
+static void csx_stats_begin()
+{
+	csx_stats.start = csx_stats_clock();
+}
+
+static void csx_stats_end(qsc_csx_stats_stage stage, size_t length)
+{
+	csx_stats.stats.cycles[stage] += csx_stats_clock() - csx_stats.start;
+	csx_stats.stats.bytes[stage] += length;
+	++csx_stats.stats.calls[stage];
+}
+
+#	define CSX_STATS_BEGIN() csx_stats_begin()
+#	define CSX_STATS_END(stage, length) csx_stats_end((stage), (length))
+#else
+#	define CSX_STATS_BEGIN()
+#	define CSX_STATS_END(stage, length)
 #endif
 
 static void csx_increment(qsc_csx_state* ctx)
@@ -54,24 +189,25 @@ static void csx_increment(qsc_csx_state* ctx)
 	}
 }
 
-static void csx_permute_p1024c(const qsc_csx_state* ctx, uint8_t* output)
-{
-	uint64_t X0 = ctx->state[0];
-	uint64_t X1 = ctx->state[1];
-	uint64_t X2 = ctx->state[2];
-	uint64_t X3 = ctx->state[3];
-	uint64_t X4 = ctx->state[4];
-	uint64_t X5 = ctx->state[5];
-	uint64_t X6 = ctx->state[6];
-	uint64_t X7 = ctx->state[7];
-	uint64_t X8 = ctx->state[8];
-	uint64_t X9 = ctx->state[9];
-	uint64_t X10 = ctx->state[10];
-	uint64_t X11 = ctx->state[11];
-	uint64_t X12 = ctx->state[12];
-	uint64_t X13 = ctx->state[13];
-	uint64_t X14 = ctx->state[14];
-	uint64_t X15 = ctx->state[15];
+static void csx_permute_p1024c(const uint64_t* state, uint8_t* output)
+{
+	uint64_t X0 = state[0];
+	uint64_t X1 = state[1];
+	uint64_t X2 = state[2];
+	uint64_t X3 = state[3];
+	uint64_t X4 = state[4];
+	uint64_t X5 = state[5];
+	uint64_t X6 = state[6];
+	uint64_t X7 = state[7];
+	uint64_t X8 = state[8];
+	uint64_t X9 = state[9];
+	uint64_t X10 = state[10];
+	uint64_t X11 = state[11];
+	uint64_t X12 = state[12];
+	uint64_t X13 = state[13];
+	uint64_t X14 = state[14];
+	uint64_t X15 = state[15];
+	uint64_t tmp[QSC_CSX_STATE_SIZE];
 	size_t ctr = CSX_ROUND_COUNT;
 
 	/* new rotational constants=
@@ -155,22 +291,25 @@ static void csx_permute_p1024c(const qsc_csx_state* ctx, uint8_t* output)
 		ctr -= 2;
 	}
 
-	qsc_intutils_le64to8(output, X0 + ctx->state[0]);
-	qsc_intutils_le64to8(output + 8, X1 + ctx->state[1]);
-	qsc_intutils_le64to8(output + 16, X2 + ctx->state[2]);
-	qsc_intutils_le64to8(output + 24, X3 + ctx->state[3]);
-	qsc_intutils_le64to8(output + 32, X4 + ctx->state[4]);
-	qsc_intutils_le64to8(output + 40, X5 + ctx->state[5]);
-	qsc_intutils_le64to8(output + 48, X6 + ctx->state[6]);
-	qsc_intutils_le64to8(output + 56, X7 + ctx->state[7]);
-	qsc_intutils_le64to8(output + 64, X8 + ctx->state[8]);
-	qsc_intutils_le64to8(output + 72, X9 + ctx->state[9]);
-	qsc_intutils_le64to8(output + 80, X10 + ctx->state[10]);
-	qsc_intutils_le64to8(output + 88, X11 + ctx->state[11]);
-	qsc_intutils_le64to8(output + 96, X12 + ctx->state[12]);
-	qsc_intutils_le64to8(output + 104, X13 + ctx->state[13]);
-	qsc_intutils_le64to8(output + 112, X14 + ctx->state[14]);
-	qsc_intutils_le64to8(output + 120, X15 + ctx->state[15]);
+	tmp[0] = X0 + state[0];
+	tmp[1] = X1 + state[1];
+	tmp[2] = X2 + state[2];
+	tmp[3] = X3 + state[3];
+	tmp[4] = X4 + state[4];
+	tmp[5] = X5 + state[5];
+	tmp[6] = X6 + state[6];
+	tmp[7] = X7 + state[7];
+	tmp[8] = X8 + state[8];
+	tmp[9] = X9 + state[9];
+	tmp[10] = X10 + state[10];
+	tmp[11] = X11 + state[11];
+	tmp[12] = X12 + state[12];
+	tmp[13] = X13 + state[13];
+	tmp[14] = X14 + state[14];
+	tmp[15] = X15 + state[15];
+	qsc_intutils_le64to8_array(output, tmp, QSC_CSX_STATE_SIZE);
+	/* the block is key-stream, and when rekeying a DRBG it is the next key */
+	qsc_memutils_secure_wipe(tmp, sizeof(tmp));
 }
 
 #if defined(QSC_SYSTEM_HAS_AVX512)
@@ -186,13 +325,6 @@ inline static __m512i csx_rotl512(const __m512i x, uint32_t shift)
 	return _mm512_or_si512(_mm512_slli_epi64(x, shift), _mm512_srli_epi64(x, 64 - shift));
 }
 
-static __m512i csx_load512(const uint8_t* v)
-{
-	const uint64_t* v64 = (uint64_t*)v;
-
-	return _mm512_set_epi64(v64[0], v64[16], v64[32], v64[48], v64[64], v64[80], v64[96], v64[112]);
-}
-
 static void csx_store512(uint8_t* output, const __m512i x)
 {
 	uint64_t tmp[8];
@@ -216,7 +348,7 @@ static void leincrement_512(__m512i* v)
 	*v = _mm512_add_epi64(*v, NAD);
 }
 
-static void csx_permute_p8x1024h(csx_avx512_state* ctx)
+static void csx_permute_p8x1024h(const __m512i* state, __m512i* output)
 {
 	__m512i x0;
 	__m512i x1;
@@ -236,22 +368,22 @@ static void csx_permute_p8x1024h(csx_avx512_state* ctx)
 	__m512i x15;
 	size_t ctr;
 
-	x0 = ctx->state[0];
-	x1 = ctx->state[1];
-	x2 = ctx->state[2];
-	x3 = ctx->state[3];
-	x4 = ctx->state[4];
-	x5 = ctx->state[5];
-	x6 = ctx->state[6];
-	x7 = ctx->state[7];
-	x8 = ctx->state[8];
-	x9 = ctx->state[9];
-	x10 = ctx->state[10];
-	x11 = ctx->state[11];
-	x12 = ctx->state[12];
-	x13 = ctx->state[13];
-	x14 = ctx->state[14];
-	x15 = ctx->state[15];
+	x0 = state[0];
+	x1 = state[1];
+	x2 = state[2];
+	x3 = state[3];
+	x4 = state[4];
+	x5 = state[5];
+	x6 = state[6];
+	x7 = state[7];
+	x8 = state[8];
+	x9 = state[9];
+	x10 = state[10];
+	x11 = state[11];
+	x12 = state[12];
+	x13 = state[13];
+	x14 = state[14];
+	x15 = state[15];
 	ctr = CSX_ROUND_COUNT;
 
 	/* new rotational constants=
@@ -335,22 +467,22 @@ static void csx_permute_p8x1024h(csx_avx512_state* ctx)
 		ctr -= 2;
 	}
 
-	ctx->outw[0] = _mm512_add_epi64(x0, ctx->state[0]);
-	ctx->outw[1] = _mm512_add_epi64(x1, ctx->state[1]);
-	ctx->outw[2] = _mm512_add_epi64(x2, ctx->state[2]);
-	ctx->outw[3] = _mm512_add_epi64(x3, ctx->state[3]);
-	ctx->outw[4] = _mm512_add_epi64(x4, ctx->state[4]);
-	ctx->outw[5] = _mm512_add_epi64(x5, ctx->state[5]);
-	ctx->outw[6] = _mm512_add_epi64(x6, ctx->state[6]);
-	ctx->outw[7] = _mm512_add_epi64(x7, ctx->state[7]);
-	ctx->outw[8] = _mm512_add_epi64(x8, ctx->state[8]);
-	ctx->outw[9] = _mm512_add_epi64(x9, ctx->state[9]);
-	ctx->outw[10] = _mm512_add_epi64(x10, ctx->state[10]);
-	ctx->outw[11] = _mm512_add_epi64(x11, ctx->state[11]);
-	ctx->outw[12] = _mm512_add_epi64(x12, ctx->state[12]);
-	ctx->outw[13] = _mm512_add_epi64(x13, ctx->state[13]);
-	ctx->outw[14] = _mm512_add_epi64(x14, ctx->state[14]);
-	ctx->outw[15] = _mm512_add_epi64(x15, ctx->state[15]);
+	output[0] = _mm512_add_epi64(x0, state[0]);
+	output[1] = _mm512_add_epi64(x1, state[1]);
+	output[2] = _mm512_add_epi64(x2, state[2]);
+	output[3] = _mm512_add_epi64(x3, state[3]);
+	output[4] = _mm512_add_epi64(x4, state[4]);
+	output[5] = _mm512_add_epi64(x5, state[5]);
+	output[6] = _mm512_add_epi64(x6, state[6]);
+	output[7] = _mm512_add_epi64(x7, state[7]);
+	output[8] = _mm512_add_epi64(x8, state[8]);
+	output[9] = _mm512_add_epi64(x9, state[9]);
+	output[10] = _mm512_add_epi64(x10, state[10]);
+	output[11] = _mm512_add_epi64(x11, state[11]);
+	output[12] = _mm512_add_epi64(x12, state[12]);
+	output[13] = _mm512_add_epi64(x13, state[13]);
+	output[14] = _mm512_add_epi64(x14, state[14]);
+	output[15] = _mm512_add_epi64(x15, state[15]);
 }
 
 
@@ -367,13 +499,6 @@ static __m256i csx_rotl256(const __m256i x, size_t shift)
 	return _mm256_or_si256(_mm256_slli_epi64(x, (int32_t)shift), _mm256_srli_epi64(x, 64 - (int32_t)shift));
 }
 
-static __m256i csx_load256(const uint8_t* v)
-{
-	const uint64_t* v64 = (const uint64_t*)v;
-
-	return _mm256_set_epi64x(v64[0], v64[16], v64[32], v64[48]);
-}
-
 static void csx_store256(uint8_t* output, const __m256i x)
 {
 	QSC_ALIGN(32) uint64_t tmp[4];
@@ -393,7 +518,7 @@ static void leincrement_256(__m256i* v)
 	*v = _mm256_add_epi64(*v, NAD);
 }
 
-static void csx_permute_p4x1024h(csx_avx256_state* ctx)
+static void csx_permute_p4x1024h(const __m256i* state, __m256i* output)
 {
 	__m256i x0;
 	__m256i x1;
@@ -413,22 +538,22 @@ static void csx_permute_p4x1024h(csx_avx256_state* ctx)
 	__m256i x15;
 	size_t ctr;
 
-	x0 = ctx->state[0];
-	x1 = ctx->state[1];
-	x2 = ctx->state[2];
-	x3 = ctx->state[3];
-	x4 = ctx->state[4];
-	x5 = ctx->state[5];
-	x6 = ctx->state[6];
-	x7 = ctx->state[7];
-	x8 = ctx->state[8];
-	x9 = ctx->state[9];
-	x10 = ctx->state[10];
-	x11 = ctx->state[11];
-	x12 = ctx->state[12];
-	x13 = ctx->state[13];
-	x14 = ctx->state[14];
-	x15 = ctx->state[15];
+	x0 = state[0];
+	x1 = state[1];
+	x2 = state[2];
+	x3 = state[3];
+	x4 = state[4];
+	x5 = state[5];
+	x6 = state[6];
+	x7 = state[7];
+	x8 = state[8];
+	x9 = state[9];
+	x10 = state[10];
+	x11 = state[11];
+	x12 = state[12];
+	x13 = state[13];
+	x14 = state[14];
+	x15 = state[15];
 	ctr = CSX_ROUND_COUNT;
 
 	/* new rotational constants=
@@ -512,22 +637,22 @@ static void csx_permute_p4x1024h(csx_avx256_state* ctx)
 		ctr -= 2;
 	}
 
-	ctx->outw[0] = _mm256_add_epi64(x0, ctx->state[0]);
-	ctx->outw[1] = _mm256_add_epi64(x1, ctx->state[1]);
-	ctx->outw[2] = _mm256_add_epi64(x2, ctx->state[2]);
-	ctx->outw[3] = _mm256_add_epi64(x3, ctx->state[3]);
-	ctx->outw[4] = _mm256_add_epi64(x4, ctx->state[4]);
-	ctx->outw[5] = _mm256_add_epi64(x5, ctx->state[5]);
-	ctx->outw[6] = _mm256_add_epi64(x6, ctx->state[6]);
-	ctx->outw[7] = _mm256_add_epi64(x7, ctx->state[7]);
-	ctx->outw[8] = _mm256_add_epi64(x8, ctx->state[8]);
-	ctx->outw[9] = _mm256_add_epi64(x9, ctx->state[9]);
-	ctx->outw[10] = _mm256_add_epi64(x10, ctx->state[10]);
-	ctx->outw[11] = _mm256_add_epi64(x11, ctx->state[11]);
-	ctx->outw[12] = _mm256_add_epi64(x12, ctx->state[12]);
-	ctx->outw[13] = _mm256_add_epi64(x13, ctx->state[13]);
-	ctx->outw[14] = _mm256_add_epi64(x14, ctx->state[14]);
-	ctx->outw[15] = _mm256_add_epi64(x15, ctx->state[15]);
+	output[0] = _mm256_add_epi64(x0, state[0]);
+	output[1] = _mm256_add_epi64(x1, state[1]);
+	output[2] = _mm256_add_epi64(x2, state[2]);
+	output[3] = _mm256_add_epi64(x3, state[3]);
+	output[4] = _mm256_add_epi64(x4, state[4]);
+	output[5] = _mm256_add_epi64(x5, state[5]);
+	output[6] = _mm256_add_epi64(x6, state[6]);
+	output[7] = _mm256_add_epi64(x7, state[7]);
+	output[8] = _mm256_add_epi64(x8, state[8]);
+	output[9] = _mm256_add_epi64(x9, state[9]);
+	output[10] = _mm256_add_epi64(x10, state[10]);
+	output[11] = _mm256_add_epi64(x11, state[11]);
+	output[12] = _mm256_add_epi64(x12, state[12]);
+	output[13] = _mm256_add_epi64(x13, state[13]);
+	output[14] = _mm256_add_epi64(x14, state[14]);
+	output[15] = _mm256_add_epi64(x15, state[15]);
 }
 
 #endif
@@ -541,7 +666,7 @@ static void csx_mac_update(qsc_csx_state* ctx, const uint8_t* input, size_t leng
 #endif
 }
 
-static void csx_transform(qsc_csx_state* ctx, uint8_t* output, const uint8_t* input, size_t length)
+static void csx_transform(qsc_csx_state* ctx, uint8_t* output, const uint8_t* input, size_t length, bool stream)
 {
 	size_t oft;
 
@@ -551,8 +676,8 @@ static void csx_transform(qsc_csx_state* ctx, uint8_t* output, const uint8_t* in
 
 	if (length >= CSX_AVX512_BLOCK)
 	{
+		QSC_ALIGN(64) uint8_t sblk[CSX_AVX512_BLOCK];
 		csx_avx512_state ctxw;
-		__m512i tmpin;
 		size_t i;
 
 		for (i = 0; i < 16; ++i)
@@ -567,13 +692,25 @@ static void csx_transform(qsc_csx_state* ctx, uint8_t* output, const uint8_t* in
 		/* process 8 blocks in parallel (uses avx512 if available) */
 		while (length >= CSX_AVX512_BLOCK)
 		{
-			csx_permute_p8x1024h(&ctxw);
+			qsc_memutils_prefetch_ahead((input + oft), length, 0, CSX_PREFETCH_BATCHES * CSX_AVX512_BLOCK, CSX_AVX512_BLOCK, qsc_memutils_cache_level_l1);
+			csx_permute_p8x1024h(ctxw.state, ctxw.outw);
 
+			/* the key-stream batch is assembled on the stack and combined with the input in contiguous vectors,
+			   so the input is never read at the block stride, and the input and output may be the same array */
 			for (i = 0; i < 16; ++i)
 			{
-				tmpin = csx_load512((input + oft + (i * 8)));
-				ctxw.outw[i] = _mm512_xor_si512(ctxw.outw[i], tmpin);
-				csx_store512((output + oft + (i * 8)), ctxw.outw[i]);
+				csx_store512((sblk + (i * 8)), ctxw.outw[i]);
+			}
+
+			qsc_memutils_xor(sblk, (input + oft), CSX_AVX512_BLOCK);
+
+			if (stream == true)
+			{
+				qsc_memutils_stream_write((output + oft), sblk, CSX_AVX512_BLOCK);
+			}
+			else
+			{
+				qsc_memutils_copy((output + oft), sblk, CSX_AVX512_BLOCK);
 			}
 
 			leincrement_512(&ctxw.state[12]);
@@ -581,6 +718,9 @@ static void csx_transform(qsc_csx_state* ctx, uint8_t* output, const uint8_t* in
 			length -= CSX_AVX512_BLOCK;
 		}
 
+		/* the last batch of a decryption is plain-text */
+		qsc_memutils_secure_wipe(sblk, sizeof(sblk));
+
 		uint8_t ctrblk[64];
 		/* store the nonce */
 		_mm512_storeu_si512((__m512i*)ctrblk, ctxw.state[12]);
@@ -593,8 +733,8 @@ static void csx_transform(qsc_csx_state* ctx, uint8_t* output, const uint8_t* in
 
 	if (length >= CSX_AVX2_BLOCK)
 	{
+		QSC_ALIGN(32) uint8_t sblk[CSX_AVX2_BLOCK];
 		csx_avx256_state ctxw;
-		__m256i tmpin;
 		size_t i;
 
 		for (i = 0; i < 16; ++i)
@@ -609,13 +749,24 @@ static void csx_transform(qsc_csx_state* ctx, uint8_t* output, const uint8_t* in
 		/* process 8 blocks in parallel (uses avx512 if available) */
 		while (length >= CSX_AVX2_BLOCK)
 		{
-			csx_permute_p4x1024h(&ctxw);
+			qsc_memutils_prefetch_ahead((input + oft), length, 0, CSX_PREFETCH_BATCHES * CSX_AVX2_BLOCK, CSX_AVX2_BLOCK, qsc_memutils_cache_level_l1);
+			csx_permute_p4x1024h(ctxw.state, ctxw.outw);
 
+			/* the key-stream batch is assembled on the stack and combined with the input in contiguous vectors */
 			for (i = 0; i < 16; ++i)
 			{
-				tmpin = csx_load256(input + oft + (i * 8));
-				ctxw.outw[i] = _mm256_xor_si256(ctxw.outw[i], tmpin);
-				csx_store256((output + oft + (i * 8)), ctxw.outw[i]);
+				csx_store256((sblk + (i * 8)), ctxw.outw[i]);
+			}
+
+			qsc_memutils_xor(sblk, (input + oft), CSX_AVX2_BLOCK);
+
+			if (stream == true)
+			{
+				qsc_memutils_stream_write((output + oft), sblk, CSX_AVX2_BLOCK);
+			}
+			else
+			{
+				qsc_memutils_copy((output + oft), sblk, CSX_AVX2_BLOCK);
 			}
 
 			leincrement_256(&ctxw.state[12]);
@@ -623,6 +774,9 @@ static void csx_transform(qsc_csx_state* ctx, uint8_t* output, const uint8_t* in
 			length -= CSX_AVX2_BLOCK;
 		}
 
+		/* the last batch of a decryption is plain-text */
+		qsc_memutils_secure_wipe(sblk, sizeof(sblk));
+
 		QSC_ALIGN(32) uint8_t ctrblk[32];
 		/* store the nonce */
 		_mm256_storeu_si256((__m256i*)ctrblk, ctxw.state[12]);
@@ -633,53 +787,60 @@ static void csx_transform(qsc_csx_state* ctx, uint8_t* output, const uint8_t* in
 
 #endif
 
-	/* generate remaining blocks */
-	while (length >= QSC_CSX_BLOCK_SIZE)
+	/* generate remaining blocks; the key-stream is combined with the input before the output
+	   is written, so the input and output may be the same array */
+	if (length >= QSC_CSX_BLOCK_SIZE)
 	{
-		csx_permute_p1024c(ctx, (output + oft));
-		qsc_memutils_xor((output + oft), (input + oft), QSC_CSX_BLOCK_SIZE);
-		csx_increment(ctx);
-		oft += QSC_CSX_BLOCK_SIZE;
-		length -= QSC_CSX_BLOCK_SIZE;
+		uint8_t tmp[QSC_CSX_BLOCK_SIZE];
+
+		while (length >= QSC_CSX_BLOCK_SIZE)
+		{
+			qsc_memutils_prefetch_ahead((input + oft), length, 0, CSX_PREFETCH_BATCHES * QSC_CSX_BLOCK_SIZE, QSC_CSX_BLOCK_SIZE, qsc_memutils_cache_level_l1);
+			csx_permute_p1024c(ctx->state, tmp);
+			qsc_memutils_xor(tmp, (input + oft), QSC_CSX_BLOCK_SIZE);
+
+			if (stream == true)
+			{
+				qsc_memutils_stream_write((output + oft), tmp, QSC_CSX_BLOCK_SIZE);
+			}
+			else
+			{
+				qsc_memutils_copy((output + oft), tmp, QSC_CSX_BLOCK_SIZE);
+			}
+
+			csx_increment(ctx);
+			oft += QSC_CSX_BLOCK_SIZE;
+			length -= QSC_CSX_BLOCK_SIZE;
+		}
+
+		/* the last block of a decryption is plain-text */
+		qsc_memutils_secure_wipe(tmp, sizeof(tmp));
 	}
 
 	/* generate unaligned key-stream */
 	if (length != 0)
 	{
 		uint8_t tmp[QSC_CSX_BLOCK_SIZE] = { 0 };
-		csx_permute_p1024c(ctx, tmp);
+		csx_permute_p1024c(ctx->state, tmp);
 		csx_increment(ctx);
+		qsc_memutils_xor(tmp, (input + oft), length);
 		qsc_memutils_copy((output + oft), tmp, length);
-		qsc_memutils_xor((output + oft), (input + oft), length);
+		/* the unused key-stream past the end of the input */
+		qsc_memutils_secure_wipe(tmp, sizeof(tmp));
+	}
+
+	if (stream == true)
+	{
+		qsc_memutils_stream_fence();
 	}
 }
 
 static void csx_load_key(qsc_csx_state* ctx, const uint8_t* key, const uint8_t* nonce, const uint8_t* code)
 {
-#if defined(QSC_SYSTEM_IS_LITTLE_ENDIAN)
-	qsc_memutils_copy((uint8_t*)ctx->state, key, 64);
-	qsc_memutils_copy(((uint8_t*)ctx->state + 64), code, 32);
-	qsc_memutils_copy(((uint8_t*)ctx->state + 96), nonce, 16);
-	qsc_memutils_copy(((uint8_t*)ctx->state + 112), (code + 32), 16);
-#else
-	ctx->state[0] = qsc_intutils_le8to64(key);
-	ctx->state[1] = qsc_intutils_le8to64((key + 8));
-	ctx->state[2] = qsc_intutils_le8to64((key + 16));
-	ctx->state[3] = qsc_intutils_le8to64((key + 24));
-	ctx->state[4] = qsc_intutils_le8to64((key + 32));
-	ctx->state[5] = qsc_intutils_le8to64((key + 40));
-	ctx->state[6] = qsc_intutils_le8to64((key + 48));
-	ctx->state[7] = qsc_intutils_le8to64((key + 56));
-	ctx->state[8] = qsc_intutils_le8to64(code);
-	ctx->state[9] = qsc_intutils_le8to64((code + 8));
-	ctx->state[10] = qsc_intutils_le8to64((code + 16));
-	ctx->state[11] = qsc_intutils_le8to64((code + 24));
-	ctx->state[12] = qsc_intutils_le8to64(nonce);
-	ctx->state[13] = qsc_intutils_le8to64((nonce + 8));
-	ctx->state[14] = qsc_intutils_le8to64((code + 32));
-	ctx->state[15] = qsc_intutils_le8to64((code + 40));
-
-#endif
+	qsc_intutils_le8to64_array(ctx->state, key, 8);
+	qsc_intutils_le8to64_array(ctx->state + 8, code, 4);
+	qsc_intutils_le8to64_array(ctx->state + 12, nonce, 2);
+	qsc_intutils_le8to64_array(ctx->state + 14, code + 32, 2);
 }
 
 #if	defined(QSC_CSX_AUTHENTICATED)
@@ -700,6 +861,74 @@ static void csx_finalize(qsc_csx_state* ctx, uint8_t* output)
 	qsc_kmac_finalize(&ctx->kstate, qsc_keccak_rate_512, output, QSC_CSX_MAC_SIZE);
 #endif
 }
+
+static size_t csx_tile_align(size_t length)
+{
+	length -= (length % CSX_TILE_ALIGN);
+
+	return (length < CSX_TILE_ALIGN) ? CSX_TILE_ALIGN : length;
+}
+
+static size_t csx_tile_default()
+{
+	qsc_cpuidex_cpu_features cfeat;
+	size_t tile;
+
+	tile = QSC_CSX_TILE_DEFAULT;
+
+	if (qsc_cpuidex_features_set(&cfeat) == true && cfeat.l1cache != 0)
+	{
+		/* a tile of input and cipher-text together fill the l1 data cache */
+		tile = csx_tile_align(((size_t)cfeat.l1cache * 1024) / 2);
+	}
+
+	return tile;
+}
+
+static void csx_tiled_transform(qsc_csx_state* ctx, uint8_t* output, const uint8_t* input, size_t length)
+{
+	size_t blk;
+	size_t oft;
+	size_t tile;
+	bool stream;
+
+	tile = qsc_csx_tile_size();
+	/* the plain-text of a large decryption is not read again by the cipher, so it is streamed past the cache;
+	   the cipher-text of an encryption is read back by the mac and stays in the cache */
+	stream = (ctx->encrypt == false && length >= qsc_memutils_stream_threshold());
+	oft = 0;
+
+	/* run the transform and the mac one tile at a time, so the second pass
+	   over the cipher-text reads it from the l1 cache rather than memory */
+	while (length != 0)
+	{
+		blk = (length < tile) ? length : tile;
+
+		if (ctx->encrypt)
+		{
+			CSX_STATS_BEGIN();
+			csx_transform(ctx, output + oft, input + oft, blk, false);
+			CSX_STATS_END(qsc_csx_stage_keystream, blk);
+
+			CSX_STATS_BEGIN();
+			csx_mac_update(ctx, output + oft, blk);
+			CSX_STATS_END(qsc_csx_stage_absorb, blk);
+		}
+		else
+		{
+			CSX_STATS_BEGIN();
+			csx_mac_update(ctx, input + oft, blk);
+			CSX_STATS_END(qsc_csx_stage_absorb, blk);
+
+			CSX_STATS_BEGIN();
+			csx_transform(ctx, output + oft, input + oft, blk, stream);
+			CSX_STATS_END(qsc_csx_stage_keystream, blk);
+		}
+
+		oft += blk;
+		length -= blk;
+	}
+}
 #endif
 
 /* csx common */
@@ -715,12 +944,220 @@ void qsc_csx_dispose(qsc_csx_state* ctx)
 	qsc_keccak_dispose(&ctx->kstate);
 #endif
 
-		qsc_intutils_clear64(ctx->state, QSC_CSX_STATE_SIZE);
+		qsc_memutils_secure_wipe((uint8_t*)ctx->state, sizeof(ctx->state));
 		ctx->counter = 0;
 		ctx->encrypt = false;
 	}
 }
 
+void qsc_csx_permute_p1024c(const uint64_t* state, uint8_t* output)
+{
+	assert(state != NULL);
+	assert(output != NULL);
+
+	if (state != NULL && output != NULL)
+	{
+		csx_permute_p1024c(state, output);
+	}
+}
+
+#if defined(QSC_SYSTEM_HAS_AVX2) && !defined(QSC_SYSTEM_HAS_AVX512)
+void qsc_csx_permute_p4x1024h(const __m256i* state, __m256i* output)
+{
+	assert(state != NULL);
+	assert(output != NULL);
+
+	if (state != NULL && output != NULL)
+	{
+		csx_permute_p4x1024h(state, output);
+	}
+}
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+void qsc_csx_permute_p8x1024h(const __m512i* state, __m512i* output)
+{
+	assert(state != NULL);
+	assert(output != NULL);
+
+	if (state != NULL && output != NULL)
+	{
+		csx_permute_p8x1024h(state, output);
+	}
+}
+#endif
+
+#if defined(QSC_CSX_STATISTICS)
+void qsc_csx_stats_snapshot(qsc_csx_stats* stats)
+{
+	assert(stats != NULL);
+
+	if (stats != NULL)
+	{
+		qsc_memutils_copy(stats, &csx_stats.stats, sizeof(qsc_csx_stats));
+	}
+}
+
+void qsc_csx_stats_reset()
+{
+	qsc_memutils_clear(&csx_stats, sizeof(csx_stats_state));
+}
+#endif
+
+#if defined(QSC_CSX_AUTHENTICATED)
+static size_t csx_tile_load()
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	/* aligned volatile accesses are atomic, with acquire and release ordering, under msvc */
+	return csx_tile_length;
+#else
+	return __atomic_load_n(&csx_tile_length, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static void csx_tile_store(size_t length)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	csx_tile_length = length;
+#else
+	__atomic_store_n(&csx_tile_length, length, __ATOMIC_RELEASE);
+#endif
+}
+
+static void csx_tile_initialize(size_t length)
+{
+	/* the default is only stored if no size has been set, so a concurrent tile set is not overwritten */
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	_InterlockedCompareExchangePointer((void* volatile*)&csx_tile_length, (void*)length, NULL);
+#else
+	size_t exp = 0;
+	__atomic_compare_exchange_n(&csx_tile_length, &exp, length, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+size_t qsc_csx_tile_size()
+{
+	size_t tile;
+
+	tile = csx_tile_load();
+
+	if (tile == 0)
+	{
+		/* sessions that start together may each detect the cache once, every thread stores the same value */
+		csx_tile_initialize(csx_tile_default());
+		tile = csx_tile_load();
+	}
+
+	return tile;
+}
+
+void qsc_csx_tile_set(size_t length)
+{
+	/* zero restores the cache-derived default */
+	csx_tile_store((length != 0) ? csx_tile_align(length) : csx_tile_default());
+}
+
+static uint64_t csx_tile_measure(const qsc_csx_keyparams* keyparams, uint8_t* output, const uint8_t* input, size_t length)
+{
+	qsc_csx_state ctx;
+	uint64_t best;
+	uint64_t cyc;
+	size_t i;
+
+	best = UINT64_MAX;
+
+	/* the fastest of several passes, to exclude interrupts and a cold cache */
+	for (i = 0; i < CSX_AUTOTUNE_PASSES; ++i)
+	{
+		qsc_csx_initialize(&ctx, keyparams, true);
+		cyc = qsc_timerex_cycles_start();
+		qsc_csx_transform(&ctx, output, input, length);
+		cyc = qsc_timerex_cycles_stop() - cyc;
+		best = (cyc < best) ? cyc : best;
+	}
+
+	qsc_csx_dispose(&ctx);
+
+	return best;
+}
+
+size_t qsc_csx_tile_autotune()
+{
+	qsc_cpuidex_cpu_features cfeat;
+	size_t cand[CSX_AUTOTUNE_CANDIDATES];
+	uint8_t key[QSC_CSX_KEY_SIZE] = { 0 };
+	uint8_t nonce[QSC_CSX_NONCE_SIZE] = { 0 };
+	qsc_csx_keyparams kp = { key, sizeof(key), nonce, NULL, 0 };
+	uint8_t* inp;
+	uint8_t* otp;
+	uint64_t best;
+	uint64_t cyc;
+	size_t i;
+	size_t l1;
+	size_t l2;
+	size_t mlen;
+	size_t tile;
+
+	l1 = QSC_CSX_TILE_DEFAULT * 2;
+	l2 = QSC_CSX_TILE_DEFAULT * 16;
+
+	if (qsc_cpuidex_features_set(&cfeat) == true)
+	{
+		l1 = (cfeat.l1cache != 0) ? (size_t)cfeat.l1cache * 1024 : l1;
+		l2 = (cfeat.l2cache != 0) ? (size_t)cfeat.l2cache * 1024 : l2;
+	}
+
+	/* tiles that fit within the l1 cache, and tiles that fit within the l2 cache */
+	cand[0] = csx_tile_align(l1 / 4);
+	cand[1] = csx_tile_align(l1 / 2);
+	cand[2] = csx_tile_align(l1);
+	cand[3] = csx_tile_align(l2 / 4);
+	cand[4] = csx_tile_align(l2 / 2);
+
+	/* the message is larger than the l2 cache, so the untiled passes would stream from memory */
+	mlen = l2 * 2;
+	mlen = (mlen < CSX_AUTOTUNE_MIN) ? CSX_AUTOTUNE_MIN : (mlen > CSX_AUTOTUNE_MAX) ? CSX_AUTOTUNE_MAX : mlen;
+
+	tile = qsc_csx_tile_size();
+	inp = (uint8_t*)qsc_memutils_aligned_alloc(64, mlen);
+	otp = (uint8_t*)qsc_memutils_aligned_alloc(64, mlen + QSC_CSX_MAC_SIZE);
+
+	if (inp != NULL && otp != NULL)
+	{
+		qsc_memutils_clear(inp, mlen);
+		best = csx_tile_measure(&kp, otp, inp, mlen);
+		/* timing noise should not move the tile size away from the current setting */
+		best -= best / CSX_AUTOTUNE_MARGIN;
+
+		for (i = 0; i < CSX_AUTOTUNE_CANDIDATES; ++i)
+		{
+			csx_tile_store(cand[i]);
+			cyc = csx_tile_measure(&kp, otp, inp, mlen);
+
+			if (cyc < best)
+			{
+				best = cyc;
+				tile = cand[i];
+			}
+		}
+	}
+
+	if (inp != NULL)
+	{
+		qsc_memutils_aligned_free(inp);
+	}
+
+	if (otp != NULL)
+	{
+		qsc_memutils_aligned_free(otp);
+	}
+
+	csx_tile_store(tile);
+
+	return tile;
+}
+#endif
+
 void qsc_csx_initialize(qsc_csx_state* ctx, const qsc_csx_keyparams* keyparams, bool encryption)
 {
 	assert(keyparams->nonce != NULL);
@@ -733,62 +1170,65 @@ void qsc_csx_initialize(qsc_csx_state* ctx, const qsc_csx_keyparams* keyparams,
 #if defined(QSC_CSX_AUTHENTICATED)
 
 	qsc_keccak_state kstate;
-	uint8_t buf[QSC_KECCAK_512_RATE] = { 0 };
-	uint8_t cpk[QSC_CSX_KEY_SIZE] = { 0 };
-	uint8_t mck[QSC_CSX_KEY_SIZE] = { 0 };
+	uint8_t buf[2 * QSC_KECCAK_512_RATE];
 	uint8_t nme[CSX_NAME_LENGTH] = { 0 };
 
-	/* load the information string */
+	/* initialize the cSHAKE generator */
 	if (keyparams->infolen == 0)
 	{
-		qsc_memutils_copy(nme, csx_name, CSX_NAME_LENGTH);
+		/* resume from the precomputed name block state, and absorb the key */
+		qsc_memutils_copy((uint8_t*)kstate.state, (const uint8_t*)csx_cshake_prefix, sizeof(kstate.state));
+		kstate.position = 0;
+		/* the buffer is not used by the absorb and squeeze functions, so the dispose below erases only the state */
+		kstate.dirty = false;
+		qsc_keccak_absorb(&kstate, qsc_keccak_rate_512, keyparams->key, keyparams->keylen, QSC_KECCAK_CSHAKE_DOMAIN_ID, QSC_KECCAK_PERMUTATION_ROUNDS);
 	}
 	else
 	{
+		/* load the information string */
 		const size_t INFLEN = qsc_intutils_min(keyparams->infolen, CSX_NAME_LENGTH);
 		qsc_memutils_copy(nme, keyparams->info, INFLEN);
+		qsc_cshake_initialize(&kstate, qsc_keccak_rate_512, keyparams->key, keyparams->keylen, nme, sizeof(nme), NULL, 0);
 	}
 
-	/* initialize the cSHAKE generator */
-	qsc_cshake_initialize(&kstate, qsc_keccak_rate_512, keyparams->key, keyparams->keylen, nme, sizeof(nme), NULL, 0);
+	/* extract the cipher and mac keys in one call, each key is the start of its own block */
+	qsc_cshake_squeezeblocks(&kstate, qsc_keccak_rate_512, buf, 2);
 
-	/* extract the cipher key */
-	qsc_cshake_squeezeblocks(&kstate, qsc_keccak_rate_512, buf, 1);
-	qsc_memutils_copy(cpk, buf, QSC_CSX_KEY_SIZE);
-	csx_load_key(ctx, cpk, keyparams->nonce, csx_info);
+	/* load the cipher key directly into the state */
+	csx_load_key(ctx, buf, keyparams->nonce, csx_info);
 
-	/* extract the mac key */
-	qsc_cshake_squeezeblocks(&kstate, qsc_keccak_rate_512, buf, 1);
-	qsc_memutils_copy(mck, buf, sizeof(mck));
-
-	/* initialize the mac generator */
-	qsc_memutils_clear((uint8_t*)ctx->kstate.state, sizeof(ctx->kstate.state));
+	/* initialize the mac generator from the precomputed name block state, and absorb the mac key */
+	qsc_memutils_copy((uint8_t*)ctx->kstate.state, (const uint8_t*)csx_kmac_prefix, sizeof(ctx->kstate.state));
+	ctx->kstate.position = 0;
+	/* the buffer of a reused state may hold the last session's input, it is erased by the mac finalize */
+	ctx->kstate.dirty = true;
 
 #if defined(QSC_CSX_AUTH_KMACR12)
-	qsc_keccak_initialize_state(&ctx->kstate);
-	qsc_keccak_absorb_key_custom(&ctx->kstate, qsc_keccak_rate_512, mck, sizeof(mck), NULL, 0, csx_kmacr12_name, CSX_NAME_LENGTH, QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
+	qsc_keccak_absorb_key(&ctx->kstate, qsc_keccak_rate_512, buf + QSC_KECCAK_512_RATE, QSC_CSX_KEY_SIZE, QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
 #else
-	qsc_kmac_initialize(&ctx->kstate, qsc_keccak_rate_512, mck, sizeof(mck), NULL, 0);
+	qsc_keccak_absorb_key(&ctx->kstate, qsc_keccak_rate_512, buf + QSC_KECCAK_512_RATE, QSC_CSX_KEY_SIZE, QSC_KECCAK_PERMUTATION_ROUNDS);
 #endif
 
+	/* erase the key material */
+	qsc_memutils_secure_wipe(buf, sizeof(buf));
+	qsc_keccak_dispose(&kstate);
+
 #else
 
 	uint8_t inf[QSC_CSX_INFO_SIZE] = { 0 };
 
-	/* load the information string */
+	/* load the information string, every word of the state is written by the key load */
 	if (keyparams->infolen == 0)
 	{
-		qsc_memutils_copy(inf, csx_info, QSC_CSX_INFO_SIZE);
-}
+		csx_load_key(ctx, keyparams->key, keyparams->nonce, csx_info);
+	}
 	else
 	{
 		const size_t INFLEN = qsc_intutils_min(keyparams->infolen, QSC_CSX_INFO_SIZE);
 		qsc_memutils_copy(inf, keyparams->info, INFLEN);
+		csx_load_key(ctx, keyparams->key, keyparams->nonce, inf);
 	}
 
-	qsc_memutils_clear((uint8_t*)ctx->state, sizeof(ctx->state));
-	csx_load_key(ctx, keyparams->key, keyparams->nonce, inf);
-
 #endif
 }
 
@@ -831,18 +1271,19 @@ bool qsc_csx_transform(qsc_csx_state* ctx, uint8_t* output, const uint8_t* input
 	ctx->counter += length;
 
 	/* update the mac with the nonce */
+	CSX_STATS_BEGIN();
 	csx_mac_update(ctx, ncopy, sizeof(ncopy));
+	CSX_STATS_END(qsc_csx_stage_nonce, sizeof(ncopy));
 
 	if (ctx->encrypt)
 	{
-		/* use the transform to generate the key-stream and encrypt the data  */
-		csx_transform(ctx, output, input, length);
-
-		/* update the mac with the cipher-text */
-		csx_mac_update(ctx, output, length);
+		/* generate the key-stream, encrypt the data, and update the mac with the cipher-text */
+		csx_tiled_transform(ctx, output, input, length);
 
 		/* mac the cipher-text appending the code to the end of the array */
+		CSX_STATS_BEGIN();
 		csx_finalize(ctx, output + length);
+		CSX_STATS_END(qsc_csx_stage_finalize, QSC_CSX_MAC_SIZE);
 		res = true;
 	}
 	else
@@ -850,23 +1291,31 @@ bool qsc_csx_transform(qsc_csx_state* ctx, uint8_t* output, const uint8_t* input
 		uint8_t code[QSC_CSX_MAC_SIZE] = { 0 };
 
 		/* update the mac with the cipher-text */
+		CSX_STATS_BEGIN();
 		csx_mac_update(ctx, input, length);
+		CSX_STATS_END(qsc_csx_stage_absorb, length);
 
 		/* generate the internal mac code */
+		CSX_STATS_BEGIN();
 		csx_finalize(ctx, code);
+		CSX_STATS_END(qsc_csx_stage_finalize, QSC_CSX_MAC_SIZE);
 
 		/* compare the mac code with the one embedded in the cipher-text, bypassing the transform if the mac check fails */
 		if (qsc_intutils_verify(code, input + length, QSC_CSX_MAC_SIZE) == 0)
 		{
 			/* generate the key-stream and decrypt the array */
-			csx_transform(ctx, output, input, length);
+			CSX_STATS_BEGIN();
+			csx_transform(ctx, output, input, length, (length >= qsc_memutils_stream_threshold()));
+			CSX_STATS_END(qsc_csx_stage_keystream, length);
 			res = true;
 		}
 	}
 
 #else
 
-	csx_transform(ctx, output, input, length);
+	CSX_STATS_BEGIN();
+	csx_transform(ctx, output, input, length, (length >= qsc_memutils_stream_threshold()));
+	CSX_STATS_END(qsc_csx_stage_keystream, length);
 	res = true;
 
 #endif
@@ -895,20 +1344,21 @@ bool qsc_csx_extended_transform(qsc_csx_state* ctx, uint8_t* output, const uint8
 	ctx->counter += length;
 
 	/* update the mac with the nonce */
+	CSX_STATS_BEGIN();
 	csx_mac_update(ctx, ncopy, sizeof(ncopy));
+	CSX_STATS_END(qsc_csx_stage_nonce, sizeof(ncopy));
 
 	if (ctx->encrypt)
 	{
-		/* use the transform to generate the key-stream and encrypt the data  */
-		csx_transform(ctx, output, input, length);
-
-		/* update the mac with the cipher-text */
-		csx_mac_update(ctx, output, length);
+		/* generate the key-stream, encrypt the data, and update the mac with the cipher-text */
+		csx_tiled_transform(ctx, output, input, length);
 
 		if (finalize == true)
 		{
 			/* mac the cipher-text appending the code to the end of the array */
+			CSX_STATS_BEGIN();
 			csx_finalize(ctx, output + length);
+			CSX_STATS_END(qsc_csx_stage_finalize, QSC_CSX_MAC_SIZE);
 		}
 
 		res = true;
@@ -917,36 +1367,184 @@ bool qsc_csx_extended_transform(qsc_csx_state* ctx, uint8_t* output, const uint8
 	{
 		uint8_t code[QSC_CSX_MAC_SIZE] = { 0 };
 
-		/* update the mac with the cipher-text */
-		csx_mac_update(ctx, input, length);
-
 		if (finalize == true)
 		{
+			/* update the mac with the cipher-text */
+			CSX_STATS_BEGIN();
+			csx_mac_update(ctx, input, length);
+			CSX_STATS_END(qsc_csx_stage_absorb, length);
+
 			/* generate the internal mac code */
+			CSX_STATS_BEGIN();
 			csx_finalize(ctx, code);
+			CSX_STATS_END(qsc_csx_stage_finalize, QSC_CSX_MAC_SIZE);
 
 			/* compare the mac code with the one embedded in the cipher-text, bypassing the transform if the mac check fails */
 			if (qsc_intutils_verify(code, input + length, QSC_CSX_MAC_SIZE) == 0)
 			{
 				/* generate the key-stream and decrypt the array */
-				csx_transform(ctx, output, input, length);
+				CSX_STATS_BEGIN();
+				csx_transform(ctx, output, input, length, (length >= qsc_memutils_stream_threshold()));
+				CSX_STATS_END(qsc_csx_stage_keystream, length);
 				res = true;
 			}
 		}
 		else
 		{
-			/* generate the key-stream and decrypt the array */
-			csx_transform(ctx, output, input, length);
+			/* update the mac with the cipher-text, and generate the key-stream and decrypt the array */
+			csx_tiled_transform(ctx, output, input, length);
 			res = true;
 		}
 	}
 
 #else
 
-	csx_transform(ctx, output, input, length);
+	CSX_STATS_BEGIN();
+	csx_transform(ctx, output, input, length, (length >= qsc_memutils_stream_threshold()));
+	CSX_STATS_END(qsc_csx_stage_keystream, length);
 	res = true;
 
 #endif
 
 	return res;
 }
+
+/* the cSHAKE function name of the DRBG key derivation, 'CSX-DRBG' */
+static const uint8_t csx_drbg_name[8] = { 0x43, 0x53, 0x58, 0x2D, 0x44, 0x52, 0x42, 0x47 };
+
+static void csx_drbg_keystream(qsc_csx_drbg_state* ctx, uint8_t* output, size_t length)
+{
+	/* the transform combines the key-stream with its input, so the output is cleared and transformed in place;
+	   the length is at most a rekey interval, so the cleared output is still in cache when it is transformed */
+	qsc_memutils_clear(output, length);
+	csx_transform(&ctx->cstate, output, output, length, false);
+}
+
+static void csx_drbg_rekey(qsc_csx_drbg_state* ctx)
+{
+	uint8_t tmp[QSC_CSX_BLOCK_SIZE];
+
+	/* fast key erasure: the next key is a block of key-stream that is never output,
+	   so the earlier output cannot be recomputed from the state */
+	csx_permute_p1024c(ctx->cstate.state, tmp);
+	csx_increment(&ctx->cstate);
+
+	qsc_intutils_le8to64_array(ctx->cstate.state, tmp, QSC_CSX_KEY_SIZE / sizeof(uint64_t));
+
+	qsc_memutils_secure_wipe(tmp, sizeof(tmp));
+}
+
+void qsc_csx_drbg_dispose(qsc_csx_drbg_state* ctx)
+{
+	assert(ctx != NULL);
+
+	if (ctx != NULL)
+	{
+		/* the bytes above the position were erased as they were output, only the unused key-stream is wiped;
+		   the mac state of the generator is never written */
+		qsc_memutils_secure_wipe(ctx->buffer, qsc_intutils_min(ctx->position, sizeof(ctx->buffer)));
+		qsc_memutils_secure_wipe((uint8_t*)ctx->cstate.state, sizeof(ctx->cstate.state));
+		ctx->cstate.counter = 0;
+		ctx->position = 0;
+		ctx->generated = 0;
+		ctx->instantiated = false;
+	}
+}
+
+void qsc_csx_drbg_instantiate(qsc_csx_drbg_state* ctx, const uint8_t* seed, size_t seedlen, const uint8_t* info, size_t infolen)
+{
+	assert(ctx != NULL);
+	assert(seed != NULL);
+	assert(seedlen >= QSC_CSX_DRBG_SEED_MIN);
+
+	uint8_t buf[QSC_CSX_KEY_SIZE + QSC_CSX_NONCE_SIZE];
+
+	if (ctx != NULL && seed != NULL)
+	{
+		qsc_memutils_clear(ctx, sizeof(qsc_csx_drbg_state));
+
+		/* the key and the initial counter are derived from the seed */
+		qsc_cshake512_compute(buf, sizeof(buf), seed, seedlen, csx_drbg_name, sizeof(csx_drbg_name), info, (info != NULL) ? infolen : 0);
+		csx_load_key(&ctx->cstate, buf, buf + QSC_CSX_KEY_SIZE, csx_info);
+		qsc_memutils_secure_wipe(buf, sizeof(buf));
+		ctx->instantiated = true;
+	}
+}
+
+bool qsc_csx_drbg_generate(qsc_csx_drbg_state* ctx, uint8_t* output, size_t length)
+{
+	assert(ctx != NULL);
+	assert(output != NULL);
+
+	size_t blen;
+	size_t pos;
+	bool res;
+
+	res = false;
+
+	if (ctx != NULL && output != NULL && ctx->instantiated == true && length <= QSC_CSX_DRBG_RESEED_MAX - ctx->generated)
+	{
+		pos = 0;
+
+		if (length < QSC_CSX_DRBG_BUFFER_SIZE)
+		{
+			while (pos < length)
+			{
+				if (ctx->position == 0)
+				{
+					csx_drbg_keystream(ctx, ctx->buffer, QSC_CSX_DRBG_BUFFER_SIZE);
+					csx_drbg_rekey(ctx);
+					ctx->position = QSC_CSX_DRBG_BUFFER_SIZE;
+				}
+
+				/* bytes are taken from the end of the unused region, and erased once copied */
+				blen = qsc_intutils_min(length - pos, ctx->position);
+				ctx->position -= blen;
+				qsc_memutils_copy(output + pos, ctx->buffer + ctx->position, blen);
+				qsc_memutils_clear(ctx->buffer + ctx->position, blen);
+				pos += blen;
+			}
+		}
+		else
+		{
+			/* large requests bypass the buffer, and are rekeyed every interval and at the end */
+			while (pos < length)
+			{
+				blen = qsc_intutils_min(length - pos, QSC_CSX_DRBG_REKEY_SIZE);
+				csx_drbg_keystream(ctx, output + pos, blen);
+				csx_drbg_rekey(ctx);
+				pos += blen;
+			}
+		}
+
+		ctx->generated += length;
+		res = true;
+	}
+
+	return res;
+}
+
+void qsc_csx_drbg_reseed(qsc_csx_drbg_state* ctx, const uint8_t* seed, size_t seedlen)
+{
+	assert(ctx != NULL);
+	assert(seed != NULL);
+
+	uint8_t key[QSC_CSX_KEY_SIZE];
+	uint8_t tmp[QSC_CSX_KEY_SIZE];
+
+	if (ctx != NULL && seed != NULL && ctx->instantiated == true)
+	{
+		qsc_intutils_le64to8_array(key, ctx->cstate.state, QSC_CSX_KEY_SIZE / sizeof(uint64_t));
+
+		/* the current key is the customization, so a weak seed cannot weaken the generator */
+		qsc_cshake512_compute(tmp, sizeof(tmp), seed, seedlen, csx_drbg_name, sizeof(csx_drbg_name), key, sizeof(key));
+
+		qsc_intutils_le8to64_array(ctx->cstate.state, tmp, QSC_CSX_KEY_SIZE / sizeof(uint64_t));
+
+		qsc_memutils_secure_wipe(key, sizeof(key));
+		qsc_memutils_secure_wipe(tmp, sizeof(tmp));
+		qsc_memutils_secure_wipe(ctx->buffer, ctx->position);
+		ctx->position = 0;
+		ctx->generated = 0;
+	}
+}
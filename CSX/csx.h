@@ -144,12 +144,27 @@
 #	endif
 #endif
 
+/*!
+\def QSC_CSX_STATISTICS
+* \brief Enables the per-stage cycle and byte counters in the transform functions.
+* The counters are accumulated per thread and read with qsc_csx_stats_snapshot.
+* Unrem this flag, or pass it as a compiler definition, to enable the instrumentation.
+*/
+//#define QSC_CSX_STATISTICS
+
 /*!
 \def QSC_CSX_BLOCK_SIZE
 * \brief The internal block size in bytes, required by the encryption and decryption functions
 */
 #define QSC_CSX_BLOCK_SIZE 128
 
+/*!
+\def QSC_CSX_TILE_DEFAULT
+* \brief The authenticated transform tile size in bytes, used when the L1 data cache size cannot be detected.
+* Messages are encrypted and authenticated one tile at a time, so the mac reads the cipher-text from the cache.
+*/
+#define QSC_CSX_TILE_DEFAULT 16384
+
 /*!
 \def QSC_CSX_INFO_SIZE
 * \brief The maximum byte length of the info string
@@ -180,6 +195,30 @@
 */
 #define QSC_CSX_STATE_SIZE 16
 
+/*!
+\def QSC_CSX_DRBG_BUFFER_SIZE
+* \brief The number of key-stream bytes the DRBG buffers for small requests, one 8-block batch
+*/
+#define QSC_CSX_DRBG_BUFFER_SIZE 1024
+
+/*!
+\def QSC_CSX_DRBG_REKEY_SIZE
+* \brief The maximum number of DRBG output bytes generated under one key; large requests are rekeyed at this interval
+*/
+#define QSC_CSX_DRBG_REKEY_SIZE 65536
+
+/*!
+\def QSC_CSX_DRBG_RESEED_MAX
+* \brief The number of bytes the DRBG can output before it must be reseeded
+*/
+#define QSC_CSX_DRBG_RESEED_MAX 281474976710656ULL
+
+/*!
+\def QSC_CSX_DRBG_SEED_MIN
+* \brief The minimum DRBG seed size in bytes
+*/
+#define QSC_CSX_DRBG_SEED_MIN 32
+
 /*! 
 * \struct qsc_csx_keyparams
 * \brief The key parameters structure containing key, nonce, and info arrays and lengths.
@@ -213,6 +252,50 @@ QSC_EXPORT_API typedef struct
 	bool encrypt;							/*!< the transformation mode; true for encryption */
 } qsc_csx_state;
 
+/*!
+* \struct qsc_csx_drbg_state
+* \brief The CSX-512 deterministic random bit generator state
+*/
+QSC_EXPORT_API typedef struct
+{
+	qsc_csx_state cstate;							/*!< the key-stream state, the mac state is not used */
+	uint8_t buffer[QSC_CSX_DRBG_BUFFER_SIZE];		/*!< the unused buffered output, consumed from the end */
+	size_t position;								/*!< the number of unused bytes in the buffer */
+	uint64_t generated;								/*!< the bytes output since the last reseed */
+	bool instantiated;								/*!< the generator has been instantiated */
+} qsc_csx_drbg_state;
+
+#if defined(QSC_CSX_STATISTICS)
+/*!
+\def QSC_CSX_STATS_STAGES
+* \brief The number of instrumented transform stages
+*/
+#	define QSC_CSX_STATS_STAGES 4
+
+/*!
+* \enum qsc_csx_stats_stage
+* \brief The instrumented stages of the transform
+*/
+typedef enum
+{
+	qsc_csx_stage_nonce = 0,		/*!< The mac update with the nonce */
+	qsc_csx_stage_keystream = 1,	/*!< The key-stream generation and xor */
+	qsc_csx_stage_absorb = 2,		/*!< The mac update with the cipher-text */
+	qsc_csx_stage_finalize = 3,		/*!< The mac finalization */
+} qsc_csx_stats_stage;
+
+/*!
+* \struct qsc_csx_stats
+* \brief The per-stage transform counters of a thread
+*/
+QSC_EXPORT_API typedef struct
+{
+	uint64_t cycles[QSC_CSX_STATS_STAGES];	/*!< The time-stamp counter cycles spent in each stage */
+	uint64_t bytes[QSC_CSX_STATS_STAGES];	/*!< The bytes processed by each stage */
+	uint64_t calls[QSC_CSX_STATS_STAGES];	/*!< The number of times each stage ran */
+} qsc_csx_stats;
+#endif
+
 /* public functions */
 
 /**
@@ -225,6 +308,85 @@ QSC_EXPORT_API typedef struct
 */
 QSC_EXPORT_API void qsc_csx_dispose(qsc_csx_state* ctx);
 
+/**
+* \brief The CSX-512 permutation function.
+* Internal function: permutes a copy of the state and writes the key-stream block, the state is not modified.
+*
+* \param state: [const] The 16 word state array
+* \param output: The 128 byte key-stream output block
+*/
+QSC_EXPORT_API void qsc_csx_permute_p1024c(const uint64_t* state, uint8_t* output);
+
+#if defined(QSC_SYSTEM_HAS_AVX2) && !defined(QSC_SYSTEM_HAS_AVX512)
+/**
+* \brief The 4 lane CSX-512 permutation function.
+* Internal function: permutes 4 interleaved states, the state is not modified.
+* This function requires the AVX2 instruction set, and is replaced by the 8 lane function in AVX512 builds.
+*
+* \param state: [const] The 16 vector interleaved state array
+* \param output: The 16 vector interleaved key-stream output
+*/
+QSC_EXPORT_API void qsc_csx_permute_p4x1024h(const __m256i* state, __m256i* output);
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+/**
+* \brief The 8 lane CSX-512 permutation function.
+* Internal function: permutes 8 interleaved states, the state is not modified.
+* This function requires the AVX512 instruction set.
+*
+* \param state: [const] The 16 vector interleaved state array
+* \param output: The 16 vector interleaved key-stream output
+*/
+QSC_EXPORT_API void qsc_csx_permute_p8x1024h(const __m512i* state, __m512i* output);
+#endif
+
+#if defined(QSC_CSX_STATISTICS)
+/**
+* \brief Copy the calling thread's transform stage counters.
+* Requires the QSC_CSX_STATISTICS definition.
+*
+* \param stats: [struct] The receiving counters structure
+*/
+QSC_EXPORT_API void qsc_csx_stats_snapshot(qsc_csx_stats* stats);
+
+/**
+* \brief Reset the calling thread's transform stage counters to zero.
+* Requires the QSC_CSX_STATISTICS definition.
+*/
+QSC_EXPORT_API void qsc_csx_stats_reset();
+#endif
+
+#if defined(QSC_CSX_AUTHENTICATED)
+/**
+* \brief Returns the tile size used by the authenticated transform.
+* On the first call the size is derived from the detected L1 data cache, and cached; safe to call from any thread.
+*
+* \return The tile size in bytes
+*/
+QSC_EXPORT_API size_t qsc_csx_tile_size();
+
+/**
+* \brief Set the tile size used by the authenticated transform.
+* The size is rounded down to a multiple of the 8 block parallel width, and a zero length restores the cache-derived default.
+* The setting is process wide, and should be made before the cipher is used by other threads.
+*
+* \param length: The tile size in bytes
+*/
+QSC_EXPORT_API void qsc_csx_tile_set(size_t length);
+
+/**
+* \brief Measure the authenticated encryption speed using candidate tile sizes derived from the L1 and L2 cache sizes,
+* and set the tile size to the fastest candidate.
+* Intended to be called once at startup; the measurement encrypts twice the L2 cache size for each candidate.
+* The process wide tile size is set to each candidate while it is measured,
+* so no other thread may encrypt or decrypt while the autotune runs.
+*
+* \return The selected tile size in bytes
+*/
+QSC_EXPORT_API size_t qsc_csx_tile_autotune();
+#endif
+
 /**
 * \brief Initialize the state with the input cipher-key and optional info tweak.
 *
@@ -287,4 +449,51 @@ QSC_EXPORT_API bool qsc_csx_transform(qsc_csx_state* ctx, uint8_t* output, const
 */
 QSC_EXPORT_API bool qsc_csx_extended_transform(qsc_csx_state* ctx, uint8_t* output, const uint8_t* input, size_t length, bool finalize);
 
+/**
+* \brief Dispose of the DRBG state.
+* Erases the key, the counter, and the buffered output.
+*
+* \param ctx: [struct] The DRBG state
+*/
+QSC_EXPORT_API void qsc_csx_drbg_dispose(qsc_csx_drbg_state* ctx);
+
+/**
+* \brief Instantiate the CSX-512 DRBG.
+* The cipher key and the initial counter are derived from the seed with cSHAKE-512,
+* using the optional information string as the customization.
+*
+* \param ctx: [struct] The DRBG state
+* \param seed: [const] The seed, at least QSC_CSX_DRBG_SEED_MIN bytes of secret random
+* \param seedlen: The length of the seed in bytes
+* \param info: [const] The optional personalization string, can be NULL
+* \param infolen: The length of the personalization string in bytes
+*/
+QSC_EXPORT_API void qsc_csx_drbg_instantiate(qsc_csx_drbg_state* ctx, const uint8_t* seed, size_t seedlen, const uint8_t* info, size_t infolen);
+
+/**
+* \brief Generate pseudo-random bytes from the DRBG.
+* The output is the raw CSX-512 key-stream, without the mac. Requests of at least QSC_CSX_DRBG_BUFFER_SIZE bytes
+* are written directly by the vectorized key-stream, and the key is replaced with key-stream every
+* QSC_CSX_DRBG_REKEY_SIZE bytes and at the end of the request. Smaller requests are served from a buffer of key-stream,
+* and the key is replaced on every refill. Returned bytes are erased from the buffer, so no output can be
+* recovered from a later state. The output depends on the sequence of request sizes as well as the seed.
+*
+* \param ctx: [struct] The DRBG state
+* \param output: The output array
+* \param length: The number of bytes to generate
+* \return Returns false if the generator is not instantiated, or must be reseeded
+*/
+QSC_EXPORT_API bool qsc_csx_drbg_generate(qsc_csx_drbg_state* ctx, uint8_t* output, size_t length);
+
+/**
+* \brief Reseed the DRBG.
+* The new key is derived with cSHAKE-512 from the seed and the current key, the buffered output is discarded,
+* and the reseed output counter is reset.
+*
+* \param ctx: [struct] The DRBG state
+* \param seed: [const] The new seed material
+* \param seedlen: The length of the seed in bytes
+*/
+QSC_EXPORT_API void qsc_csx_drbg_reseed(qsc_csx_drbg_state* ctx, const uint8_t* seed, size_t seedlen);
+
 #endif
@@ -22,9 +22,17 @@
 #include "cpuidex.h"
 #include "csx.h"
 #include "csx_test.h"
+#include "equivalence_test.h"
+#include "intutils_test.h"
+#include "memutils_test.h"
+#include "nonce_test.h"
 #include "sha3_test.h"
 #include "testutils.h"
 #include <stdio.h>
+#include <stdlib.h>
+
+/* the default allowed slowdown before a benchmark row is reported as a regression */
+#define BENCHMARK_REGRESSION_THRESHOLD 0.05
 
 void print_title()
 {
@@ -39,11 +47,93 @@ void print_title()
 	qsctest_print_safe("\n");
 }
 
-int main()
+void print_usage()
+{
+	qsctest_print_line("Usage: csx [--bench <report> [csv|json]] [--compare <baseline.csv> <current.csv> [threshold]]");
+	qsctest_print_line("  --bench    run all benchmarks without prompting, and write a machine-readable report.");
+	qsctest_print_line("  --compare  compare two csv reports, the exit code is non-zero if any result regressed, is missing, or is malformed.");
+	qsctest_print_line("             the threshold is the allowed slowdown as a fraction, the default is 0.05.");
+}
+
+int run_benchmark_report(const char* path, const char* format)
+{
+	qsctest_benchmark_format fmt;
+	int ret;
+
+	ret = 1;
+	fmt = (format != NULL && strcmp(format, "json") == 0) ? qsctest_benchmark_format_json : qsctest_benchmark_format_csv;
+
+	if (qsctest_benchmark_report_open(path, fmt) == true)
+	{
+		qsctest_benchmark_csx_run();
+		qsctest_benchmark_kmac_run();
+		qsctest_benchmark_kpa_run();
+		qsctest_benchmark_shake_run();
+		qsctest_benchmark_scaling_run();
+		qsctest_benchmark_counters_run();
+		qsctest_benchmark_permutation_run();
+		qsctest_benchmark_report_close();
+		ret = 0;
+	}
+	else
+	{
+		qsctest_print_safe("The benchmark report could not be created: ");
+		qsctest_print_line(path);
+	}
+
+	return ret;
+}
+
+int run_benchmark_compare(const char* baseline, const char* current, const char* threshold)
+{
+	double thr;
+	int32_t cnt;
+	int ret;
+
+	thr = (threshold != NULL) ? atof(threshold) : BENCHMARK_REGRESSION_THRESHOLD;
+	cnt = qsctest_benchmark_compare(baseline, current, thr);
+
+	if (cnt < 0)
+	{
+		qsctest_print_line("Failure! The benchmark reports could not be read, or the current report is empty.");
+		ret = 2;
+	}
+	else if (cnt > 0)
+	{
+		qsctest_print_safe("Failure! Benchmark results regressed, missing, or malformed: ");
+		qsctest_print_ulong((uint64_t)cnt);
+		qsctest_print_line("");
+		ret = 1;
+	}
+	else
+	{
+		qsctest_print_line("Success! No benchmark results regressed.");
+		ret = 0;
+	}
+
+	return ret;
+}
+
+int main(int argc, char* argv[])
 {
 	qsc_cpuidex_cpu_features cfeat;
 	bool res;
 
+	/* non-interactive modes for automated performance tracking */
+	if (argc >= 3 && strcmp(argv[1], "--bench") == 0)
+	{
+		return run_benchmark_report(argv[2], (argc >= 4) ? argv[3] : NULL);
+	}
+	else if (argc >= 4 && strcmp(argv[1], "--compare") == 0)
+	{
+		return run_benchmark_compare(argv[2], argv[3], (argc >= 5) ? argv[4] : NULL);
+	}
+	else if (argc > 1)
+	{
+		print_usage();
+		return 2;
+	}
+
 	res = qsc_cpuidex_features_set(&cfeat);
 
 	print_title();
@@ -99,6 +189,22 @@ int main()
 		qsctest_print_safe("*** Test SHAKE, cSHAKE, KMAC, and SHA3 implementations using the official KAT vetors. *** \n");
 		qsctest_sha3_run();
 		qsctest_print_line("");
+
+		qsctest_print_safe("*** Test the SIMD backends against the scalar reference implementations. *** \n");
+		qsctest_equivalence_run();
+		qsctest_print_line("");
+
+		qsctest_print_safe("*** Test the constant-time tag compare functions for correctness and data-independent timing. *** \n");
+		qsctest_intutils_run();
+		qsctest_print_line("");
+
+		qsctest_print_safe("*** Test the secure arena for object reuse, private free-list spills, and reclaim. *** \n");
+		qsctest_memutils_run();
+		qsctest_print_line("");
+
+		qsctest_print_safe("*** Test the nonce allocator for collisions under concurrent allocation, and across restarts. *** \n");
+		qsctest_nonce_run();
+		qsctest_print_line("");
 	}
 
 	if (qsctest_test_confirm("Press 'Y' then Enter to run Symmetric Cipher Speed Tests, any other key to cancel: ") == true)
@@ -364,6 +364,179 @@ bool qsctest_csx_wide_equality()
 }
 #endif
 
+/* a mix of buffered and direct request sizes, including the buffer and rekey interval boundaries */
+static const size_t csx_drbg_lengths[] = { 1, 16, 1000, 1023, 1024, 4096, 65536, 65537, 16, 200000, 7 };
+
+static bool csx_drbg_is_zero(const uint8_t* input, size_t length)
+{
+	uint8_t acc;
+
+	acc = 0;
+
+	for (size_t i = 0; i < length; ++i)
+	{
+		acc |= input[i];
+	}
+
+	return (acc == 0);
+}
+
+static bool csx_drbg_sequence(qsc_csx_drbg_state* ctx, uint8_t* output)
+{
+	size_t oft;
+	bool res;
+
+	oft = 0;
+	res = true;
+
+	for (size_t i = 0; i < sizeof(csx_drbg_lengths) / sizeof(size_t) && res == true; ++i)
+	{
+		res = qsc_csx_drbg_generate(ctx, output + oft, csx_drbg_lengths[i]);
+		oft += csx_drbg_lengths[i];
+	}
+
+	return res;
+}
+
+bool qsctest_csx_drbg()
+{
+	const size_t OUTLEN = 1024 * 1024;
+	const uint8_t INFO[] = { 0x74, 0x65, 0x73, 0x74 };
+	qsc_csx_drbg_state ctx1;
+	qsc_csx_drbg_state ctx2;
+	uint8_t seed[QSC_CSX_DRBG_SEED_MIN] = { 0 };
+	uint8_t* out1;
+	uint8_t* out2;
+	uint64_t key[QSC_CSX_KEY_SIZE / sizeof(uint64_t)];
+	uint64_t ones;
+	size_t seqlen;
+	bool res;
+
+	res = false;
+	seqlen = 0;
+
+	for (size_t i = 0; i < sizeof(csx_drbg_lengths) / sizeof(size_t); ++i)
+	{
+		seqlen += csx_drbg_lengths[i];
+	}
+
+	out1 = (uint8_t*)qsc_memutils_malloc(OUTLEN);
+	out2 = (uint8_t*)qsc_memutils_malloc(OUTLEN);
+
+	if (out1 != NULL && out2 != NULL)
+	{
+		res = true;
+		qsc_csp_generate(seed, sizeof(seed));
+
+		/* the same seed and request sizes produce the same output */
+		qsc_csx_drbg_instantiate(&ctx1, seed, sizeof(seed), NULL, 0);
+		qsc_csx_drbg_instantiate(&ctx2, seed, sizeof(seed), NULL, 0);
+
+		if (csx_drbg_sequence(&ctx1, out1) == false || csx_drbg_sequence(&ctx2, out2) == false ||
+			qsc_intutils_are_equal8(out1, out2, seqlen) == false)
+		{
+			qsctest_print_safe("Failure! qsctest_csx_drbg: the output is not repeatable -CD1 \n");
+			res = false;
+		}
+
+		/* returned bytes are erased from the buffer, and the key is replaced on every refill and large request */
+		qsc_csx_drbg_instantiate(&ctx1, seed, sizeof(seed), NULL, 0);
+		qsc_memutils_copy((uint8_t*)key, (uint8_t*)ctx1.cstate.state, sizeof(key));
+		qsc_csx_drbg_generate(&ctx1, out1, 16);
+
+		if (ctx1.position != QSC_CSX_DRBG_BUFFER_SIZE - 16 || csx_drbg_is_zero(ctx1.buffer + ctx1.position, 16) == false ||
+			qsc_intutils_are_equal8((uint8_t*)key, (uint8_t*)ctx1.cstate.state, sizeof(key)) == true)
+		{
+			qsctest_print_safe("Failure! qsctest_csx_drbg: returned output or the old key remains in the state -CD2 \n");
+			res = false;
+		}
+
+		qsc_memutils_copy((uint8_t*)key, (uint8_t*)ctx1.cstate.state, sizeof(key));
+		qsc_csx_drbg_generate(&ctx1, out1, QSC_CSX_DRBG_BUFFER_SIZE);
+
+		if (qsc_intutils_are_equal8((uint8_t*)key, (uint8_t*)ctx1.cstate.state, sizeof(key)) == true)
+		{
+			qsctest_print_safe("Failure! qsctest_csx_drbg: the key was not replaced after a request -CD3 \n");
+			res = false;
+		}
+
+		/* a personalization string or a reseed separates two generators with the same seed */
+		qsc_csx_drbg_instantiate(&ctx1, seed, sizeof(seed), NULL, 0);
+		qsc_csx_drbg_instantiate(&ctx2, seed, sizeof(seed), INFO, sizeof(INFO));
+		qsc_csx_drbg_generate(&ctx1, out1, 64);
+		qsc_csx_drbg_generate(&ctx2, out2, 64);
+
+		if (qsc_intutils_are_equal8(out1, out2, 64) == true)
+		{
+			qsctest_print_safe("Failure! qsctest_csx_drbg: the personalization string is not applied -CD4 \n");
+			res = false;
+		}
+
+		qsc_csx_drbg_instantiate(&ctx2, seed, sizeof(seed), NULL, 0);
+		qsc_csx_drbg_generate(&ctx2, out2, 64);
+		qsc_csx_drbg_reseed(&ctx2, seed, sizeof(seed));
+		qsc_csx_drbg_generate(&ctx1, out1, 64);
+		qsc_csx_drbg_generate(&ctx2, out2, 64);
+
+		if (qsc_intutils_are_equal8(out1, out2, 64) == true)
+		{
+			qsctest_print_safe("Failure! qsctest_csx_drbg: the reseed is not applied -CD5 \n");
+			res = false;
+		}
+
+		/* the generator refuses to output past the reseed limit, until it is reseeded */
+		ctx1.generated = QSC_CSX_DRBG_RESEED_MAX - 16;
+
+		if (qsc_csx_drbg_generate(&ctx1, out1, 16) == false || qsc_csx_drbg_generate(&ctx1, out1, 1) == true)
+		{
+			qsctest_print_safe("Failure! qsctest_csx_drbg: the reseed limit is not enforced -CD6 \n");
+			res = false;
+		}
+
+		qsc_csx_drbg_reseed(&ctx1, seed, sizeof(seed));
+
+		/* a large request is balanced to within about six standard deviations */
+		if (qsc_csx_drbg_generate(&ctx1, out1, OUTLEN) == true)
+		{
+			ones = 0;
+
+			for (size_t i = 0; i < OUTLEN; ++i)
+			{
+				for (uint8_t x = out1[i]; x != 0; x &= (uint8_t)(x - 1))
+				{
+					++ones;
+				}
+			}
+
+			if (ones < (OUTLEN * 4) - 16384 || ones > (OUTLEN * 4) + 16384)
+			{
+				qsctest_print_safe("Failure! qsctest_csx_drbg: the output bits are not balanced -CD7 \n");
+				res = false;
+			}
+		}
+		else
+		{
+			qsctest_print_safe("Failure! qsctest_csx_drbg: the generator did not accept a reseed -CD8 \n");
+			res = false;
+		}
+
+		qsc_csx_drbg_dispose(&ctx1);
+		qsc_csx_drbg_dispose(&ctx2);
+	}
+
+	if (out1 != NULL)
+	{
+		qsc_memutils_alloc_free(out1);
+	}
+
+	if (out2 != NULL)
+	{
+		qsc_memutils_alloc_free(out2);
+	}
+
+	return res;
+}
+
 void qsctest_csx_run()
 {
 	if (qsctest_csx512_kat() == true)
@@ -384,6 +557,15 @@ void qsctest_csx_run()
 		qsctest_print_safe("Failure! Failed the CSX stress tests. \n");
 	}
 
+	if (qsctest_csx_drbg() == true)
+	{
+		qsctest_print_safe("Success! Passed the CSX DRBG tests. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the CSX DRBG tests. \n");
+	}
+
 #if defined(QSCTEST_CSX_WIDE_BLOCK_TESTS)
 	if (qsctest_csx_wide_equality() == true)
 	{
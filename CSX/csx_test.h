@@ -50,6 +50,14 @@ bool qsctest_csx512_stress(void);
 bool qsctest_csx_wide_equality(void);
 #endif
 
+/**
+* \brief Tests the CSX-512 DRBG for repeatable output from a seed, for separation by personalization string and reseed,
+* for erasure of the returned buffered bytes and the key, for the reseed limit, and for balanced output bits.
+*
+* \return Returns true for success
+*/
+bool qsctest_csx_drbg(void);
+
 /**
 * \brief Run all tests.
 */
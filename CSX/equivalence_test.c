@@ -0,0 +1,443 @@
+#include "equivalence_test.h"
+#include "csp.h"
+#include "csx.h"
+#include "intutils.h"
+#include "memutils.h"
+#include "sha3.h"
+#include "testutils.h"
+#if defined(QSC_SYSTEM_HAS_AVX2)
+#	include "intrinsics.h"
+#endif
+#if defined(QSCTEST_FUZZ_TARGET)
+#	include <stdlib.h>
+#endif
+
+/* the buffer misalignments are 0 to EQUIVALENCE_ALIGN - 1 bytes */
+#define EQUIVALENCE_ALIGN 64
+#define EQUIVALENCE_MESSAGE_MAX 131072
+#define EQUIVALENCE_CHUNK_BYTES 32
+#define EQUIVALENCE_KECCAK_LANES 8
+
+/* the width of the widest csx kernel in the build */
+#if defined(QSC_SYSTEM_HAS_AVX512)
+#	define EQUIVALENCE_BATCH (8 * QSC_CSX_BLOCK_SIZE)
+#elif defined(QSC_SYSTEM_HAS_AVX2)
+#	define EQUIVALENCE_BATCH (4 * QSC_CSX_BLOCK_SIZE)
+#else
+#	define EQUIVALENCE_BATCH QSC_CSX_BLOCK_SIZE
+#endif
+
+/* the test case parameters derived from the seed */
+#define EQUIVALENCE_KEY_OFFSET 0
+#define EQUIVALENCE_NONCE_OFFSET (EQUIVALENCE_KEY_OFFSET + QSC_CSX_KEY_SIZE)
+#define EQUIVALENCE_LENGTH_OFFSET (EQUIVALENCE_NONCE_OFFSET + QSC_CSX_NONCE_SIZE)
+#define EQUIVALENCE_ALIGN_OFFSET (EQUIVALENCE_LENGTH_OFFSET + 4)
+#define EQUIVALENCE_CHUNK_OFFSET (EQUIVALENCE_ALIGN_OFFSET + 4)
+#define EQUIVALENCE_PARAMS_SIZE (EQUIVALENCE_CHUNK_OFFSET + EQUIVALENCE_CHUNK_BYTES)
+
+static const size_t equivalence_edges[] =
+{
+	0, 1,
+	QSC_CSX_BLOCK_SIZE - 1, QSC_CSX_BLOCK_SIZE, QSC_CSX_BLOCK_SIZE + 1,
+	EQUIVALENCE_BATCH - 1, EQUIVALENCE_BATCH, EQUIVALENCE_BATCH + 1,
+	(2 * EQUIVALENCE_BATCH) - 1, (2 * EQUIVALENCE_BATCH) + 1,
+	(8 * QSC_CSX_BLOCK_SIZE) + QSC_CSX_BLOCK_SIZE - 1
+};
+
+#define EQUIVALENCE_EDGE_COUNT (sizeof(equivalence_edges) / sizeof(size_t))
+
+static size_t equivalence_length(const uint8_t* sel)
+{
+	size_t idx;
+	size_t len;
+	size_t tile;
+
+#if defined(QSC_CSX_AUTHENTICATED)
+	tile = qsc_csx_tile_size();
+#else
+	tile = EQUIVALENCE_BATCH;
+#endif
+
+	if (sel[0] < 160)
+	{
+		/* the block, batch, and tile boundaries */
+		idx = sel[1] % (EQUIVALENCE_EDGE_COUNT + 4);
+
+		if (idx < EQUIVALENCE_EDGE_COUNT)
+		{
+			len = equivalence_edges[idx];
+		}
+		else
+		{
+			idx -= EQUIVALENCE_EDGE_COUNT;
+			len = (idx == 0) ? tile - 1 : (idx == 1) ? tile : (idx == 2) ? tile + 1 : (2 * tile) + 1;
+		}
+	}
+	else
+	{
+		len = ((size_t)sel[1] | ((size_t)sel[2] << 8) | ((size_t)sel[3] << 16)) % (EQUIVALENCE_MESSAGE_MAX + 1);
+	}
+
+	return qsc_intutils_min(len, EQUIVALENCE_MESSAGE_MAX);
+}
+
+static size_t equivalence_chunk(const uint8_t* prm, size_t index, size_t remaining)
+{
+	size_t len;
+
+	/* chunk lengths of 1 to 2 batches + 1, which cross every block and batch boundary */
+	len = 1 + (qsc_intutils_le8to16(prm + EQUIVALENCE_CHUNK_OFFSET + ((index * 2) % EQUIVALENCE_CHUNK_BYTES)) % ((2 * EQUIVALENCE_BATCH) + 1));
+
+	return qsc_intutils_min(len, remaining);
+}
+
+static void equivalence_csx_reference(const uint64_t* state, uint8_t* output, const uint8_t* input, size_t length)
+{
+	uint64_t ctr[QSC_CSX_STATE_SIZE];
+	uint8_t blk[QSC_CSX_BLOCK_SIZE];
+	size_t i;
+	size_t oft;
+	size_t rmd;
+
+	qsc_memutils_copy(ctr, state, sizeof(ctr));
+	oft = 0;
+
+	/* one block at a time with the scalar permutation */
+	while (length != 0)
+	{
+		qsc_csx_permute_p1024c(ctr, blk);
+		rmd = qsc_intutils_min(length, QSC_CSX_BLOCK_SIZE);
+
+		for (i = 0; i < rmd; ++i)
+		{
+			output[oft + i] = input[oft + i] ^ blk[i];
+		}
+
+		++ctr[12];
+
+		if (ctr[12] == 0)
+		{
+			++ctr[13];
+		}
+
+		oft += rmd;
+		length -= rmd;
+	}
+}
+
+static bool equivalence_csx_chunked(const uint8_t* prm, uint8_t* output, const uint8_t* input, uint8_t* reference, size_t length, bool encryption)
+{
+	uint8_t nonce[QSC_CSX_NONCE_SIZE];
+	qsc_csx_state ctx;
+	size_t blk;
+	size_t idx;
+	size_t oft;
+	bool res;
+
+	qsc_memutils_copy(nonce, prm + EQUIVALENCE_NONCE_OFFSET, sizeof(nonce));
+	qsc_csx_keyparams kp = { prm + EQUIVALENCE_KEY_OFFSET, QSC_CSX_KEY_SIZE, nonce, NULL, 0 };
+
+	qsc_csx_initialize(&ctx, &kp, encryption);
+	idx = 0;
+	oft = 0;
+	res = true;
+
+	/* the final call finalizes the mac; a zero length message is a single finalizing call */
+	do
+	{
+		blk = equivalence_chunk(prm, idx, length - oft);
+
+		/* every call starts the key-stream at a new block */
+		if (reference != NULL)
+		{
+			equivalence_csx_reference(ctx.state, reference + oft, input + oft, blk);
+		}
+
+		res = qsc_csx_extended_transform(&ctx, output + oft, input + oft, blk, (oft + blk == length)) && res;
+		oft += blk;
+		++idx;
+	}
+	while (oft < length);
+
+	qsc_csx_dispose(&ctx);
+
+	return res;
+}
+
+bool qsctest_equivalence_csx(const uint8_t* seed, size_t seedlen)
+{
+	const uint8_t EMPTY[1] = { 0 };
+	uint8_t prm[EQUIVALENCE_PARAMS_SIZE];
+	uint8_t nonce[QSC_CSX_NONCE_SIZE];
+	qsc_csx_state ctx;
+	uint8_t* dbuf;
+	uint8_t* dec;
+	uint8_t* ebuf;
+	uint8_t* enc;
+	uint8_t* mbuf;
+	uint8_t* msg;
+	uint8_t* ref;
+	size_t mlen;
+	bool res;
+
+	res = false;
+
+	if (seed == NULL)
+	{
+		seed = EMPTY;
+		seedlen = 0;
+	}
+
+	qsc_shake256_compute(prm, sizeof(prm), seed, seedlen);
+	mlen = equivalence_length(prm + EQUIVALENCE_LENGTH_OFFSET);
+
+	mbuf = (uint8_t*)qsc_memutils_malloc(mlen + EQUIVALENCE_ALIGN);
+	ebuf = (uint8_t*)qsc_memutils_malloc(mlen + QSC_CSX_MAC_SIZE + EQUIVALENCE_ALIGN);
+	dbuf = (uint8_t*)qsc_memutils_malloc(mlen + QSC_CSX_MAC_SIZE + EQUIVALENCE_ALIGN);
+	ref = (uint8_t*)qsc_memutils_malloc(mlen + QSC_CSX_MAC_SIZE);
+
+	if (mbuf != NULL && ebuf != NULL && dbuf != NULL && ref != NULL)
+	{
+		/* independent misalignments of the input, output, and in-place buffers */
+		msg = mbuf + (prm[EQUIVALENCE_ALIGN_OFFSET] % EQUIVALENCE_ALIGN);
+		enc = ebuf + (prm[EQUIVALENCE_ALIGN_OFFSET + 1] % EQUIVALENCE_ALIGN);
+		dec = dbuf + (prm[EQUIVALENCE_ALIGN_OFFSET + 2] % EQUIVALENCE_ALIGN);
+
+		if (mlen != 0)
+		{
+			qsc_shake256_compute(msg, mlen, prm, sizeof(prm));
+		}
+
+		qsc_memutils_copy(nonce, prm + EQUIVALENCE_NONCE_OFFSET, sizeof(nonce));
+		qsc_csx_keyparams kp = { prm + EQUIVALENCE_KEY_OFFSET, QSC_CSX_KEY_SIZE, nonce, NULL, 0 };
+
+		/* the reference cipher-text, and the one-shot transform of unaligned buffers */
+		qsc_csx_initialize(&ctx, &kp, true);
+		equivalence_csx_reference(ctx.state, ref, msg, mlen);
+		qsc_csx_transform(&ctx, enc, msg, mlen);
+		qsc_csx_dispose(&ctx);
+		res = qsc_intutils_are_equal8(enc, ref, mlen);
+
+#if defined(QSC_CSX_AUTHENTICATED)
+		/* the one-shot mac code is the reference for the other single call modes */
+		qsc_memutils_copy(ref + mlen, enc + mlen, QSC_CSX_MAC_SIZE);
+#endif
+
+		/* in-place encryption */
+		qsc_memutils_copy(dec, msg, mlen);
+		qsc_memutils_copy(nonce, prm + EQUIVALENCE_NONCE_OFFSET, sizeof(nonce));
+		qsc_csx_initialize(&ctx, &kp, true);
+		qsc_csx_transform(&ctx, dec, dec, mlen);
+		qsc_csx_dispose(&ctx);
+
+#if defined(QSC_CSX_AUTHENTICATED)
+		res = qsc_intutils_are_equal8(dec, ref, mlen + QSC_CSX_MAC_SIZE) && res;
+
+		/* one-shot decryption in-place, and rejection of a modified mac code */
+		qsc_memutils_copy(nonce, prm + EQUIVALENCE_NONCE_OFFSET, sizeof(nonce));
+		qsc_csx_initialize(&ctx, &kp, false);
+		res = qsc_csx_transform(&ctx, dec, dec, mlen) && res;
+		qsc_csx_dispose(&ctx);
+		res = qsc_intutils_are_equal8(dec, msg, mlen) && res;
+
+		qsc_memutils_copy(dec, ref, mlen + QSC_CSX_MAC_SIZE);
+		dec[mlen] ^= 0x01U;
+		qsc_memutils_copy(nonce, prm + EQUIVALENCE_NONCE_OFFSET, sizeof(nonce));
+		qsc_csx_initialize(&ctx, &kp, false);
+		res = (qsc_csx_transform(&ctx, dec, dec, mlen) == false) && res;
+		qsc_csx_dispose(&ctx);
+
+		/* the smallest transform tile interleaves the key-stream and mac one batch at a time */
+		size_t tile = qsc_csx_tile_size();
+		qsc_csx_tile_set(1);
+		qsc_memutils_copy(nonce, prm + EQUIVALENCE_NONCE_OFFSET, sizeof(nonce));
+		qsc_csx_initialize(&ctx, &kp, true);
+		qsc_csx_transform(&ctx, enc, msg, mlen);
+		qsc_csx_dispose(&ctx);
+		qsc_csx_tile_set(tile);
+		res = qsc_intutils_are_equal8(enc, ref, mlen + QSC_CSX_MAC_SIZE) && res;
+#else
+		res = qsc_intutils_are_equal8(dec, ref, mlen) && res;
+#endif
+
+		/* chunked extended calls, the chunked mac code differs and is checked by decryption */
+		res = equivalence_csx_chunked(prm, enc, msg, ref, mlen, true) && res;
+		res = qsc_intutils_are_equal8(enc, ref, mlen) && res;
+		res = equivalence_csx_chunked(prm, dec, enc, NULL, mlen, false) && res;
+		res = qsc_intutils_are_equal8(dec, msg, mlen) && res;
+	}
+
+	if (mbuf != NULL)
+	{
+		qsc_memutils_alloc_free(mbuf);
+	}
+
+	if (ebuf != NULL)
+	{
+		qsc_memutils_alloc_free(ebuf);
+	}
+
+	if (dbuf != NULL)
+	{
+		qsc_memutils_alloc_free(dbuf);
+	}
+
+	if (ref != NULL)
+	{
+		qsc_memutils_alloc_free(ref);
+	}
+
+	return res;
+}
+
+bool qsctest_equivalence_keccak(const uint8_t* seed, size_t seedlen)
+{
+	const uint8_t EMPTY[1] = { 0 };
+	uint8_t prm[(EQUIVALENCE_KECCAK_LANES * QSC_KECCAK_STATE_SIZE * sizeof(uint64_t)) + 1];
+	uint64_t ref[EQUIVALENCE_KECCAK_LANES][QSC_KECCAK_STATE_SIZE];
+	uint64_t tmp[QSC_KECCAK_STATE_SIZE];
+	size_t i;
+	size_t j;
+#if defined(QSC_SYSTEM_HAS_AVX2)
+	size_t rounds;
+#endif
+	bool res;
+
+	res = true;
+
+	if (seed == NULL)
+	{
+		seed = EMPTY;
+		seedlen = 0;
+	}
+
+	qsc_shake256_compute(prm, sizeof(prm), seed, seedlen);
+#if defined(QSC_SYSTEM_HAS_AVX2)
+	/* the reduced round count used by kmac-r12, or the full permutation */
+	rounds = ((prm[sizeof(prm) - 1] & 0x01U) != 0) ? QSC_KECCAK_PERMUTATION_MIN_ROUNDS : QSC_KECCAK_PERMUTATION_ROUNDS;
+#endif
+
+	for (i = 0; i < EQUIVALENCE_KECCAK_LANES; ++i)
+	{
+		for (j = 0; j < QSC_KECCAK_STATE_SIZE; ++j)
+		{
+			ref[i][j] = qsc_intutils_le8to64(prm + (((i * QSC_KECCAK_STATE_SIZE) + j) * sizeof(uint64_t)));
+		}
+	}
+
+#if defined(QSC_SYSTEM_HAS_AVX2)
+	{
+		__m256i st4[QSC_KECCAK_STATE_SIZE];
+		QSC_ALIGN(32) uint64_t out4[4];
+
+		for (j = 0; j < QSC_KECCAK_STATE_SIZE; ++j)
+		{
+			st4[j] = _mm256_set_epi64x((int64_t)ref[3][j], (int64_t)ref[2][j], (int64_t)ref[1][j], (int64_t)ref[0][j]);
+		}
+
+		qsc_keccak_permute_p4x1600(st4, rounds);
+
+		for (i = 0; i < 4; ++i)
+		{
+			qsc_memutils_copy(tmp, ref[i], sizeof(tmp));
+			qsc_keccak_permute_p1600c(tmp, rounds);
+
+			for (j = 0; j < QSC_KECCAK_STATE_SIZE; ++j)
+			{
+				_mm256_store_si256((__m256i*)out4, st4[j]);
+				res = (out4[i] == tmp[j]) && res;
+			}
+		}
+	}
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+	{
+		__m512i st8[QSC_KECCAK_STATE_SIZE];
+		QSC_ALIGN(64) uint64_t out8[8];
+
+		for (j = 0; j < QSC_KECCAK_STATE_SIZE; ++j)
+		{
+			st8[j] = _mm512_set_epi64((int64_t)ref[7][j], (int64_t)ref[6][j], (int64_t)ref[5][j], (int64_t)ref[4][j],
+				(int64_t)ref[3][j], (int64_t)ref[2][j], (int64_t)ref[1][j], (int64_t)ref[0][j]);
+		}
+
+		qsc_keccak_permute_p8x1600(st8, rounds);
+
+		for (i = 0; i < 8; ++i)
+		{
+			qsc_memutils_copy(tmp, ref[i], sizeof(tmp));
+			qsc_keccak_permute_p1600c(tmp, rounds);
+
+			for (j = 0; j < QSC_KECCAK_STATE_SIZE; ++j)
+			{
+				_mm512_store_si512((__m512i*)out8, st8[j]);
+				res = (out8[i] == tmp[j]) && res;
+			}
+		}
+	}
+#endif
+
+	/* the unrolled permutation is fixed at 24 rounds */
+	qsc_memutils_copy(tmp, ref[0], sizeof(tmp));
+	qsc_keccak_permute_p1600c(tmp, QSC_KECCAK_PERMUTATION_ROUNDS);
+	qsc_keccak_permute_p1600u(ref[0]);
+	res = qsc_intutils_are_equal8((const uint8_t*)tmp, (const uint8_t*)ref[0], sizeof(tmp)) && res;
+
+	return res;
+}
+
+#if defined(QSCTEST_FUZZ_TARGET)
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	if (qsctest_equivalence_csx(data, size) == false || qsctest_equivalence_keccak(data, size) == false)
+	{
+		abort();
+	}
+
+	return 0;
+}
+#endif
+
+static bool equivalence_random(bool (*test)(const uint8_t*, size_t))
+{
+	uint8_t seed[QSCTEST_EQUIVALENCE_SEED_SIZE];
+	size_t i;
+	bool res;
+
+	res = true;
+
+	for (i = 0; i < QSCTEST_EQUIVALENCE_CYCLES; ++i)
+	{
+		qsc_csp_generate(seed, sizeof(seed));
+
+		if (test(seed, sizeof(seed)) == false)
+		{
+			res = false;
+			break;
+		}
+	}
+
+	return res;
+}
+
+void qsctest_equivalence_run()
+{
+	if (equivalence_random(qsctest_equivalence_csx) == true)
+	{
+		qsctest_print_safe("Success! Passed the CSX backend equivalence test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the CSX backend equivalence test. \n");
+	}
+
+	if (equivalence_random(qsctest_equivalence_keccak) == true)
+	{
+		qsctest_print_safe("Success! Passed the Keccak backend equivalence test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the Keccak backend equivalence test. \n");
+	}
+}
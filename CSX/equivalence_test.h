@@ -0,0 +1,69 @@
+/**
+* \file equivalence_test.h
+* \brief <b>Differential backend equivalence tests</b> \n
+* Compares every SIMD backend compiled into the build with the scalar reference implementation. \n
+* The CSX transform output is compared to a key-stream generated with the scalar permutation, using block and batch
+* edge-case message lengths, unaligned and in-place buffers, the smallest transform tile, and chunked extended calls.
+* The x4 and x8 Keccak permutations, and the unrolled permutation, are compared lane by lane with the compact scalar permutation.
+*
+* \par
+* Every test case is derived from a seed, so the same functions serve as a libFuzzer target.
+* Define QSCTEST_FUZZ_TARGET, and build all of the source files except csx_main.c, for example: \n
+* clang -g -O1 -fsanitize=fuzzer,address -mavx512f -mavx512bw -mavx512dq -mavx512vl -mavx2 -DQSCTEST_FUZZ_TARGET $(ls *.c | grep -v csx_main.c) -o csx_fuzz
+*/
+
+#ifndef QSCTEST_EQUIVALENCE_TEST_H
+#define QSCTEST_EQUIVALENCE_TEST_H
+
+#include "common.h"
+
+/*!
+* \def QSCTEST_EQUIVALENCE_CYCLES
+* \brief The number of random test cases run by each equivalence test
+*/
+#define QSCTEST_EQUIVALENCE_CYCLES 200
+
+/*!
+* \def QSCTEST_EQUIVALENCE_SEED_SIZE
+* \brief The byte size of the random seed used to derive a test case
+*/
+#define QSCTEST_EQUIVALENCE_SEED_SIZE 32
+
+/**
+* \brief Compare the CSX transform with the scalar reference key-stream, in every calling mode, for one test case.
+* The key, nonce, message, message length, buffer alignments, and chunk sizes are derived from the seed.
+*
+* \param seed: [const] The test case seed
+* \param seedlen: The length of the seed in bytes, may be zero
+* \return Returns true if every output matches the reference
+*/
+bool qsctest_equivalence_csx(const uint8_t* seed, size_t seedlen);
+
+/**
+* \brief Compare the available Keccak permutation backends with the compact scalar permutation for one test case.
+* The states and the number of rounds are derived from the seed.
+*
+* \param seed: [const] The test case seed
+* \param seedlen: The length of the seed in bytes, may be zero
+* \return Returns true if every lane matches the reference
+*/
+bool qsctest_equivalence_keccak(const uint8_t* seed, size_t seedlen);
+
+#if defined(QSCTEST_FUZZ_TARGET)
+/**
+* \brief The libFuzzer entry point, runs the CSX and Keccak equivalence tests with the fuzzer input as the seed.
+* A mismatch aborts the process, which the fuzzer reports as a crash.
+*
+* \param data: [const] The fuzzer input
+* \param size: The length of the fuzzer input
+* \return Returns zero
+*/
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+#endif
+
+/**
+* \brief Run all tests.
+*/
+void qsctest_equivalence_run(void);
+
+#endif
@@ -108,6 +108,62 @@ void qsc_intutils_bswap64(uint64_t* destination, const uint64_t* source, size_t
 }
 #endif
 
+static uint64_t intutils_bswap64(uint64_t value)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	return _byteswap_uint64(value);
+#elif defined(QSC_SYSTEM_COMPILER_GCC)
+	return __builtin_bswap64(value);
+#else
+	value = ((value & 0x00FF00FF00FF00FFULL) << 8) | ((value >> 8) & 0x00FF00FF00FF00FFULL);
+	value = ((value & 0x0000FFFF0000FFFFULL) << 16) | ((value >> 16) & 0x0000FFFF0000FFFFULL);
+
+	return (value << 32) | (value >> 32);
+#endif
+}
+
+void qsc_intutils_bswap64_array(uint64_t* destination, const uint64_t* source, size_t count)
+{
+	assert(destination != NULL);
+	assert(source != NULL);
+
+	size_t i;
+
+	i = 0;
+
+	if (destination != NULL && source != NULL)
+	{
+#if defined(QSC_SYSTEM_HAS_AVX512)
+		const __m512i MASK512 = _mm512_set_epi8(
+			56, 57, 58, 59, 60, 61, 62, 63, 48, 49, 50, 51, 52, 53, 54, 55,
+			40, 41, 42, 43, 44, 45, 46, 47, 32, 33, 34, 35, 36, 37, 38, 39,
+			24, 25, 26, 27, 28, 29, 30, 31, 16, 17, 18, 19, 20, 21, 22, 23,
+			8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+
+		/* vpshufb reverses the bytes within each 128-bit lane, the indices are relative to the lane */
+		for (; i + 8 <= count; i += 8)
+		{
+			_mm512_storeu_si512((__m512i*)(destination + i), _mm512_shuffle_epi8(_mm512_loadu_si512((const __m512i*)(source + i)), MASK512));
+		}
+#endif
+#if defined(QSC_SYSTEM_HAS_AVX2)
+		const __m256i MASK256 = _mm256_set_epi8(
+			8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7,
+			8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			_mm256_storeu_si256((__m256i*)(destination + i), _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(source + i)), MASK256));
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			destination[i] = intutils_bswap64(source[i]);
+		}
+	}
+}
+
 void qsc_intutils_clear8(uint8_t* a, size_t count)
 {
 	for (size_t i = 0; i < count; ++i)
@@ -282,6 +338,20 @@ uint64_t qsc_intutils_le8to64(const uint8_t* input)
 		((uint64_t)input[7] << 56);
 }
 
+void qsc_intutils_le8to64_array(uint64_t* output, const uint8_t* input, size_t count)
+{
+	assert(output != NULL);
+	assert(input != NULL);
+
+	if (output != NULL && input != NULL)
+	{
+		qsc_memutils_copy((uint8_t*)output, input, count * sizeof(uint64_t));
+#if defined(QSC_SYSTEM_IS_BIG_ENDIAN)
+		qsc_intutils_bswap64_array(output, output, count);
+#endif
+	}
+}
+
 void qsc_intutils_le16to8(uint8_t* output, uint16_t value)
 {
 	output[0] = (uint8_t)value & 0xFFU;
@@ -308,6 +378,20 @@ void qsc_intutils_le64to8(uint8_t* output, uint64_t value)
 	output[7] = (uint8_t)(value >> 56) & 0xFFU;
 }
 
+void qsc_intutils_le64to8_array(uint8_t* output, const uint64_t* input, size_t count)
+{
+	assert(output != NULL);
+	assert(input != NULL);
+
+	if (output != NULL && input != NULL)
+	{
+		qsc_memutils_copy(output, (const uint8_t*)input, count * sizeof(uint64_t));
+#if defined(QSC_SYSTEM_IS_BIG_ENDIAN)
+		qsc_intutils_bswap64_array((uint64_t*)output, (const uint64_t*)output, count);
+#endif
+	}
+}
+
 size_t qsc_intutils_max(size_t a, size_t b)
 {
 	return (a > b) ? a : b;
@@ -360,16 +444,136 @@ uint64_t qsc_intutils_rotr64(uint64_t value, size_t shift)
 	return (value >> shift) | (value << ((sizeof(uint64_t) * 8) - shift));
 }
 
-int32_t qsc_intutils_verify(const uint8_t* a, const uint8_t* b, size_t length)
+static uint64_t intutils_verify_difference(const uint8_t* a, const uint8_t* b, size_t length)
 {
-	uint16_t d;
+	uint64_t d;
+	size_t pos;
 
 	d = 0;
+	pos = 0;
 
-	for (size_t i = 0; i < length; ++i)
+	/* the differences are accumulated, and reduced once; nothing branches on the data */
+#if defined(QSC_SYSTEM_HAS_AVX512)
+	if (length >= 64)
+	{
+		__m512i acc512 = _mm512_setzero_si512();
+
+		while (length - pos >= 64)
+		{
+			acc512 = _mm512_or_si512(acc512, _mm512_xor_si512(_mm512_loadu_si512((const __m512i*)(a + pos)), _mm512_loadu_si512((const __m512i*)(b + pos))));
+			pos += 64;
+		}
+
+		d |= (uint64_t)_mm512_test_epi64_mask(acc512, acc512);
+	}
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX2)
+	if (length - pos >= 32)
+	{
+		__m256i acc256 = _mm256_setzero_si256();
+
+		while (length - pos >= 32)
+		{
+			acc256 = _mm256_or_si256(acc256, _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + pos)), _mm256_loadu_si256((const __m256i*)(b + pos))));
+			pos += 32;
+		}
+
+		d |= (uint64_t)(1 - _mm256_testz_si256(acc256, acc256));
+	}
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX)
+	if (length - pos >= 16)
 	{
-		d |= (uint16_t)(a[i] ^ b[i]);
+		__m128i acc128 = _mm_setzero_si128();
+
+		while (length - pos >= 16)
+		{
+			acc128 = _mm_or_si128(acc128, _mm_xor_si128(_mm_loadu_si128((const __m128i*)(a + pos)), _mm_loadu_si128((const __m128i*)(b + pos))));
+			pos += 16;
+		}
+
+		d |= (uint64_t)(1 - _mm_testz_si128(acc128, acc128));
+	}
+#endif
+
+	for (; pos < length; ++pos)
+	{
+		d |= (uint64_t)(a[pos] ^ b[pos]);
+	}
+
+	return d;
+}
+
+static int32_t intutils_verify_result(uint64_t d)
+{
+	/* the high bit of d | -d is set only if d is non-zero; zero if equal, otherwise -1 */
+	return (int32_t)(0U - (uint32_t)((d | (0U - d)) >> 63));
+}
+
+int32_t qsc_intutils_verify(const uint8_t* a, const uint8_t* b, size_t length)
+{
+	int32_t res;
+
+	/* the length is public, so selecting a kernel by it does not leak */
+	if (length == 16)
+	{
+		res = qsc_intutils_verify16(a, b);
+	}
+	else if (length == 32)
+	{
+		res = qsc_intutils_verify32(a, b);
+	}
+	else if (length == 64)
+	{
+		res = qsc_intutils_verify64(a, b);
+	}
+	else
+	{
+		res = intutils_verify_result(intutils_verify_difference(a, b, length));
+	}
+
+	return res;
+}
+
+int32_t qsc_intutils_verify16(const uint8_t* a, const uint8_t* b)
+{
+	return intutils_verify_result(intutils_verify_difference(a, b, 16));
+}
+
+int32_t qsc_intutils_verify32(const uint8_t* a, const uint8_t* b)
+{
+	return intutils_verify_result(intutils_verify_difference(a, b, 32));
+}
+
+int32_t qsc_intutils_verify64(const uint8_t* a, const uint8_t* b)
+{
+	return intutils_verify_result(intutils_verify_difference(a, b, 64));
+}
+
+uint64_t qsc_intutils_verify_batch(const uint8_t* a, const uint8_t* b, size_t taglen, size_t count)
+{
+	assert(a != NULL);
+	assert(b != NULL);
+	assert(count <= QSC_INTUTILS_VERIFY_BATCH_MAX);
+
+	uint64_t mask;
+	int32_t res;
+
+	mask = 0;
+
+	if (a != NULL && b != NULL)
+	{
+		count = (count <= QSC_INTUTILS_VERIFY_BATCH_MAX) ? count : QSC_INTUTILS_VERIFY_BATCH_MAX;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			res = qsc_intutils_verify(a + (i * taglen), b + (i * taglen), taglen);
+			/* zero becomes a set bit, -1 becomes a clear bit */
+			mask |= ((uint64_t)(uint32_t)(res + 1)) << i;
+		}
 	}
 
-	return (1U & ((d - 1U) >> 8U)) - 1U;
+	return mask;
 }
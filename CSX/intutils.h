@@ -114,6 +114,16 @@ QSC_EXPORT_API void qsc_intutils_bswap32(uint32_t* destination, const uint32_t*
 QSC_EXPORT_API void qsc_intutils_bswap64(uint64_t* destination, const uint64_t* source, size_t length);
 #endif
 
+/**
+* \brief Byte reverse an array of 64-bit integers of any length.
+* Uses AVX-512 or AVX2 byte shuffles when available, the source and destination may be the same array.
+*
+* \param destination: The destination array
+* \param source: [const] The source array
+* \param count: The number of 64-bit integers
+*/
+QSC_EXPORT_API void qsc_intutils_bswap64_array(uint64_t* destination, const uint64_t* source, size_t count);
+
 /**
 * \brief Set an an 8-bit integer array to zeroes
 *
@@ -251,6 +261,16 @@ QSC_EXPORT_API uint32_t qsc_intutils_le8to32(const uint8_t* input);
 */
 QSC_EXPORT_API uint64_t qsc_intutils_le8to64(const uint8_t* input);
 
+/**
+* \brief Convert an 8-bit integer array to an array of 64-bit little-endian integers.
+* A copy on little-endian systems, a vectorized byte reversal on big-endian systems.
+*
+* \param output: The 64-bit integer array
+* \param input: [const] The source 8-bit integer array, count * 8 bytes
+* \param count: The number of 64-bit integers
+*/
+QSC_EXPORT_API void qsc_intutils_le8to64_array(uint64_t* output, const uint8_t* input, size_t count);
+
 /**
 * \brief Convert a 16-bit integer to a little-endian 8-bit integer array
 *
@@ -275,6 +295,16 @@ QSC_EXPORT_API void qsc_intutils_le32to8(uint8_t* output, uint32_t value);
 */
 QSC_EXPORT_API void qsc_intutils_le64to8(uint8_t* output, uint64_t value);
 
+/**
+* \brief Convert an array of 64-bit integers to a little-endian 8-bit integer array.
+* A copy on little-endian systems, a vectorized byte reversal on big-endian systems.
+*
+* \param output: The 8-bit integer array, count * 8 bytes
+* \param input: [const] The source 64-bit integer array
+* \param count: The number of 64-bit integers
+*/
+QSC_EXPORT_API void qsc_intutils_le64to8_array(uint8_t* output, const uint64_t* input, size_t count);
+
 /**
 * \brief Return the larger of two integers
 *
@@ -359,4 +389,50 @@ QSC_EXPORT_API uint64_t qsc_intutils_rotr64(uint64_t value, size_t shift);
 */
 QSC_EXPORT_API int32_t qsc_intutils_verify(const uint8_t* a, const uint8_t* b, size_t length);
 
+/**
+* \brief Constant time comparison of two 16-byte arrays, the size of a 128-bit authentication tag
+*
+* \param a: [const] The first 8-bit integer array
+* \param b: [const] The second 8-bit integer array
+* \return Returns zero if the arrays are equivalent
+*/
+QSC_EXPORT_API int32_t qsc_intutils_verify16(const uint8_t* a, const uint8_t* b);
+
+/**
+* \brief Constant time comparison of two 32-byte arrays, the size of a 256-bit authentication tag
+*
+* \param a: [const] The first 8-bit integer array
+* \param b: [const] The second 8-bit integer array
+* \return Returns zero if the arrays are equivalent
+*/
+QSC_EXPORT_API int32_t qsc_intutils_verify32(const uint8_t* a, const uint8_t* b);
+
+/**
+* \brief Constant time comparison of two 64-byte arrays, the size of a 512-bit authentication tag
+*
+* \param a: [const] The first 8-bit integer array
+* \param b: [const] The second 8-bit integer array
+* \return Returns zero if the arrays are equivalent
+*/
+QSC_EXPORT_API int32_t qsc_intutils_verify64(const uint8_t* a, const uint8_t* b);
+
+/*!
+* \def QSC_INTUTILS_VERIFY_BATCH_MAX
+* \brief The maximum number of tags compared by one call to the batch verify function
+*/
+#define QSC_INTUTILS_VERIFY_BATCH_MAX 64
+
+/**
+* \brief Constant time comparison of a batch of authentication tags.
+* The tags are stored back to back in each array; tag i occupies bytes i * taglen to (i + 1) * taglen - 1.
+* The time taken depends only on the tag length and count, not on which tags match.
+*
+* \param a: [const] The first array of tags
+* \param b: [const] The second array of tags
+* \param taglen: The byte length of each tag
+* \param count: The number of tags, at most QSC_INTUTILS_VERIFY_BATCH_MAX
+* \return Returns a bitmask with bit i set if tag i of both arrays is equivalent
+*/
+QSC_EXPORT_API uint64_t qsc_intutils_verify_batch(const uint8_t* a, const uint8_t* b, size_t taglen, size_t count);
+
 #endif
@@ -0,0 +1,361 @@
+#include "intutils_test.h"
+#include "csp.h"
+#include "intutils.h"
+#include "memutils.h"
+#include "testutils.h"
+#include "timerex.h"
+#include <math.h>
+#include <stdlib.h>
+
+/* the number of samples measured per round of fresh inputs, QSCTEST_INTUTILS_TIMING_SAMPLES is a multiple */
+#define INTUTILS_TIMING_ROUND 1000
+#define INTUTILS_TIMING_CROPS 6
+#define INTUTILS_BATCH_TAGS 16
+#define INTUTILS_ENDIAN_WORDS 40
+
+typedef int32_t (*intutils_verify_kernel)(const uint8_t* a, const uint8_t* b);
+
+typedef struct
+{
+	double mean[2];
+	double m2[2];
+	double count[2];
+} intutils_welch_state;
+
+static void intutils_welch_push(intutils_welch_state* ctx, uint8_t cls, double x)
+{
+	double delta;
+
+	/* Welford's online mean and variance */
+	ctx->count[cls] += 1.0;
+	delta = x - ctx->mean[cls];
+	ctx->mean[cls] += delta / ctx->count[cls];
+	ctx->m2[cls] += delta * (x - ctx->mean[cls]);
+}
+
+static double intutils_welch_t(const intutils_welch_state* ctx)
+{
+	double den;
+	double res;
+
+	res = 0.0;
+
+	if (ctx->count[0] > 1.0 && ctx->count[1] > 1.0)
+	{
+		den = sqrt(((ctx->m2[0] / (ctx->count[0] - 1.0)) / ctx->count[0]) + ((ctx->m2[1] / (ctx->count[1] - 1.0)) / ctx->count[1]));
+		res = (den > 0.0) ? fabs(ctx->mean[0] - ctx->mean[1]) / den : 0.0;
+	}
+
+	return res;
+}
+
+static int intutils_sample_compare(const void* a, const void* b)
+{
+	const uint64_t x = *(const uint64_t*)a;
+	const uint64_t y = *(const uint64_t*)b;
+
+	return (x > y) - (x < y);
+}
+
+static bool intutils_timing(const char* name, size_t taglen, size_t tags, intutils_verify_kernel kernel)
+{
+	const double CROPS[INTUTILS_TIMING_CROPS] = { 0.5, 0.75, 0.9, 0.95, 0.99, 1.0 };
+	const size_t SETLEN = taglen * tags;
+	intutils_welch_state welch[INTUTILS_TIMING_CROPS];
+	uint64_t limits[INTUTILS_TIMING_CROPS];
+	uint64_t* samples;
+	uint64_t* sorted;
+	uint8_t* classes;
+	uint8_t* other;
+	uint8_t* tag;
+	volatile int32_t sink;
+	uint64_t cycles;
+	double tmax;
+	double tval;
+	size_t idx;
+	size_t j;
+	bool res;
+
+	res = false;
+	tmax = 0.0;
+	samples = (uint64_t*)qsc_memutils_malloc(QSCTEST_INTUTILS_TIMING_SAMPLES * sizeof(uint64_t));
+	sorted = (uint64_t*)qsc_memutils_malloc(QSCTEST_INTUTILS_TIMING_SAMPLES * sizeof(uint64_t));
+	classes = (uint8_t*)qsc_memutils_malloc(QSCTEST_INTUTILS_TIMING_SAMPLES);
+	other = (uint8_t*)qsc_memutils_malloc(INTUTILS_TIMING_ROUND * SETLEN);
+	tag = (uint8_t*)qsc_memutils_malloc(INTUTILS_TIMING_ROUND * SETLEN);
+
+	if (samples != NULL && sorted != NULL && classes != NULL && other != NULL && tag != NULL)
+	{
+		qsc_csp_generate(classes, QSCTEST_INTUTILS_TIMING_SAMPLES);
+
+		for (size_t r = 0; r < QSCTEST_INTUTILS_TIMING_SAMPLES; r += INTUTILS_TIMING_ROUND)
+		{
+			/* class 0 compares a tag with an equal copy, class 1 with a random tag; the classes
+			   are interleaved at random, and share one input array so memory placement is not a factor */
+			qsc_csp_generate(tag, INTUTILS_TIMING_ROUND * SETLEN);
+			qsc_csp_generate(other, INTUTILS_TIMING_ROUND * SETLEN);
+
+			for (size_t i = 0; i < INTUTILS_TIMING_ROUND; ++i)
+			{
+				classes[r + i] &= 1U;
+
+				if (classes[r + i] == 0)
+				{
+					qsc_memutils_copy(other + (i * SETLEN), tag + (i * SETLEN), SETLEN);
+				}
+			}
+
+			for (size_t i = 0; i < INTUTILS_TIMING_ROUND; ++i)
+			{
+				idx = i * SETLEN;
+				/* the result is written to a volatile, so the call cannot be removed */
+				cycles = qsc_timerex_cycles_start();
+				sink = kernel(tag + idx, other + idx);
+				samples[r + i] = qsc_timerex_cycles_stop() - cycles;
+			}
+		}
+
+		(void)sink;
+
+		/* crop the upper tail at several percentiles; a leak may hide below the noise of the full distribution */
+		qsc_memutils_copy(sorted, samples, QSCTEST_INTUTILS_TIMING_SAMPLES * sizeof(uint64_t));
+		qsort(sorted, QSCTEST_INTUTILS_TIMING_SAMPLES, sizeof(uint64_t), intutils_sample_compare);
+		qsc_memutils_clear(welch, sizeof(welch));
+
+		for (j = 0; j < INTUTILS_TIMING_CROPS; ++j)
+		{
+			idx = (size_t)(CROPS[j] * (double)(QSCTEST_INTUTILS_TIMING_SAMPLES - 1));
+			limits[j] = sorted[idx];
+		}
+
+		for (size_t i = 0; i < QSCTEST_INTUTILS_TIMING_SAMPLES; ++i)
+		{
+			for (j = 0; j < INTUTILS_TIMING_CROPS; ++j)
+			{
+				if (samples[i] <= limits[j])
+				{
+					intutils_welch_push(&welch[j], classes[i], (double)samples[i]);
+				}
+			}
+		}
+
+		for (j = 0; j < INTUTILS_TIMING_CROPS; ++j)
+		{
+			tval = intutils_welch_t(&welch[j]);
+			tmax = (tval > tmax) ? tval : tmax;
+		}
+
+		qsctest_print_safe(name);
+		qsctest_print_safe(": max |t| ");
+		qsctest_print_double(tmax);
+		qsctest_print_line("");
+
+		res = (tmax < QSCTEST_INTUTILS_TIMING_THRESHOLD);
+	}
+
+	qsc_memutils_alloc_free(samples);
+	qsc_memutils_alloc_free(sorted);
+	qsc_memutils_alloc_free(classes);
+	qsc_memutils_alloc_free(other);
+	qsc_memutils_alloc_free(tag);
+
+	return res;
+}
+
+static int32_t intutils_batch_kernel(const uint8_t* a, const uint8_t* b)
+{
+	return (int32_t)qsc_intutils_verify_batch(a, b, 32, INTUTILS_BATCH_TAGS);
+}
+
+bool qsctest_intutils_verify()
+{
+	const size_t LENGTHS[7] = { 1, 15, 16, 32, 47, 64, 100 };
+	uint8_t a[QSC_INTUTILS_VERIFY_BATCH_MAX * 64] = { 0 };
+	uint8_t b[QSC_INTUTILS_VERIFY_BATCH_MAX * 64] = { 0 };
+	uint8_t sel[QSC_INTUTILS_VERIFY_BATCH_MAX] = { 0 };
+	uint64_t exp;
+	size_t len;
+	bool res;
+
+	res = true;
+	qsc_csp_generate(a, sizeof(a));
+
+	for (size_t i = 0; i < sizeof(LENGTHS) / sizeof(size_t); ++i)
+	{
+		len = LENGTHS[i];
+		qsc_memutils_copy(b, a, len);
+
+		if (qsc_intutils_verify(a, b, len) != 0)
+		{
+			qsctest_print_safe("Failure! qsctest_intutils_verify: equal arrays were rejected -IV1 \n");
+			res = false;
+		}
+
+		/* a single bit difference at every position must be detected */
+		for (size_t j = 0; j < len; ++j)
+		{
+			b[j] ^= (uint8_t)(1U << (j % 8));
+
+			if (qsc_intutils_verify(a, b, len) != -1)
+			{
+				qsctest_print_safe("Failure! qsctest_intutils_verify: a difference was not detected -IV2 \n");
+				res = false;
+				break;
+			}
+
+			b[j] = a[j];
+		}
+	}
+
+	qsc_memutils_copy(b, a, 64);
+
+	if (qsc_intutils_verify16(a, b) != 0 || qsc_intutils_verify32(a, b) != 0 || qsc_intutils_verify64(a, b) != 0)
+	{
+		qsctest_print_safe("Failure! qsctest_intutils_verify: a kernel rejected equal arrays -IV3 \n");
+		res = false;
+	}
+
+	b[15] ^= 0x80U;
+
+	if (qsc_intutils_verify16(a, b) != -1 || qsc_intutils_verify32(a, b) != -1 || qsc_intutils_verify64(a, b) != -1)
+	{
+		qsctest_print_safe("Failure! qsctest_intutils_verify: a kernel accepted different arrays -IV4 \n");
+		res = false;
+	}
+
+	/* corrupt a random selection of tags, and check the batch mask marks exactly the intact ones */
+	for (size_t taglen = 16; taglen <= 64; taglen *= 2)
+	{
+		qsc_memutils_copy(b, a, sizeof(a));
+		qsc_csp_generate(sel, sizeof(sel));
+		exp = 0;
+
+		for (size_t i = 0; i < QSC_INTUTILS_VERIFY_BATCH_MAX; ++i)
+		{
+			if ((sel[i] & 1U) != 0)
+			{
+				b[(i * taglen) + (sel[i] % taglen)] ^= 0x01U;
+			}
+			else
+			{
+				exp |= (1ULL << i);
+			}
+		}
+
+		if (qsc_intutils_verify_batch(a, b, taglen, QSC_INTUTILS_VERIFY_BATCH_MAX) != exp)
+		{
+			qsctest_print_safe("Failure! qsctest_intutils_verify: the batch mask is incorrect -IV5 \n");
+			res = false;
+		}
+	}
+
+	return res;
+}
+
+bool qsctest_intutils_endian()
+{
+	uint8_t inp[(INTUTILS_ENDIAN_WORDS * sizeof(uint64_t)) + 1] = { 0 };
+	uint8_t otp[(INTUTILS_ENDIAN_WORDS * sizeof(uint64_t)) + 1] = { 0 };
+	uint64_t src[INTUTILS_ENDIAN_WORDS + 1] = { 0 };
+	uint64_t dst[INTUTILS_ENDIAN_WORDS + 1] = { 0 };
+	uint64_t exp;
+	bool res;
+
+	res = true;
+	qsc_csp_generate(inp, sizeof(inp));
+
+	/* every count covers a different mix of vector and scalar tail words, the offset of one misaligns the arrays */
+	for (size_t cnt = 0; cnt <= INTUTILS_ENDIAN_WORDS && res == true; ++cnt)
+	{
+		for (size_t off = 0; off < 2; ++off)
+		{
+			qsc_memutils_clear(dst, sizeof(dst));
+			qsc_intutils_le8to64_array(dst + off, inp + off, cnt);
+			qsc_intutils_le64to8_array(otp + off, dst + off, cnt);
+
+			if (qsc_intutils_are_equal8(otp + off, inp + off, cnt * sizeof(uint64_t)) == false)
+			{
+				qsctest_print_safe("Failure! qsctest_intutils_endian: the array conversions do not round trip -IE1 \n");
+				res = false;
+			}
+
+			for (size_t i = 0; i < cnt; ++i)
+			{
+				if (dst[off + i] != qsc_intutils_le8to64(inp + off + (i * sizeof(uint64_t))))
+				{
+					qsctest_print_safe("Failure! qsctest_intutils_endian: le8to64_array differs from le8to64 -IE2 \n");
+					res = false;
+					break;
+				}
+			}
+
+			qsc_memutils_copy(src, dst, sizeof(src));
+			qsc_intutils_bswap64_array(dst + off, src + off, cnt);
+
+			for (size_t i = 0; i < cnt; ++i)
+			{
+				exp = qsc_intutils_be8to64(inp + off + (i * sizeof(uint64_t)));
+
+				if (dst[off + i] != exp)
+				{
+					qsctest_print_safe("Failure! qsctest_intutils_endian: bswap64_array output is incorrect -IE3 \n");
+					res = false;
+					break;
+				}
+			}
+
+			/* in place, the same array reversed twice is the original */
+			qsc_intutils_bswap64_array(dst + off, dst + off, cnt);
+
+			if (qsc_intutils_are_equal8((const uint8_t*)(dst + off), (const uint8_t*)(src + off), cnt * sizeof(uint64_t)) == false)
+			{
+				qsctest_print_safe("Failure! qsctest_intutils_endian: bswap64_array in place is incorrect -IE4 \n");
+				res = false;
+			}
+		}
+	}
+
+	return res;
+}
+
+bool qsctest_intutils_verify_timing()
+{
+	bool res;
+
+	res = intutils_timing("qsc_intutils_verify16", 16, 1, qsc_intutils_verify16);
+	res = intutils_timing("qsc_intutils_verify32", 32, 1, qsc_intutils_verify32) && res;
+	res = intutils_timing("qsc_intutils_verify64", 64, 1, qsc_intutils_verify64) && res;
+	res = intutils_timing("qsc_intutils_verify_batch 16 x 32 bytes", 32, INTUTILS_BATCH_TAGS, intutils_batch_kernel) && res;
+
+	return res;
+}
+
+void qsctest_intutils_run()
+{
+	if (qsctest_intutils_verify() == true)
+	{
+		qsctest_print_safe("Success! Passed the constant-time compare tests. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the constant-time compare tests. \n");
+	}
+
+	if (qsctest_intutils_endian() == true)
+	{
+		qsctest_print_safe("Success! Passed the array endian conversion tests. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the array endian conversion tests. \n");
+	}
+
+	if (qsctest_intutils_verify_timing() == true)
+	{
+		qsctest_print_safe("Success! Passed the constant-time compare timing tests. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the constant-time compare timing tests. \n");
+	}
+}
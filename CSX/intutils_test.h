@@ -0,0 +1,58 @@
+/**
+* \file intutils_test.h
+* \brief <b>Integer utility tests</b> \n
+* Tests the tag comparison functions for correct results, and for timing that does not depend on the data,
+* and the array endian conversions against the single integer forms. \n
+* The timing test follows the dudect method: the execution time of a compare is measured for two classes of input,
+* equal tags and random tags, in a random order, and a Welch t-test is applied to the two distributions,
+* with the upper tail of the measurements cropped at several percentiles to remove interrupt and scheduling noise.
+*
+* \remarks <b>Test References:</b> \n
+* O. Reparaz, J. Balasch, I. Verbauwhede, <a href="https://eprint.iacr.org/2016/1123">Dude, is my code constant time?</a>
+*/
+
+#ifndef QSCTEST_INTUTILS_TEST_H
+#define QSCTEST_INTUTILS_TEST_H
+
+#include "common.h"
+
+/*!
+* \def QSCTEST_INTUTILS_TIMING_SAMPLES
+* \brief The number of timed compares in each timing test
+*/
+#define QSCTEST_INTUTILS_TIMING_SAMPLES 200000
+
+/*!
+* \def QSCTEST_INTUTILS_TIMING_THRESHOLD
+* \brief The largest t statistic accepted; dudect treats a value above 10 as a definite timing leak
+*/
+#define QSCTEST_INTUTILS_TIMING_THRESHOLD 10.0
+
+/**
+* \brief Tests the single and batch compare functions with equal tags, and with a difference at every byte position.
+*
+* \return Returns true for success
+*/
+bool qsctest_intutils_verify(void);
+
+/**
+* \brief Tests the array endian conversions and byte reversal against the single integer functions,
+* for every count up to 40 words, on aligned and misaligned arrays, and in place.
+*
+* \return Returns true for success
+*/
+bool qsctest_intutils_endian(void);
+
+/**
+* \brief Applies the dudect timing test to the 16, 32, and 64 byte compare kernels, and the batch compare.
+*
+* \return Returns true if no data-dependent timing is detected
+*/
+bool qsctest_intutils_verify_timing(void);
+
+/**
+* \brief Run all tests.
+*/
+void qsctest_intutils_run(void);
+
+#endif
@@ -3,61 +3,135 @@
 #if defined(QSC_SYSTEM_AVX_INTRINSICS)
 #	include "intrinsics.h"
 #endif
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+#	include <intrin.h>
+#endif
 #if defined(QSC_SYSTEM_OS_WINDOWS)
+#	include <Windows.h>
 #	include <malloc.h>
 #else
 #	include <stdlib.h>
+#	if defined(QSC_SYSTEM_OS_POSIX)
+#		include <sys/mman.h>
+#		include <unistd.h>
+#	endif
 #endif
 
-void qsc_memutils_prefetch_l1(uint8_t* address, size_t length)
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+#	define MEMUTILS_THREAD_LOCAL __declspec(thread)
+#else
+#	define MEMUTILS_THREAD_LOCAL __thread
+#endif
+
+#define MEMUTILS_ARENA_INDEX_MASK 0x00000000FFFFFFFFULL
+#define MEMUTILS_PAGE_SIZE_DEFAULT 4096
+
+typedef struct
 {
+	uint32_t id;		/* the arena identifier, zero if the entry is unused */
+	uint32_t head;		/* the first object index + 1, zero if the list is empty */
+	uint32_t count;		/* the number of objects in the list */
+} memutils_arena_cache;
+
+/* the private free-lists of the calling thread, one per arena in use by the thread */
+static MEMUTILS_THREAD_LOCAL memutils_arena_cache memutils_arena_caches[QSC_MEMUTILS_ARENA_THREAD_ARENAS];
+/* the last arena identifier issued */
+static volatile uint32_t memutils_arena_ids = 0;
+/* the identifiers of the arenas that exist, zero for an unused entry; identifiers are never reused,
+   so a private free-list whose arena is not listed belongs to a destroyed arena and can be reclaimed */
+static volatile uint32_t memutils_arena_live[QSC_MEMUTILS_ARENA_MAX];
+/* the length at which the stream functions switch to non-temporal stores */
+static volatile size_t memutils_stream_length = QSC_MEMUTILS_STREAM_THRESHOLD;
+
+void qsc_memutils_prefetch_range(const void* address, size_t length, size_t stride, qsc_memutils_cache_level level)
+{
+	assert(address != NULL);
+
+	const uint8_t* padd;
+	size_t head;
+	size_t pctr;
+
+	if (address != NULL && length != 0)
+	{
+		/* start on the line that holds the first byte, so the line holding the last byte is also covered */
+		head = (size_t)((uintptr_t)address & (QSC_MEMUTILS_CACHE_LINE_SIZE - 1));
+		padd = (const uint8_t*)address - head;
+		length += head;
+		stride = (stride != 0) ? stride : QSC_MEMUTILS_CACHE_LINE_SIZE;
+
 #if defined(QSC_SYSTEM_AVX_INTRINSICS)
-	_mm_prefetch(((char*)address + length), _MM_HINT_T0);
+		for (pctr = 0; pctr < length; pctr += stride)
+		{
+			if (level == qsc_memutils_cache_level_l1)
+			{
+				_mm_prefetch((const char*)(padd + pctr), _MM_HINT_T0);
+			}
+			else if (level == qsc_memutils_cache_level_l2)
+			{
+				_mm_prefetch((const char*)(padd + pctr), _MM_HINT_T1);
+			}
+			else
+			{
+				_mm_prefetch((const char*)(padd + pctr), _MM_HINT_T2);
+			}
+		}
+#elif defined(QSC_SYSTEM_COMPILER_GCC)
+		for (pctr = 0; pctr < length; pctr += stride)
+		{
+			if (level == qsc_memutils_cache_level_l1)
+			{
+				__builtin_prefetch(padd + pctr, 0, 3);
+			}
+			else if (level == qsc_memutils_cache_level_l2)
+			{
+				__builtin_prefetch(padd + pctr, 0, 2);
+			}
+			else
+			{
+				__builtin_prefetch(padd + pctr, 0, 1);
+			}
+		}
 #else
-	volatile uint8_t tmp;
-	size_t i;
+		volatile uint8_t tmp;
 
-	tmp = 0;
+		tmp = 0;
 
-	for (i = 0; i < length; ++i)
-	{
-		tmp |= address[i];
-	}
+		/* without a prefetch instruction, touch each stride of the range itself */
+		for (pctr = head; pctr < length; pctr += stride)
+		{
+			tmp |= padd[pctr];
+		}
+
+		(void)level;
 #endif
+	}
 }
 
-void qsc_memutils_prefetch_l2(uint8_t* address, size_t length)
+void qsc_memutils_prefetch_ahead(const void* address, size_t length, size_t position, size_t distance, size_t span, qsc_memutils_cache_level level)
 {
-#if defined(QSC_SYSTEM_AVX_INTRINSICS)
-	_mm_prefetch(((char*)address + length), _MM_HINT_T1);
-#else
-	volatile uint8_t tmp;
-	size_t i;
+	size_t pos;
 
-	tmp = 0;
-
-	for (i = 0; i < length; ++i)
+	if (address != NULL && position < length && distance < length - position)
 	{
-		tmp |= address[i];
+		pos = position + distance;
+		span = (span < length - pos) ? span : length - pos;
+		qsc_memutils_prefetch_range((const uint8_t*)address + pos, span, 0, level);
 	}
-#endif
 }
 
-void qsc_memutils_prefetch_l3(uint8_t* address, size_t length)
+void qsc_memutils_prefetch_l1(uint8_t* address, size_t length)
 {
-#if defined(QSC_SYSTEM_AVX_INTRINSICS)
-	_mm_prefetch(((char*)address + length), _MM_HINT_T2);
-#else
-	volatile uint8_t tmp;
-	size_t i;
+	qsc_memutils_prefetch_range(address, length, 0, qsc_memutils_cache_level_l1);
+}
 
-	tmp = 0;
+void qsc_memutils_prefetch_l2(uint8_t* address, size_t length)
+{
+	qsc_memutils_prefetch_range(address, length, 0, qsc_memutils_cache_level_l2);
+}
 
-	for (i = 0; i < length; ++i)
-	{
-		tmp |= address[i];
-	}
-#endif
+void qsc_memutils_prefetch_l3(uint8_t* address, size_t length)
+{
+	qsc_memutils_prefetch_range(address, length, 0, qsc_memutils_cache_level_l3);
 }
 
 void* qsc_memutils_malloc(size_t length)
@@ -155,6 +229,555 @@ void qsc_memutils_aligned_free(void* block)
 	}
 }
 
+static uint32_t memutils_atomic_increment32(volatile uint32_t* target)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	return (uint32_t)InterlockedIncrement((volatile LONG*)target);
+#else
+	return __atomic_add_fetch(target, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+static uint32_t memutils_atomic_load32(volatile uint32_t* target)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	return *target;
+#else
+	return __atomic_load_n(target, __ATOMIC_RELAXED);
+#endif
+}
+
+static void memutils_atomic_store32(volatile uint32_t* target, uint32_t value)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	*target = value;
+#else
+	__atomic_store_n(target, value, __ATOMIC_RELAXED);
+#endif
+}
+
+static size_t memutils_stream_length_load()
+{
+	/* the threshold is read by every transform and may be set at any time; it orders no other data */
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	return memutils_stream_length;
+#else
+	return __atomic_load_n(&memutils_stream_length, __ATOMIC_RELAXED);
+#endif
+}
+
+static void memutils_stream_length_store(size_t length)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	memutils_stream_length = length;
+#else
+	__atomic_store_n(&memutils_stream_length, length, __ATOMIC_RELAXED);
+#endif
+}
+
+static bool memutils_atomic_cas32(volatile uint32_t* target, uint32_t expected, uint32_t desired)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	return ((uint32_t)InterlockedCompareExchange((volatile LONG*)target, (LONG)desired, (LONG)expected) == expected);
+#else
+	return __atomic_compare_exchange_n(target, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static uint64_t memutils_atomic_load64(volatile uint64_t* target)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	/* a compare with an unlikely value is an atomic 64-bit read on 32-bit targets */
+	return (uint64_t)InterlockedCompareExchange64((volatile LONG64*)target, 0, 0);
+#else
+	return __atomic_load_n(target, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static bool memutils_atomic_cas64(volatile uint64_t* target, uint64_t expected, uint64_t desired)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	return ((uint64_t)InterlockedCompareExchange64((volatile LONG64*)target, (LONG64)desired, (LONG64)expected) == expected);
+#else
+	return __atomic_compare_exchange_n(target, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static size_t memutils_page_size()
+{
+	size_t len;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	SYSTEM_INFO sinf;
+
+	GetSystemInfo(&sinf);
+	len = (size_t)sinf.dwPageSize;
+#elif defined(QSC_SYSTEM_OS_POSIX)
+	long plen;
+
+	plen = sysconf(_SC_PAGESIZE);
+	len = (plen > 0) ? (size_t)plen : MEMUTILS_PAGE_SIZE_DEFAULT;
+#else
+	len = MEMUTILS_PAGE_SIZE_DEFAULT;
+#endif
+
+	return len;
+}
+
+static uint8_t* memutils_region_alloc(size_t length)
+{
+	uint8_t* ret;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	ret = (uint8_t*)VirtualAlloc(NULL, length, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#elif defined(QSC_SYSTEM_OS_POSIX)
+	void* reg;
+
+#	if defined(MAP_ANONYMOUS)
+	reg = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#	else
+	reg = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+#	endif
+	ret = (reg != MAP_FAILED) ? (uint8_t*)reg : NULL;
+#else
+	ret = (uint8_t*)qsc_memutils_aligned_alloc(MEMUTILS_PAGE_SIZE_DEFAULT, length);
+
+	if (ret != NULL)
+	{
+		qsc_memutils_clear(ret, length);
+	}
+#endif
+
+	return ret;
+}
+
+static bool memutils_region_lock(uint8_t* region, size_t length)
+{
+	bool res;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	res = (VirtualLock(region, length) != 0);
+#elif defined(QSC_SYSTEM_OS_POSIX)
+	res = (mlock(region, length) == 0);
+	/* keep the key material out of core dumps */
+#	if defined(MADV_DONTDUMP)
+	madvise(region, length, MADV_DONTDUMP);
+#	elif defined(MADV_NOCORE)
+	madvise(region, length, MADV_NOCORE);
+#	endif
+#else
+	(void)region;
+	(void)length;
+	res = false;
+#endif
+
+	return res;
+}
+
+static void memutils_region_free(uint8_t* region, size_t length, bool locked)
+{
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	if (locked == true)
+	{
+		VirtualUnlock(region, length);
+	}
+
+	VirtualFree(region, 0, MEM_RELEASE);
+#elif defined(QSC_SYSTEM_OS_POSIX)
+	if (locked == true)
+	{
+		munlock(region, length);
+	}
+
+	munmap(region, length);
+#else
+	(void)length;
+	(void)locked;
+	qsc_memutils_aligned_free(region);
+#endif
+}
+
+static memutils_arena_cache* memutils_arena_cache_claim(uint32_t id)
+{
+	memutils_arena_cache* cache;
+	size_t i;
+
+	cache = NULL;
+
+	for (i = 0; i < QSC_MEMUTILS_ARENA_THREAD_ARENAS; ++i)
+	{
+		if (memutils_arena_caches[i].id == 0)
+		{
+			cache = &memutils_arena_caches[i];
+			cache->id = id;
+			cache->head = 0;
+			cache->count = 0;
+			break;
+		}
+	}
+
+	return cache;
+}
+
+static void memutils_arena_cache_reclaim()
+{
+	uint32_t id;
+	uint32_t live;
+	size_t i;
+	size_t j;
+
+	live = 0;
+
+	/* one pass over the arena table marks the private free-lists whose arena still exists */
+	for (i = 0; i < QSC_MEMUTILS_ARENA_MAX; ++i)
+	{
+		id = memutils_atomic_load32(&memutils_arena_live[i]);
+
+		for (j = 0; id != 0 && j < QSC_MEMUTILS_ARENA_THREAD_ARENAS; ++j)
+		{
+			live |= (memutils_arena_caches[j].id == id) ? (1U << j) : 0U;
+		}
+	}
+
+	/* the objects in the list of a destroyed arena were released with its region */
+	for (j = 0; j < QSC_MEMUTILS_ARENA_THREAD_ARENAS; ++j)
+	{
+		if ((live & (1U << j)) == 0)
+		{
+			memutils_arena_caches[j].id = 0;
+			memutils_arena_caches[j].head = 0;
+			memutils_arena_caches[j].count = 0;
+		}
+	}
+}
+
+static memutils_arena_cache* memutils_arena_cache_find(uint32_t id, bool claim)
+{
+	memutils_arena_cache* cache;
+	size_t i;
+
+	cache = NULL;
+
+	for (i = 0; i < QSC_MEMUTILS_ARENA_THREAD_ARENAS; ++i)
+	{
+		if (memutils_arena_caches[i].id == id)
+		{
+			cache = &memutils_arena_caches[i];
+			break;
+		}
+	}
+
+	if (cache == NULL && claim == true)
+	{
+		cache = memutils_arena_cache_claim(id);
+
+		if (cache == NULL)
+		{
+			/* every entry is in use; entries left by arenas destroyed on another thread are reclaimed */
+			memutils_arena_cache_reclaim();
+			cache = memutils_arena_cache_claim(id);
+		}
+	}
+
+	return cache;
+}
+
+static bool memutils_arena_register(uint32_t id)
+{
+	size_t i;
+	bool res;
+
+	res = false;
+
+	for (i = 0; i < QSC_MEMUTILS_ARENA_MAX; ++i)
+	{
+		if (memutils_atomic_cas32(&memutils_arena_live[i], 0, id) == true)
+		{
+			res = true;
+			break;
+		}
+	}
+
+	return res;
+}
+
+static void memutils_arena_unregister(uint32_t id)
+{
+	size_t i;
+
+	for (i = 0; i < QSC_MEMUTILS_ARENA_MAX; ++i)
+	{
+		if (memutils_atomic_load32(&memutils_arena_live[i]) == id)
+		{
+			memutils_atomic_store32(&memutils_arena_live[i], 0);
+			break;
+		}
+	}
+}
+
+static void memutils_arena_push(qsc_memutils_arena* arena, uint32_t first, uint32_t last)
+{
+	uint64_t head;
+	uint64_t next;
+
+	/* link the chain of objects from first to last in front of the shared list;
+	   the tag in the high word changes on every exchange, so a stale head is never accepted */
+	do
+	{
+		head = memutils_atomic_load64(&arena->head);
+		memutils_atomic_store32(&arena->links[last - 1], (uint32_t)(head & MEMUTILS_ARENA_INDEX_MASK));
+		next = ((((head >> 32) + 1) << 32) | first);
+	}
+	while (memutils_atomic_cas64(&arena->head, head, next) == false);
+}
+
+static uint32_t memutils_arena_pop(qsc_memutils_arena* arena)
+{
+	uint64_t head;
+	uint64_t next;
+	uint32_t idx;
+
+	do
+	{
+		head = memutils_atomic_load64(&arena->head);
+		idx = (uint32_t)(head & MEMUTILS_ARENA_INDEX_MASK);
+
+		if (idx == 0)
+		{
+			break;
+		}
+
+		next = ((((head >> 32) + 1) << 32) | memutils_atomic_load32(&arena->links[idx - 1]));
+	}
+	while (memutils_atomic_cas64(&arena->head, head, next) == false);
+
+	return idx;
+}
+
+bool qsc_memutils_arena_create(qsc_memutils_arena* arena, size_t objsize, size_t count)
+{
+	assert(arena != NULL);
+	assert(objsize != 0);
+	assert(count != 0);
+
+	size_t len;
+	size_t page;
+	size_t stride;
+	uint32_t i;
+	bool res;
+
+	res = false;
+
+	if (arena != NULL && objsize != 0 && count != 0 && count < MEMUTILS_ARENA_INDEX_MASK)
+	{
+		qsc_memutils_clear(arena, sizeof(qsc_memutils_arena));
+		stride = (objsize + (QSC_MEMUTILS_CACHE_LINE_SIZE - 1)) & ~((size_t)QSC_MEMUTILS_CACHE_LINE_SIZE - 1);
+
+		if (count <= (SIZE_MAX - QSC_MEMUTILS_CACHE_LINE_SIZE) / stride)
+		{
+			page = memutils_page_size();
+			len = ((stride * count) + (page - 1)) & ~(page - 1);
+			arena->base = memutils_region_alloc(len);
+			arena->links = (uint32_t*)qsc_memutils_malloc(count * sizeof(uint32_t));
+
+			if (arena->base != NULL && arena->links != NULL)
+			{
+				arena->length = len;
+				arena->stride = stride;
+				arena->capacity = (uint32_t)count;
+				arena->locked = memutils_region_lock(arena->base, len);
+
+				/* every object starts on the shared list, in address order */
+				for (i = 0; i < arena->capacity - 1; ++i)
+				{
+					arena->links[i] = i + 2;
+				}
+
+				arena->links[arena->capacity - 1] = 0;
+				arena->head = 1;
+
+				do
+				{
+					arena->id = memutils_atomic_increment32(&memutils_arena_ids);
+				}
+				while (arena->id == 0);
+
+				res = memutils_arena_register(arena->id);
+			}
+
+			if (res == false)
+			{
+				if (arena->base != NULL)
+				{
+					memutils_region_free(arena->base, len, arena->locked);
+				}
+
+				qsc_memutils_alloc_free(arena->links);
+				qsc_memutils_clear(arena, sizeof(qsc_memutils_arena));
+			}
+		}
+	}
+
+	return res;
+}
+
+void* qsc_memutils_arena_alloc(qsc_memutils_arena* arena)
+{
+	assert(arena != NULL);
+
+	memutils_arena_cache* cache;
+	void* ret;
+	uint32_t idx;
+
+	ret = NULL;
+
+	if (arena != NULL && arena->base != NULL)
+	{
+		cache = memutils_arena_cache_find(arena->id, false);
+
+		if (cache != NULL && cache->head != 0)
+		{
+			/* the most recently released object, its cache lines are the most likely to be resident */
+			idx = cache->head;
+			cache->head = memutils_atomic_load32(&arena->links[idx - 1]);
+			--cache->count;
+		}
+		else
+		{
+			idx = memutils_arena_pop(arena);
+		}
+
+		if (idx != 0)
+		{
+			ret = arena->base + ((size_t)(idx - 1) * arena->stride);
+		}
+	}
+
+	return ret;
+}
+
+void qsc_memutils_arena_free(qsc_memutils_arena* arena, void* block)
+{
+	assert(arena != NULL);
+	assert(block != NULL);
+
+	memutils_arena_cache* cache;
+	uint32_t first;
+	uint32_t idx;
+	uint32_t last;
+	uint32_t n;
+	size_t oft;
+
+	if (arena != NULL && arena->base != NULL && block != NULL && (uint8_t*)block >= arena->base)
+	{
+		oft = (size_t)((uint8_t*)block - arena->base);
+
+		if (oft < (size_t)arena->capacity * arena->stride && (oft % arena->stride) == 0)
+		{
+			idx = (uint32_t)(oft / arena->stride) + 1;
+
+			/* erase the object before it can be handed to another caller */
+			qsc_memutils_clear(block, arena->stride);
+			cache = memutils_arena_cache_find(arena->id, true);
+
+			if (cache != NULL)
+			{
+				memutils_atomic_store32(&arena->links[idx - 1], cache->head);
+				cache->head = idx;
+				++cache->count;
+
+				if (cache->count > QSC_MEMUTILS_ARENA_THREAD_CACHE)
+				{
+					/* keep the newest half of the private list, the objects most likely to still be cached,
+					   and return the older tail to the shared list with one exchange */
+					last = cache->head;
+
+					for (n = 1; n < QSC_MEMUTILS_ARENA_THREAD_CACHE / 2; ++n)
+					{
+						last = memutils_atomic_load32(&arena->links[last - 1]);
+					}
+
+					first = memutils_atomic_load32(&arena->links[last - 1]);
+					memutils_atomic_store32(&arena->links[last - 1], 0);
+					n = cache->count - (QSC_MEMUTILS_ARENA_THREAD_CACHE / 2);
+					cache->count = QSC_MEMUTILS_ARENA_THREAD_CACHE / 2;
+					last = first;
+
+					while (n > 1)
+					{
+						last = memutils_atomic_load32(&arena->links[last - 1]);
+						--n;
+					}
+
+					memutils_arena_push(arena, first, last);
+				}
+			}
+			else
+			{
+				memutils_arena_push(arena, idx, idx);
+			}
+		}
+	}
+}
+
+void qsc_memutils_arena_flush(qsc_memutils_arena* arena)
+{
+	assert(arena != NULL);
+
+	memutils_arena_cache* cache;
+	uint32_t last;
+
+	if (arena != NULL && arena->base != NULL)
+	{
+		cache = memutils_arena_cache_find(arena->id, false);
+
+		if (cache != NULL)
+		{
+			if (cache->head != 0)
+			{
+				last = cache->head;
+
+				while (memutils_atomic_load32(&arena->links[last - 1]) != 0)
+				{
+					last = memutils_atomic_load32(&arena->links[last - 1]);
+				}
+
+				memutils_arena_push(arena, cache->head, last);
+			}
+
+			cache->id = 0;
+			cache->head = 0;
+			cache->count = 0;
+		}
+	}
+}
+
+void qsc_memutils_arena_destroy(qsc_memutils_arena* arena)
+{
+	assert(arena != NULL);
+
+	memutils_arena_cache* cache;
+
+	if (arena != NULL && arena->base != NULL)
+	{
+		cache = memutils_arena_cache_find(arena->id, false);
+
+		if (cache != NULL)
+		{
+			cache->id = 0;
+			cache->head = 0;
+			cache->count = 0;
+		}
+
+		/* the private free-lists of other threads are reclaimed when those threads need an entry */
+		memutils_arena_unregister(arena->id);
+		qsc_memutils_clear(arena->base, arena->length);
+		memutils_region_free(arena->base, arena->length, arena->locked);
+		qsc_memutils_alloc_free(arena->links);
+		qsc_memutils_clear(arena, sizeof(qsc_memutils_arena));
+	}
+}
+
 #if defined(QSC_SYSTEM_HAS_AVX)
 static void qsc_memutils_clear128(void* output)
 {
@@ -240,6 +863,31 @@ void qsc_memutils_clear(void* output, size_t length)
 	}
 }
 
+#if !defined(QSC_SYSTEM_COMPILER_MSC) && !defined(QSC_SYSTEM_COMPILER_GCC)
+/* called through a volatile pointer, the compiler cannot prove the clear has no effect */
+static void (* volatile memutils_wipe_function)(void*, size_t) = qsc_memutils_clear;
+#endif
+
+void qsc_memutils_secure_wipe(void* output, size_t length)
+{
+	assert(output != NULL || length == 0);
+
+	if (output != NULL && length != 0)
+	{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+		qsc_memutils_clear(output, length);
+		/* the cleared memory must be written before any access that follows, including its release */
+		_ReadWriteBarrier();
+#elif defined(QSC_SYSTEM_COMPILER_GCC)
+		qsc_memutils_clear(output, length);
+		/* the barrier takes the address as an input and clobbers memory, so the stores are observable */
+		__asm__ __volatile__("" : : "r"(output) : "memory");
+#else
+		memutils_wipe_function(output, length);
+#endif
+	}
+}
+
 #if defined(QSC_SYSTEM_HAS_AVX)
 static void qsc_memutils_copy128(const void* input, void* output)
 {
@@ -562,3 +1210,163 @@ void qsc_memutils_xorv(uint8_t* output, const uint8_t value, size_t length)
 		}
 	}
 }
+
+#if defined(QSC_SYSTEM_AVX_INTRINSICS)
+#	if defined(QSC_SYSTEM_HAS_AVX512)
+#		define MEMUTILS_STREAM_BLOCK 64
+#	elif defined(QSC_SYSTEM_HAS_AVX2)
+#		define MEMUTILS_STREAM_BLOCK 32
+#	else
+#		define MEMUTILS_STREAM_BLOCK 16
+#	endif
+
+static size_t memutils_stream_head(const void* output, size_t length)
+{
+	size_t hlen;
+
+	/* the bytes before the first aligned block, non-temporal stores require an aligned address */
+	hlen = (MEMUTILS_STREAM_BLOCK - ((size_t)(uintptr_t)output & (MEMUTILS_STREAM_BLOCK - 1))) & (MEMUTILS_STREAM_BLOCK - 1);
+
+	return (hlen < length) ? hlen : length;
+}
+
+static void memutils_stream_copy(uint8_t* output, const uint8_t* input, size_t length)
+{
+	size_t pctr;
+
+	pctr = memutils_stream_head(output, length);
+	qsc_memutils_copy(output, input, pctr);
+
+	while (length - pctr >= MEMUTILS_STREAM_BLOCK)
+	{
+#if defined(QSC_SYSTEM_HAS_AVX512)
+		_mm512_stream_si512((__m512i*)(output + pctr), _mm512_loadu_si512((const __m512i*)(input + pctr)));
+#elif defined(QSC_SYSTEM_HAS_AVX2)
+		_mm256_stream_si256((__m256i*)(output + pctr), _mm256_loadu_si256((const __m256i*)(input + pctr)));
+#else
+		_mm_stream_si128((__m128i*)(output + pctr), _mm_loadu_si128((const __m128i*)(input + pctr)));
+#endif
+		pctr += MEMUTILS_STREAM_BLOCK;
+	}
+
+	qsc_memutils_copy(output + pctr, input + pctr, length - pctr);
+}
+
+static void memutils_stream_clear(uint8_t* output, size_t length)
+{
+	size_t pctr;
+
+	pctr = memutils_stream_head(output, length);
+	qsc_memutils_clear(output, pctr);
+
+	while (length - pctr >= MEMUTILS_STREAM_BLOCK)
+	{
+#if defined(QSC_SYSTEM_HAS_AVX512)
+		_mm512_stream_si512((__m512i*)(output + pctr), _mm512_setzero_si512());
+#elif defined(QSC_SYSTEM_HAS_AVX2)
+		_mm256_stream_si256((__m256i*)(output + pctr), _mm256_setzero_si256());
+#else
+		_mm_stream_si128((__m128i*)(output + pctr), _mm_setzero_si128());
+#endif
+		pctr += MEMUTILS_STREAM_BLOCK;
+	}
+
+	qsc_memutils_clear(output + pctr, length - pctr);
+}
+
+static void memutils_stream_xor(uint8_t* output, const uint8_t* input, size_t length)
+{
+	size_t pctr;
+
+	pctr = memutils_stream_head(output, length);
+	qsc_memutils_xor(output, input, pctr);
+
+	while (length - pctr >= MEMUTILS_STREAM_BLOCK)
+	{
+#if defined(QSC_SYSTEM_HAS_AVX512)
+		_mm512_stream_si512((__m512i*)(output + pctr), _mm512_xor_si512(_mm512_load_si512((const __m512i*)(output + pctr)),
+			_mm512_loadu_si512((const __m512i*)(input + pctr))));
+#elif defined(QSC_SYSTEM_HAS_AVX2)
+		_mm256_stream_si256((__m256i*)(output + pctr), _mm256_xor_si256(_mm256_load_si256((const __m256i*)(output + pctr)),
+			_mm256_loadu_si256((const __m256i*)(input + pctr))));
+#else
+		_mm_stream_si128((__m128i*)(output + pctr), _mm_xor_si128(_mm_load_si128((const __m128i*)(output + pctr)),
+			_mm_loadu_si128((const __m128i*)(input + pctr))));
+#endif
+		pctr += MEMUTILS_STREAM_BLOCK;
+	}
+
+	qsc_memutils_xor(output + pctr, input + pctr, length - pctr);
+}
+#endif
+
+size_t qsc_memutils_stream_threshold()
+{
+	return memutils_stream_length_load();
+}
+
+void qsc_memutils_stream_threshold_set(size_t length)
+{
+	memutils_stream_length_store((length != 0) ? length : QSC_MEMUTILS_STREAM_THRESHOLD);
+}
+
+void qsc_memutils_stream_copy(void* output, const void* input, size_t length)
+{
+#if defined(QSC_SYSTEM_AVX_INTRINSICS)
+	if (length >= memutils_stream_length_load())
+	{
+		memutils_stream_copy((uint8_t*)output, (const uint8_t*)input, length);
+		_mm_sfence();
+	}
+	else
+#endif
+	{
+		qsc_memutils_copy(output, input, length);
+	}
+}
+
+void qsc_memutils_stream_clear(void* output, size_t length)
+{
+#if defined(QSC_SYSTEM_AVX_INTRINSICS)
+	if (length >= memutils_stream_length_load())
+	{
+		memutils_stream_clear((uint8_t*)output, length);
+		_mm_sfence();
+	}
+	else
+#endif
+	{
+		qsc_memutils_clear(output, length);
+	}
+}
+
+void qsc_memutils_stream_xor(uint8_t* output, const uint8_t* input, size_t length)
+{
+#if defined(QSC_SYSTEM_AVX_INTRINSICS)
+	if (length >= memutils_stream_length_load())
+	{
+		memutils_stream_xor(output, input, length);
+		_mm_sfence();
+	}
+	else
+#endif
+	{
+		qsc_memutils_xor(output, input, length);
+	}
+}
+
+void qsc_memutils_stream_write(void* output, const void* input, size_t length)
+{
+#if defined(QSC_SYSTEM_AVX_INTRINSICS)
+	memutils_stream_copy((uint8_t*)output, (const uint8_t*)input, length);
+#else
+	qsc_memutils_copy(output, input, length);
+#endif
+}
+
+void qsc_memutils_stream_fence()
+{
+#if defined(QSC_SYSTEM_AVX_INTRINSICS)
+	_mm_sfence();
+#endif
+}
@@ -27,8 +27,44 @@
 * \brief Contains common memory related functions implemented using SIMD instructions
 */
 
+/*!
+* \enum qsc_memutils_cache_level
+* \brief The cache level a software prefetch loads into
+*/
+typedef enum
+{
+	qsc_memutils_cache_level_l1 = 0x00U,	/*!< Prefetch into all cache levels, the T0 hint */
+	qsc_memutils_cache_level_l2 = 0x01U,	/*!< Prefetch into the L2 cache and above, the T1 hint */
+	qsc_memutils_cache_level_l3 = 0x02U,	/*!< Prefetch into the L3 cache, the T2 hint */
+} qsc_memutils_cache_level;
+
+/**
+* \brief Pre-fetch a range of memory, issuing one prefetch per stride bytes.
+* A prefetch is a hint; it never faults, and addresses outside the array are not touched.
+*
+* \param address: [const] The array memory address
+* \param length: The number of bytes to pre-fetch
+* \param stride: The byte distance between prefetches, zero uses the cache line size
+* \param level: The cache level to pre-fetch into
+*/
+QSC_EXPORT_API void qsc_memutils_prefetch_range(const void* address, size_t length, size_t stride, qsc_memutils_cache_level level);
+
+/**
+* \brief Pre-fetch the bytes a loop will read a fixed distance ahead of its current position.
+* Prefetches span bytes starting distance bytes past the position, clipped to the end of the array,
+* so a loop that processes span bytes per iteration keeps its input distance bytes in flight.
+*
+* \param address: [const] The array memory address
+* \param length: The length of the array in bytes
+* \param position: The current byte position in the array
+* \param distance: The prefetch distance in bytes
+* \param span: The number of bytes to pre-fetch
+* \param level: The cache level to pre-fetch into
+*/
+QSC_EXPORT_API void qsc_memutils_prefetch_ahead(const void* address, size_t length, size_t position, size_t distance, size_t span, qsc_memutils_cache_level level);
+
 /**
-* \brief Pre-fetch memory to L1 cache
+* \brief Pre-fetch a range of memory to L1 cache
 *
 * \param address: The array memory address
 * \param length: The number of bytes to pre-fetch
@@ -36,7 +72,7 @@
 QSC_EXPORT_API void qsc_memutils_prefetch_l1(uint8_t* address, size_t length);
 
 /**
-* \brief Pre-fetch memory to L2 cache
+* \brief Pre-fetch a range of memory to L2 cache
 *
 * \param address: The array memory address
 * \param length: The number of bytes to pre-fetch
@@ -44,7 +80,7 @@ QSC_EXPORT_API void qsc_memutils_prefetch_l1(uint8_t* address, size_t length);
 QSC_EXPORT_API void qsc_memutils_prefetch_l2(uint8_t* address, size_t length);
 
 /**
-* \brief Pre-fetch memory to L3 cache
+* \brief Pre-fetch a range of memory to L3 cache
 *
 * \param address: The array memory address
 * \param length: The number of bytes to pre-fetch
@@ -93,6 +129,98 @@ QSC_EXPORT_API void* qsc_memutils_aligned_alloc(int32_t align, size_t length);
 */
 QSC_EXPORT_API void qsc_memutils_aligned_free(void* block);
 
+/*!
+* \def QSC_MEMUTILS_CACHE_LINE_SIZE
+* \brief The cache line size in bytes; arena objects are aligned to and padded to a multiple of this size
+*/
+#define QSC_MEMUTILS_CACHE_LINE_SIZE 64
+
+/*!
+* \def QSC_MEMUTILS_ARENA_THREAD_CACHE
+* \brief The number of released objects a thread keeps in its private free-list before returning them to the shared free-list
+*/
+#define QSC_MEMUTILS_ARENA_THREAD_CACHE 32
+
+/*!
+* \def QSC_MEMUTILS_ARENA_THREAD_ARENAS
+* \brief The number of arenas a thread can keep private free-lists for at one time
+*/
+#define QSC_MEMUTILS_ARENA_THREAD_ARENAS 8
+
+/*!
+* \def QSC_MEMUTILS_ARENA_MAX
+* \brief The maximum number of arenas that exist at one time
+*/
+#define QSC_MEMUTILS_ARENA_MAX 64
+
+/*!
+* \struct qsc_memutils_arena
+* \brief A pool of fixed-size objects in a locked memory region, that is excluded from core dumps.
+* Objects are cache-line aligned, are zeroed when released, and are allocated without locks;
+* each thread reuses the objects it released from a private free-list, backed by a lock-free shared free-list.
+*/
+QSC_EXPORT_API typedef struct
+{
+	uint8_t* base;				/*!< The object region */
+	uint32_t* links;			/*!< The free-list link of each object, the next object index + 1 */
+	size_t length;				/*!< The byte length of the object region */
+	size_t stride;				/*!< The cache-line aligned byte distance between objects */
+	uint32_t capacity;			/*!< The number of objects in the arena */
+	uint32_t id;				/*!< The unique arena identifier, used to find the private free-lists */
+	volatile uint64_t head;		/*!< The shared free-list head; a change tag and the first object index + 1 */
+	bool locked;				/*!< The region is locked in physical memory */
+} qsc_memutils_arena;
+
+/**
+* \brief Create an arena of fixed-size objects.
+* The region is page aligned, locked in memory with mlock or VirtualLock, and excluded from core dumps where the system supports it.
+* If the process memory-lock limit is exceeded the arena is still created, and the locked flag is false.
+* Creation fails if QSC_MEMUTILS_ARENA_MAX arenas already exist.
+*
+* \param arena: [struct] The arena state
+* \param objsize: The byte size of each object, rounded up to a multiple of the cache line size
+* \param count: The maximum number of objects allocated at one time
+*
+* \return Returns true if the arena was created
+*/
+QSC_EXPORT_API bool qsc_memutils_arena_create(qsc_memutils_arena* arena, size_t objsize, size_t count);
+
+/**
+* \brief Allocate a zeroed object from the arena.
+* Safe to call concurrently from multiple threads.
+*
+* \param arena: [struct] The arena state
+*
+* \return Returns a cache-line aligned object, or NULL if every object is in use
+*/
+QSC_EXPORT_API void* qsc_memutils_arena_alloc(qsc_memutils_arena* arena);
+
+/**
+* \brief Erase an object and return it to the arena.
+* Safe to call concurrently from multiple threads; the object is kept in the calling thread's private free-list.
+*
+* \param arena: [struct] The arena state
+* \param block: The object to release, returned by qsc_memutils_arena_alloc
+*/
+QSC_EXPORT_API void qsc_memutils_arena_free(qsc_memutils_arena* arena, void* block);
+
+/**
+* \brief Return the objects in the calling thread's private free-list to the shared free-list.
+* Call before a thread that released arena objects exits, otherwise those objects are unavailable until the arena is destroyed.
+*
+* \param arena: [struct] The arena state
+*/
+QSC_EXPORT_API void qsc_memutils_arena_flush(qsc_memutils_arena* arena);
+
+/**
+* \brief Erase, unlock, and release the arena memory.
+* Every object is invalidated; no thread may use the arena during or after this call.
+* Other threads need not flush first; their private free-lists for the arena are discarded when they next claim a list.
+*
+* \param arena: [struct] The arena state
+*/
+QSC_EXPORT_API void qsc_memutils_arena_destroy(qsc_memutils_arena* arena);
+
 /**
 * \brief Erase a block of memory
 *
@@ -101,6 +229,16 @@ QSC_EXPORT_API void qsc_memutils_aligned_free(void* block);
 */
 QSC_EXPORT_API void qsc_memutils_clear(void* output, size_t length);
 
+/**
+* \brief Erase a block of memory that holds secret data.
+* A vectorized clear followed by a compiler barrier, so the erasure cannot be removed as a dead store,
+* even when the memory is never read again or is released immediately after the call.
+*
+* \param output: A pointer to the memory block to erase
+* \param length: The number of bytes to erase
+*/
+QSC_EXPORT_API void qsc_memutils_secure_wipe(void* output, size_t length);
+
 /**
 * \brief Copy a block of memory
 *
@@ -146,4 +284,73 @@ QSC_EXPORT_API void qsc_memutils_xor(uint8_t* output, const uint8_t* input, size
 */
 QSC_EXPORT_API void qsc_memutils_xorv(uint8_t* output, const uint8_t value, size_t length);
 
+/*!
+* \def QSC_MEMUTILS_STREAM_THRESHOLD
+* \brief The default byte length at and above which the stream functions bypass the cache with non-temporal stores
+*/
+#if !defined(QSC_MEMUTILS_STREAM_THRESHOLD)
+#	define QSC_MEMUTILS_STREAM_THRESHOLD 4194304
+#endif
+
+/**
+* \brief Get the byte length at and above which the stream functions use non-temporal stores
+*
+* \return Returns the stream threshold in bytes
+*/
+QSC_EXPORT_API size_t qsc_memutils_stream_threshold(void);
+
+/**
+* \brief Set the byte length at and above which the stream functions use non-temporal stores.
+* Safe to call from any thread; a stream function that is already running keeps the threshold it read.
+*
+* \param length: The stream threshold in bytes, SIZE_MAX disables streaming, zero restores the default
+*/
+QSC_EXPORT_API void qsc_memutils_stream_threshold_set(size_t length);
+
+/**
+* \brief Copy a block of memory that will not be read again soon.
+* At or above the stream threshold the output is written with non-temporal stores, which do not displace
+* the contents of the cache, and the stores are fenced before returning; below it, this is qsc_memutils_copy.
+*
+* \param output: A pointer to the destination array
+* \param input: A pointer to the source array
+* \param length: The number of bytes to copy
+*/
+QSC_EXPORT_API void qsc_memutils_stream_copy(void* output, const void* input, size_t length);
+
+/**
+* \brief Erase a block of memory that will not be read again soon.
+* At or above the stream threshold the output is written with fenced non-temporal stores; below it, this is qsc_memutils_clear.
+*
+* \param output: A pointer to the memory block to erase
+* \param length: The number of bytes to erase
+*/
+QSC_EXPORT_API void qsc_memutils_stream_clear(void* output, size_t length);
+
+/**
+* \brief Bitwise XOR two blocks of memory, when the output will not be read again soon.
+* At or above the stream threshold the output is written with fenced non-temporal stores; below it, this is qsc_memutils_xor.
+*
+* \param output: A pointer to the destination array
+* \param input: A pointer to the source array
+* \param length: The number of bytes to XOR
+*/
+QSC_EXPORT_API void qsc_memutils_stream_xor(uint8_t* output, const uint8_t* input, size_t length);
+
+/**
+* \brief Copy a block of memory with non-temporal stores regardless of its length, without a fence.
+* Used to write a large output in pieces; call qsc_memutils_stream_fence after the last piece,
+* before the output is read or handed to another thread.
+*
+* \param output: A pointer to the destination array
+* \param input: A pointer to the source array
+* \param length: The number of bytes to copy
+*/
+QSC_EXPORT_API void qsc_memutils_stream_write(void* output, const void* input, size_t length);
+
+/**
+* \brief Order the preceding non-temporal stores before any following store
+*/
+QSC_EXPORT_API void qsc_memutils_stream_fence(void);
+
 #endif
@@ -0,0 +1,290 @@
+#include "memutils_test.h"
+#include "async.h"
+#include "memutils.h"
+#include "testutils.h"
+
+/* the object size is deliberately not a multiple of the cache line size */
+#define MEMUTILS_ARENA_OBJECT_SIZE 200
+/* one release more than the private free-list holds, forces a spill to the shared free-list */
+#define MEMUTILS_ARENA_SPILL (QSC_MEMUTILS_ARENA_THREAD_CACHE + 1)
+
+typedef struct
+{
+	qsc_memutils_arena* arenas;
+	uint8_t* blk;
+} memutils_test_state;
+
+static void memutils_test_destroy(void* state)
+{
+	memutils_test_state* ctx;
+
+	ctx = (memutils_test_state*)state;
+
+	for (size_t i = 0; i < QSC_MEMUTILS_ARENA_THREAD_ARENAS; ++i)
+	{
+		qsc_memutils_arena_destroy(&ctx->arenas[i]);
+	}
+}
+
+static void memutils_test_alloc(void* state)
+{
+	memutils_test_state* ctx;
+
+	ctx = (memutils_test_state*)state;
+	ctx->blk = (uint8_t*)qsc_memutils_arena_alloc(ctx->arenas);
+}
+
+static bool memutils_is_zero(const uint8_t* block, size_t length)
+{
+	uint8_t acc;
+
+	acc = 0;
+
+	for (size_t i = 0; i < length; ++i)
+	{
+		acc |= block[i];
+	}
+
+	return (acc == 0);
+}
+
+bool qsctest_memutils_arena()
+{
+	qsc_memutils_arena arena;
+	uint8_t* objs[QSCTEST_MEMUTILS_ARENA_OBJECTS];
+	bool res;
+
+	res = true;
+
+	if (qsc_memutils_arena_create(&arena, MEMUTILS_ARENA_OBJECT_SIZE, QSCTEST_MEMUTILS_ARENA_OBJECTS) == false)
+	{
+		qsctest_print_safe("Failure! qsctest_memutils_arena: the arena could not be created -MA1 \n");
+		return false;
+	}
+
+	for (size_t i = 0; i < QSCTEST_MEMUTILS_ARENA_OBJECTS; ++i)
+	{
+		objs[i] = (uint8_t*)qsc_memutils_arena_alloc(&arena);
+
+		if (objs[i] == NULL || ((uintptr_t)objs[i] % QSC_MEMUTILS_CACHE_LINE_SIZE) != 0 ||
+			memutils_is_zero(objs[i], MEMUTILS_ARENA_OBJECT_SIZE) == false)
+		{
+			qsctest_print_safe("Failure! qsctest_memutils_arena: an object is missing, misaligned, or not zeroed -MA2 \n");
+			res = false;
+			break;
+		}
+
+		for (size_t j = 0; j < i; ++j)
+		{
+			if (objs[j] == objs[i])
+			{
+				qsctest_print_safe("Failure! qsctest_memutils_arena: an object was allocated twice -MA3 \n");
+				res = false;
+				break;
+			}
+		}
+
+		/* mark the object, the mark must be erased on release */
+		qsc_memutils_setvalue(objs[i], 0xA5U, MEMUTILS_ARENA_OBJECT_SIZE);
+	}
+
+	if (res == true && qsc_memutils_arena_alloc(&arena) != NULL)
+	{
+		qsctest_print_safe("Failure! qsctest_memutils_arena: an exhausted arena returned an object -MA4 \n");
+		res = false;
+	}
+
+	if (res == true)
+	{
+		for (size_t i = 0; i < QSCTEST_MEMUTILS_ARENA_OBJECTS; ++i)
+		{
+			qsc_memutils_arena_free(&arena, objs[i]);
+		}
+
+		qsc_memutils_arena_flush(&arena);
+
+		for (size_t i = 0; i < QSCTEST_MEMUTILS_ARENA_OBJECTS; ++i)
+		{
+			objs[i] = (uint8_t*)qsc_memutils_arena_alloc(&arena);
+
+			if (objs[i] == NULL || memutils_is_zero(objs[i], MEMUTILS_ARENA_OBJECT_SIZE) == false)
+			{
+				qsctest_print_safe("Failure! qsctest_memutils_arena: a released object was not erased or returned -MA5 \n");
+				res = false;
+				break;
+			}
+		}
+	}
+
+	qsc_memutils_arena_destroy(&arena);
+
+	return res;
+}
+
+bool qsctest_memutils_arena_spill()
+{
+	qsc_memutils_arena arena;
+	uint8_t* objs[MEMUTILS_ARENA_SPILL];
+	uint8_t* blk;
+	bool res;
+
+	res = true;
+
+	if (qsc_memutils_arena_create(&arena, MEMUTILS_ARENA_OBJECT_SIZE, QSCTEST_MEMUTILS_ARENA_OBJECTS) == false)
+	{
+		qsctest_print_safe("Failure! qsctest_memutils_arena_spill: the arena could not be created -MS1 \n");
+		return false;
+	}
+
+	for (size_t i = 0; i < MEMUTILS_ARENA_SPILL; ++i)
+	{
+		objs[i] = (uint8_t*)qsc_memutils_arena_alloc(&arena);
+
+		if (objs[i] == NULL)
+		{
+			qsctest_print_safe("Failure! qsctest_memutils_arena_spill: an object could not be allocated -MS2 \n");
+			res = false;
+			break;
+		}
+	}
+
+	if (res == true)
+	{
+		/* the last release overflows the private free-list */
+		for (size_t i = 0; i < MEMUTILS_ARENA_SPILL; ++i)
+		{
+			qsc_memutils_arena_free(&arena, objs[i]);
+		}
+
+		/* the private free-list keeps the newest half, so it returns them newest first */
+		for (size_t i = 0; i < QSC_MEMUTILS_ARENA_THREAD_CACHE / 2; ++i)
+		{
+			blk = (uint8_t*)qsc_memutils_arena_alloc(&arena);
+
+			if (blk != objs[MEMUTILS_ARENA_SPILL - 1 - i])
+			{
+				qsctest_print_safe("Failure! qsctest_memutils_arena_spill: the private free-list did not keep the most recently released objects -MS3 \n");
+				res = false;
+				break;
+			}
+		}
+	}
+
+	qsc_memutils_arena_flush(&arena);
+	qsc_memutils_arena_destroy(&arena);
+
+	return res;
+}
+
+bool qsctest_memutils_arena_reclaim()
+{
+	qsc_memutils_arena arenas[QSC_MEMUTILS_ARENA_THREAD_ARENAS];
+	qsc_memutils_arena arena;
+	memutils_test_state state;
+	qsc_thread handle;
+	uint8_t* blk;
+	size_t i;
+	bool res;
+
+	res = true;
+
+	/* every private free-list entry of this thread is claimed by an arena */
+	for (i = 0; i < QSC_MEMUTILS_ARENA_THREAD_ARENAS; ++i)
+	{
+		if (qsc_memutils_arena_create(&arenas[i], MEMUTILS_ARENA_OBJECT_SIZE, QSCTEST_MEMUTILS_ARENA_OBJECTS) == false)
+		{
+			qsctest_print_safe("Failure! qsctest_memutils_arena_reclaim: the arena could not be created -MR1 \n");
+			res = false;
+			break;
+		}
+
+		blk = (uint8_t*)qsc_memutils_arena_alloc(&arenas[i]);
+		qsc_memutils_arena_free(&arenas[i], blk);
+	}
+
+	if (res == false)
+	{
+		while (i > 0)
+		{
+			--i;
+			qsc_memutils_arena_destroy(&arenas[i]);
+		}
+
+		return false;
+	}
+
+	/* the arenas are destroyed on another thread, without a flush on this one */
+	state.arenas = arenas;
+	state.blk = NULL;
+
+	if (qsc_async_thread_create(&handle, memutils_test_destroy, &state) == false)
+	{
+		qsctest_print_safe("Failure! qsctest_memutils_arena_reclaim: a thread could not be created -MR2 \n");
+		memutils_test_destroy(&state);
+		return false;
+	}
+
+	qsc_async_thread_wait(&handle);
+
+	if (qsc_memutils_arena_create(&arena, MEMUTILS_ARENA_OBJECT_SIZE, QSCTEST_MEMUTILS_ARENA_OBJECTS) == false)
+	{
+		qsctest_print_safe("Failure! qsctest_memutils_arena_reclaim: the arena could not be created -MR3 \n");
+		return false;
+	}
+
+	/* the release must reclaim an entry left by a destroyed arena, keeping the object private to this thread */
+	blk = (uint8_t*)qsc_memutils_arena_alloc(&arena);
+	qsc_memutils_arena_free(&arena, blk);
+	state.arenas = &arena;
+
+	if (qsc_async_thread_create(&handle, memutils_test_alloc, &state) == false)
+	{
+		qsctest_print_safe("Failure! qsctest_memutils_arena_reclaim: a thread could not be created -MR4 \n");
+		res = false;
+	}
+	else
+	{
+		qsc_async_thread_wait(&handle);
+
+		if (state.blk == NULL || state.blk == blk)
+		{
+			qsctest_print_safe("Failure! qsctest_memutils_arena_reclaim: a stale private free-list was not reclaimed -MR5 \n");
+			res = false;
+		}
+	}
+
+	qsc_memutils_arena_flush(&arena);
+	qsc_memutils_arena_destroy(&arena);
+
+	return res;
+}
+
+void qsctest_memutils_run()
+{
+	if (qsctest_memutils_arena() == true)
+	{
+		qsctest_print_safe("Success! Passed the secure arena allocation test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the secure arena allocation test. \n");
+	}
+
+	if (qsctest_memutils_arena_spill() == true)
+	{
+		qsctest_print_safe("Success! Passed the secure arena spill test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the secure arena spill test. \n");
+	}
+
+	if (qsctest_memutils_arena_reclaim() == true)
+	{
+		qsctest_print_safe("Success! Passed the secure arena reclaim test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the secure arena reclaim test. \n");
+	}
+}
@@ -0,0 +1,49 @@
+/**
+* \file memutils_test.h
+* \brief <b>Memory utility tests</b> \n
+* Tests the secure arena for distinct, aligned, and zeroed objects, and checks that a thread's private free-list
+* keeps its most recently released objects when it overflows to the shared free-list, and that private free-lists
+* left by arenas destroyed on another thread are reclaimed.
+*/
+
+#ifndef QSCTEST_MEMUTILS_TEST_H
+#define QSCTEST_MEMUTILS_TEST_H
+
+#include "common.h"
+
+/*!
+* \def QSCTEST_MEMUTILS_ARENA_OBJECTS
+* \brief The number of objects in the test arena
+*/
+#define QSCTEST_MEMUTILS_ARENA_OBJECTS 64
+
+/**
+* \brief Allocates every object in an arena, and checks the objects are distinct, aligned, and zeroed,
+* that the arena reports exhaustion, and that released objects are erased before they are reused.
+*
+* \return Returns true for success
+*/
+bool qsctest_memutils_arena(void);
+
+/**
+* \brief Releases one object more than the private free-list holds, and checks that the next allocations
+* return the most recently released objects in reverse order.
+*
+* \return Returns true for success
+*/
+bool qsctest_memutils_arena_spill(void);
+
+/**
+* \brief Fills the private free-list entries of a thread, destroys those arenas on another thread, and checks
+* that a new arena reclaims an entry so its released objects stay private to the releasing thread.
+*
+* \return Returns true for success
+*/
+bool qsctest_memutils_arena_reclaim(void);
+
+/**
+* \brief Run all tests.
+*/
+void qsctest_memutils_run(void);
+
+#endif
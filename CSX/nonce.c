@@ -0,0 +1,449 @@
+#include "nonce.h"
+#include "csp.h"
+#include "intutils.h"
+#include "memutils.h"
+#include "stringutils.h"
+#include <errno.h>
+#include <stdio.h>
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+#	include <Windows.h>
+#	include <io.h>
+#else
+#	include <fcntl.h>
+#	include <unistd.h>
+#	if defined(QSC_SYSTEM_OS_POSIX)
+#		include <pthread.h>
+#	endif
+#endif
+
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+#	define NONCE_THREAD_LOCAL __declspec(thread)
+#else
+#	define NONCE_THREAD_LOCAL __thread
+#endif
+
+/* the high-water mark record: the magic, the prefix, and the mark, little-endian */
+#define NONCE_RECORD_MAGIC 0x4E585343UL
+#define NONCE_RECORD_SIZE (sizeof(uint32_t) + QSC_NONCE_PREFIX_SIZE + sizeof(uint64_t))
+/* the block counter bytes of a nonce, left zero */
+#define NONCE_BLOCK_OFFSET 4
+#define NONCE_COUNTER_OFFSET 8
+#define NONCE_TEMP_EXTENSION ".tmp"
+
+typedef struct
+{
+	uint64_t id;	/* the allocator the block was reserved from */
+	uint64_t next;	/* the next counter to issue */
+	uint64_t end;	/* the first counter past the block */
+} nonce_thread_block;
+
+static NONCE_THREAD_LOCAL nonce_thread_block nonce_blocks[QSC_NONCE_THREAD_ALLOCATORS];
+/* allocator identifiers are never reused, so a block cached for a disposed allocator can never be matched */
+static volatile uint64_t nonce_next_id = 0;
+/* incremented in the child process by the fork handler, it invalidates every inherited allocator */
+static volatile uint32_t nonce_fork_generation = 0;
+
+#if defined(QSC_SYSTEM_OS_POSIX)
+static pthread_once_t nonce_fork_once = PTHREAD_ONCE_INIT;
+
+static void nonce_fork_child()
+{
+	++nonce_fork_generation;
+}
+
+static void nonce_fork_register()
+{
+	pthread_atfork(NULL, NULL, nonce_fork_child);
+}
+#endif
+
+static uint64_t nonce_atomic_add64(volatile uint64_t* target, uint64_t value)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	return (uint64_t)InterlockedExchangeAdd64((volatile LONG64*)target, (LONG64)value);
+#else
+	return __atomic_fetch_add(target, value, __ATOMIC_RELAXED);
+#endif
+}
+
+static uint64_t nonce_atomic_load64(volatile uint64_t* target)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	/* a compare with an unlikely value is an atomic 64-bit read on 32-bit targets */
+	return (uint64_t)InterlockedCompareExchange64((volatile LONG64*)target, 0, 0);
+#else
+	return __atomic_load_n(target, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static void nonce_atomic_store64(volatile uint64_t* target, uint64_t value)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	InterlockedExchange64((volatile LONG64*)target, (LONG64)value);
+#else
+	__atomic_store_n(target, value, __ATOMIC_RELEASE);
+#endif
+}
+
+static bool nonce_atomic_cas32(volatile uint32_t* target, uint32_t expected, uint32_t desired)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	return ((uint32_t)InterlockedCompareExchange((volatile LONG*)target, (LONG)desired, (LONG)expected) == expected);
+#else
+	return __atomic_compare_exchange_n(target, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static void nonce_atomic_store32(volatile uint32_t* target, uint32_t value)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	InterlockedExchange((volatile LONG*)target, (LONG)value);
+#else
+	__atomic_store_n(target, value, __ATOMIC_RELEASE);
+#endif
+}
+
+static void nonce_pause()
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	YieldProcessor();
+#elif defined(QSC_SYSTEM_ARCH_X86_X64)
+	__builtin_ia32_pause();
+#endif
+}
+
+#if !defined(QSC_SYSTEM_OS_WINDOWS)
+static bool nonce_directory_sync(const char* path)
+{
+	char dir[QSC_NONCE_PATH_MAX] = { 0 };
+	size_t pos;
+	int fd;
+	bool res;
+
+	res = false;
+	pos = 0;
+
+	/* the directory is the path up to the last separator, or the working directory */
+	for (size_t i = 0; i < QSC_NONCE_PATH_MAX - 1 && path[i] != 0; ++i)
+	{
+		dir[i] = path[i];
+
+		if (path[i] == '/')
+		{
+			pos = i;
+		}
+	}
+
+	if (dir[pos] == '/')
+	{
+		/* keep the root separator */
+		dir[(pos != 0) ? pos : 1] = 0;
+	}
+	else
+	{
+		dir[0] = '.';
+		dir[1] = 0;
+	}
+
+	fd = open(dir, O_RDONLY);
+
+	if (fd >= 0)
+	{
+		res = (fsync(fd) == 0);
+		res = (close(fd) == 0) && res;
+	}
+
+	return res;
+}
+#endif
+
+static bool nonce_mark_write(const qsc_nonce_allocator* ctx, uint64_t mark)
+{
+	char tmp[QSC_NONCE_PATH_MAX + sizeof(NONCE_TEMP_EXTENSION)] = { 0 };
+	uint8_t rec[NONCE_RECORD_SIZE];
+	FILE* fp;
+	size_t plen;
+	bool res;
+
+	res = false;
+	plen = qsc_stringutils_string_size(ctx->path);
+	qsc_intutils_le32to8(rec, NONCE_RECORD_MAGIC);
+	qsc_memutils_copy(rec + sizeof(uint32_t), ctx->prefix, QSC_NONCE_PREFIX_SIZE);
+	qsc_intutils_le64to8(rec + sizeof(uint32_t) + QSC_NONCE_PREFIX_SIZE, mark);
+
+	/* the record is written to a temporary file and renamed over the original,
+	   so a crash leaves either the previous or the new mark, never a partial record */
+	if (plen != 0 && plen < QSC_NONCE_PATH_MAX)
+	{
+		/* the temporary file is beside the mark file, so the rename stays within one directory */
+		qsc_memutils_copy(tmp, ctx->path, plen);
+		qsc_memutils_copy(tmp + plen, NONCE_TEMP_EXTENSION, sizeof(NONCE_TEMP_EXTENSION));
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+		if (fopen_s(&fp, tmp, "wb") != 0)
+		{
+			fp = NULL;
+		}
+#else
+		fp = fopen(tmp, "wb");
+#endif
+
+		if (fp != NULL)
+		{
+			res = (fwrite(rec, 1, sizeof(rec), fp) == sizeof(rec));
+			res = (fflush(fp) == 0) && res;
+			/* the mark must be on disk before any counter below it is issued;
+			   fflush only empties the C runtime buffer into the operating system */
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+			res = (FlushFileBuffers((HANDLE)_get_osfhandle(_fileno(fp))) != 0) && res;
+#else
+			res = (fsync(fileno(fp)) == 0) && res;
+#endif
+			res = (fclose(fp) == 0) && res;
+
+			if (res == true)
+			{
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+				/* write-through returns after the move is flushed to disk */
+				res = (MoveFileExA(tmp, ctx->path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+#else
+				/* a rename is only durable once the directory is synced;
+				   the first write of a mark creates the file through the same rename */
+				res = (rename(tmp, ctx->path) == 0);
+				res = res && nonce_directory_sync(ctx->path);
+#endif
+			}
+		}
+	}
+
+	return res;
+}
+
+static bool nonce_mark_read(qsc_nonce_allocator* ctx, uint64_t* mark, bool* found)
+{
+	uint8_t rec[NONCE_RECORD_SIZE + 1];
+	FILE* fp;
+	size_t rlen;
+	bool res;
+
+	*found = false;
+	*mark = 0;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	if (fopen_s(&fp, ctx->path, "rb") != 0)
+	{
+		fp = NULL;
+	}
+#else
+	fp = fopen(ctx->path, "rb");
+#endif
+
+	if (fp != NULL)
+	{
+		/* one byte more than a record is requested, so a longer file is rejected */
+		rlen = fread(rec, 1, sizeof(rec), fp);
+		fclose(fp);
+		res = (rlen == NONCE_RECORD_SIZE && qsc_intutils_le8to32(rec) == NONCE_RECORD_MAGIC);
+
+		if (res == true)
+		{
+			qsc_memutils_copy(ctx->prefix, rec + sizeof(uint32_t), QSC_NONCE_PREFIX_SIZE);
+			*mark = qsc_intutils_le8to64(rec + sizeof(uint32_t) + QSC_NONCE_PREFIX_SIZE);
+			*found = true;
+		}
+	}
+	else
+	{
+		/* only a missing file starts a new sequence; any other error could hide a mark */
+		res = (errno == ENOENT);
+	}
+
+	return res;
+}
+
+static bool nonce_lease_extend(qsc_nonce_allocator* ctx, uint64_t end)
+{
+	uint64_t mark;
+	bool res;
+
+	res = true;
+
+	/* one thread writes the new mark, the others wait for it; the shared counter is never locked */
+	if (nonce_atomic_cas32(&ctx->leasing, 0, 1) == true)
+	{
+		if (end > nonce_atomic_load64(&ctx->limit))
+		{
+			mark = (end <= UINT64_MAX - QSC_NONCE_LEASE_SIZE) ? end + QSC_NONCE_LEASE_SIZE : UINT64_MAX;
+			res = nonce_mark_write(ctx, mark);
+
+			if (res == true)
+			{
+				nonce_atomic_store64(&ctx->limit, mark);
+			}
+		}
+
+		nonce_atomic_store32(&ctx->leasing, 0);
+	}
+	else
+	{
+		nonce_pause();
+	}
+
+	return res;
+}
+
+static nonce_thread_block* nonce_block_find(uint64_t id)
+{
+	nonce_thread_block blk;
+	size_t i;
+
+	/* the blocks are kept in most recently used order; a matching block is moved to the front, and an
+	   allocator without a block takes the least recently used one, so any QSC_NONCE_THREAD_ALLOCATORS
+	   allocators used by one thread keep their blocks, and the block of a disposed allocator ages out */
+	for (i = 0; i < QSC_NONCE_THREAD_ALLOCATORS - 1; ++i)
+	{
+		if (nonce_blocks[i].id == id)
+		{
+			break;
+		}
+	}
+
+	if (i != 0)
+	{
+		blk = nonce_blocks[i];
+
+		for (; i != 0; --i)
+		{
+			nonce_blocks[i] = nonce_blocks[i - 1];
+		}
+
+		nonce_blocks[0] = blk;
+	}
+
+	return &nonce_blocks[0];
+}
+
+static bool nonce_block_reserve(qsc_nonce_allocator* ctx, nonce_thread_block* block)
+{
+	uint64_t base;
+	bool res;
+
+	base = nonce_atomic_add64(&ctx->next, QSC_NONCE_BLOCK_SIZE);
+	res = (base <= UINT64_MAX - QSC_NONCE_BLOCK_SIZE);
+
+	while (res == true && base + QSC_NONCE_BLOCK_SIZE > nonce_atomic_load64(&ctx->limit))
+	{
+		res = nonce_lease_extend(ctx, base + QSC_NONCE_BLOCK_SIZE);
+	}
+
+	if (res == true)
+	{
+		block->id = ctx->id;
+		block->next = base;
+		block->end = base + QSC_NONCE_BLOCK_SIZE;
+	}
+
+	return res;
+}
+
+bool qsc_nonce_initialize(qsc_nonce_allocator* ctx, const char* path)
+{
+	assert(ctx != NULL);
+
+	uint64_t mark;
+	bool found;
+	bool res;
+
+	res = false;
+
+	if (ctx != NULL)
+	{
+#if defined(QSC_SYSTEM_OS_POSIX)
+		pthread_once(&nonce_fork_once, nonce_fork_register);
+#endif
+		qsc_memutils_clear(ctx, sizeof(qsc_nonce_allocator));
+		ctx->id = nonce_atomic_add64(&nonce_next_id, 1) + 1;
+		ctx->generation = nonce_fork_generation;
+		found = false;
+		mark = 0;
+
+		if (path == NULL)
+		{
+			ctx->limit = UINT64_MAX;
+			res = qsc_csp_generate(ctx->prefix, QSC_NONCE_PREFIX_SIZE);
+		}
+		else if (qsc_stringutils_string_size(path) > 0 && qsc_stringutils_string_size(path) < QSC_NONCE_PATH_MAX)
+		{
+			qsc_memutils_copy(ctx->path, path, qsc_stringutils_string_size(path));
+			res = nonce_mark_read(ctx, &mark, &found);
+
+			if (res == true && found == false)
+			{
+				res = qsc_csp_generate(ctx->prefix, QSC_NONCE_PREFIX_SIZE);
+			}
+
+			if (res == true)
+			{
+				/* every counter the previous process could have issued is below the stored mark */
+				ctx->next = mark;
+				ctx->limit = mark;
+				res = (mark <= UINT64_MAX - QSC_NONCE_BLOCK_SIZE) && nonce_lease_extend(ctx, mark + QSC_NONCE_BLOCK_SIZE);
+			}
+		}
+
+		if (res == false)
+		{
+			qsc_memutils_clear(ctx, sizeof(qsc_nonce_allocator));
+		}
+	}
+
+	return res;
+}
+
+bool qsc_nonce_generate(qsc_nonce_allocator* ctx, uint8_t* nonce)
+{
+	assert(ctx != NULL);
+	assert(nonce != NULL);
+
+	nonce_thread_block* block;
+	bool res;
+
+	res = false;
+
+	if (ctx != NULL && nonce != NULL && ctx->id != 0 && ctx->generation == nonce_fork_generation)
+	{
+		block = nonce_block_find(ctx->id);
+		res = true;
+
+		if (block->id != ctx->id || block->next == block->end)
+		{
+			res = nonce_block_reserve(ctx, block);
+		}
+
+		if (res == true)
+		{
+			qsc_memutils_clear(nonce, NONCE_BLOCK_OFFSET);
+			qsc_memutils_copy(nonce + NONCE_BLOCK_OFFSET, ctx->prefix, QSC_NONCE_PREFIX_SIZE);
+			qsc_intutils_le64to8(nonce + NONCE_COUNTER_OFFSET, block->next);
+			++block->next;
+		}
+	}
+
+	return res;
+}
+
+void qsc_nonce_dispose(qsc_nonce_allocator* ctx)
+{
+	assert(ctx != NULL);
+
+	if (ctx != NULL)
+	{
+		/* every issued counter is below the next unreserved block */
+		if (ctx->id != 0 && ctx->path[0] != 0 && ctx->generation == nonce_fork_generation)
+		{
+			nonce_mark_write(ctx, ctx->next);
+		}
+
+		qsc_memutils_clear(ctx, sizeof(qsc_nonce_allocator));
+	}
+}
@@ -0,0 +1,144 @@
+/* The AGPL version 3 License (AGPLv3)
+*
+* Copyright (c) 2021 Digital Freedom Defence Inc.
+* This file is part of the QSC Cryptographic library
+*
+* This program is free software : you can redistribute it and / or modify
+* it under the terms of the GNU Affero General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef QSC_NONCE_H
+#define QSC_NONCE_H
+
+/**
+* \file nonce.h
+* \brief Unique nonce allocator for CSX-512 sessions
+* Issues QSC_CSX_NONCE_SIZE nonces that never repeat under one allocator, from any number of threads, without locks.
+* Each thread reserves a block of QSC_NONCE_BLOCK_SIZE counters with a single atomic add,
+* and issues nonces from its block with no shared memory access.
+*
+* \par
+* The CSX-512 nonce is the initial value of the 128-bit block counter, so consecutive nonces must be spaced
+* further apart than the longest message. A nonce is laid out as: \n
+* bytes 0-3: zero, the block counter range of one message, up to 2^32 blocks (512 GiB) \n
+* bytes 4-7: the allocator prefix, random unless restored from the high-water mark file \n
+* bytes 8-15: the 64-bit allocation counter, little-endian
+*
+* \par
+* When the allocator is given a file path, the prefix and a high-water mark are persisted,
+* and no counter at or above the persisted mark is issued. The mark is advanced QSC_NONCE_LEASE_SIZE counters at a time,
+* written to a temporary file and renamed over the original, so a restarted process resumes above every counter the
+* previous process could have issued, even after a crash. Without a file, uniqueness across processes that share
+* a key relies on the random 32-bit prefix alone.
+*
+* \par
+* An allocator must be used in the process that initialized it; after a fork, the child's copy refuses to issue nonces.
+*
+* Example \n
+* \code
+* qsc_nonce_allocator alloc;
+* uint8_t nonce[QSC_CSX_NONCE_SIZE];
+*
+* if (qsc_nonce_initialize(&alloc, "/var/lib/app/csx.nonce") == true)
+* {
+*	// any thread
+*	qsc_nonce_generate(&alloc, nonce);
+*	qsc_csx_keyparams kp = { key, QSC_CSX_KEY_SIZE, nonce, NULL, 0 };
+*	...
+*	qsc_nonce_dispose(&alloc);
+* }
+* \endcode
+*/
+
+#include "common.h"
+#include "csx.h"
+
+/*!
+* \def QSC_NONCE_BLOCK_SIZE
+* \brief The number of counters a thread reserves with each atomic update of the shared counter
+*/
+#define QSC_NONCE_BLOCK_SIZE 4096
+
+/*!
+* \def QSC_NONCE_LEASE_SIZE
+* \brief The number of counters the persisted high-water mark is advanced by, each time it is written
+*/
+#define QSC_NONCE_LEASE_SIZE 4294967296ULL
+
+/*!
+* \def QSC_NONCE_PATH_MAX
+* \brief The maximum length of the high-water mark file path, including the terminator
+*/
+#define QSC_NONCE_PATH_MAX 260
+
+/*!
+* \def QSC_NONCE_PREFIX_SIZE
+* \brief The byte size of the allocator prefix
+*/
+#define QSC_NONCE_PREFIX_SIZE 4
+
+/*!
+* \def QSC_NONCE_THREAD_ALLOCATORS
+* \brief The number of allocators each thread caches a counter block for; the least recently used block is replaced
+*/
+#define QSC_NONCE_THREAD_ALLOCATORS 4
+
+/*!
+* \struct qsc_nonce_allocator
+* \brief The nonce allocator state, shared by every thread that issues nonces from it
+*/
+QSC_EXPORT_API typedef struct
+{
+	volatile uint64_t next;					/*!< The first counter not yet reserved by a thread */
+	volatile uint64_t limit;				/*!< The persisted high-water mark, counters below it may be issued */
+	volatile uint32_t leasing;				/*!< Set while a thread writes a new high-water mark */
+	uint64_t id;							/*!< The process-unique allocator identifier, keys the thread block caches */
+	uint32_t generation;					/*!< The fork generation the allocator was initialized in */
+	uint8_t prefix[QSC_NONCE_PREFIX_SIZE];	/*!< The allocator prefix */
+	char path[QSC_NONCE_PATH_MAX];			/*!< The high-water mark file path, empty if not persisted */
+} qsc_nonce_allocator;
+
+/**
+* \brief Initialize a nonce allocator.
+* With a path, the prefix and the high-water mark are read from the file if it exists, or a random prefix is
+* generated if it does not, and the first lease is written before the function returns.
+* A file that exists but cannot be read, or is not a high-water mark record, fails the initialization.
+*
+* \param ctx: [struct] The allocator state
+* \param path: [const] The high-water mark file path, or NULL for an allocator that is not persisted
+* \return Returns true if the allocator is ready
+*/
+QSC_EXPORT_API bool qsc_nonce_initialize(qsc_nonce_allocator* ctx, const char* path);
+
+/**
+* \brief Issue a unique nonce. Safe to call from any number of threads at once.
+* Most calls touch only the calling thread's counter block; one call in QSC_NONCE_BLOCK_SIZE reserves a new block,
+* and a persisted allocator writes the high-water mark file once every QSC_NONCE_LEASE_SIZE nonces.
+*
+* \param ctx: [struct] The allocator state
+* \param nonce: [out] The QSC_CSX_NONCE_SIZE nonce
+* \return Returns false if the high-water mark could not be written, the counter is exhausted,
+* or the allocator was inherited across a fork
+*/
+QSC_EXPORT_API bool qsc_nonce_generate(qsc_nonce_allocator* ctx, uint8_t* nonce);
+
+/**
+* \brief Dispose of a nonce allocator.
+* A persisted allocator lowers the high-water mark to the first unreserved counter.
+* No thread may issue nonces from the allocator during or after the call.
+*
+* \param ctx: [struct] The allocator state
+*/
+QSC_EXPORT_API void qsc_nonce_dispose(qsc_nonce_allocator* ctx);
+
+#endif
@@ -0,0 +1,301 @@
+#include "nonce_test.h"
+#include "async.h"
+#include "intutils.h"
+#include "memutils.h"
+#include "nonce.h"
+#include "testutils.h"
+#include "timerex.h"
+#include <stdio.h>
+
+#define NONCE_TEST_PATH "qsctest_nonce.dat"
+#define NONCE_TEST_TEMP_PATH "qsctest_nonce.dat.tmp"
+#define NONCE_TEST_SEQUENCE 10000
+/* every counter the stress test can issue, including a partly used block per thread */
+#define NONCE_TEST_RANGE ((QSCTEST_NONCE_THREADS * QSCTEST_NONCE_ALLOCATIONS) + (QSCTEST_NONCE_THREADS * QSC_NONCE_BLOCK_SIZE))
+
+typedef struct
+{
+	qsc_nonce_allocator* alloc;
+	volatile uint64_t* bitmap;
+	const uint8_t* prefix;
+	bool res;
+} nonce_test_state;
+
+static bool nonce_test_mark(volatile uint64_t* bitmap, uint64_t counter)
+{
+	const uint64_t BIT = 1ULL << (counter & 63);
+	uint64_t prev;
+
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	prev = (uint64_t)InterlockedOr64((volatile LONG64*)&bitmap[counter >> 6], (LONG64)BIT);
+#else
+	prev = __atomic_fetch_or(&bitmap[counter >> 6], BIT, __ATOMIC_RELAXED);
+#endif
+
+	/* the bit was clear if this is the first time the counter was issued */
+	return ((prev & BIT) == 0);
+}
+
+static uint64_t nonce_test_counter(const uint8_t* nonce)
+{
+	return qsc_intutils_le8to64(nonce + 8);
+}
+
+static void nonce_test_worker(void* state)
+{
+	nonce_test_state* ctx;
+	uint8_t nonce[QSC_CSX_NONCE_SIZE];
+	uint64_t counter;
+
+	ctx = (nonce_test_state*)state;
+	ctx->res = true;
+
+	for (size_t i = 0; i < QSCTEST_NONCE_ALLOCATIONS; ++i)
+	{
+		if (qsc_nonce_generate(ctx->alloc, nonce) == false)
+		{
+			ctx->res = false;
+			break;
+		}
+
+		counter = nonce_test_counter(nonce);
+
+		if (counter >= NONCE_TEST_RANGE || qsc_intutils_le8to32(nonce) != 0 ||
+			qsc_intutils_are_equal8(nonce + 4, ctx->prefix, QSC_NONCE_PREFIX_SIZE) == false ||
+			nonce_test_mark(ctx->bitmap, counter) == false)
+		{
+			ctx->res = false;
+			break;
+		}
+	}
+}
+
+static bool nonce_test_sequence(qsc_nonce_allocator* alloc, uint64_t* maximum)
+{
+	uint8_t nonce[QSC_CSX_NONCE_SIZE];
+	bool res;
+
+	res = true;
+	*maximum = 0;
+
+	for (size_t i = 0; i < NONCE_TEST_SEQUENCE && res == true; ++i)
+	{
+		res = qsc_nonce_generate(alloc, nonce);
+
+		if (res == true && nonce_test_counter(nonce) > *maximum)
+		{
+			*maximum = nonce_test_counter(nonce);
+		}
+	}
+
+	return res;
+}
+
+bool qsctest_nonce_stress()
+{
+	nonce_test_state state[QSCTEST_NONCE_THREADS];
+	qsc_thread handles[QSCTEST_NONCE_THREADS];
+	qsc_nonce_allocator alloc;
+	volatile uint64_t* bitmap;
+	uint64_t start;
+	uint64_t elapsed;
+	size_t i;
+	bool res;
+
+	res = false;
+	bitmap = (volatile uint64_t*)qsc_memutils_malloc(((NONCE_TEST_RANGE / 64) + 1) * sizeof(uint64_t));
+
+	if (bitmap != NULL && qsc_nonce_initialize(&alloc, NULL) == true)
+	{
+		qsc_memutils_clear((uint8_t*)bitmap, ((NONCE_TEST_RANGE / 64) + 1) * sizeof(uint64_t));
+		res = true;
+		start = qsc_timerex_monotonic_ns();
+
+		for (i = 0; i < QSCTEST_NONCE_THREADS; ++i)
+		{
+			state[i].alloc = &alloc;
+			state[i].bitmap = bitmap;
+			state[i].prefix = alloc.prefix;
+			state[i].res = false;
+
+			if (qsc_async_thread_create(&handles[i], nonce_test_worker, &state[i]) == false)
+			{
+				qsctest_print_safe("Failure! qsctest_nonce_stress: a thread could not be created -NS1 \n");
+				res = false;
+				break;
+			}
+		}
+
+		while (i > 0)
+		{
+			--i;
+			qsc_async_thread_wait(&handles[i]);
+
+			if (state[i].res == false)
+			{
+				qsctest_print_safe("Failure! qsctest_nonce_stress: a nonce was issued twice or is malformed -NS2 \n");
+				res = false;
+			}
+		}
+
+		elapsed = qsc_timerex_stopwatch_elapsed_ns(start);
+
+		if (res == true && elapsed != 0)
+		{
+			qsctest_print_safe("Allocated and checked ");
+			qsctest_print_ulong(QSCTEST_NONCE_THREADS * QSCTEST_NONCE_ALLOCATIONS);
+			qsctest_print_safe(" nonces on ");
+			qsctest_print_ulong(QSCTEST_NONCE_THREADS);
+			qsctest_print_safe(" threads, million nonces per second: ");
+			qsctest_print_double(((double)QSCTEST_NONCE_THREADS * (double)QSCTEST_NONCE_ALLOCATIONS * 1000.0) / (double)elapsed);
+			qsctest_print_line("");
+		}
+
+		qsc_nonce_dispose(&alloc);
+	}
+
+	if (bitmap != NULL)
+	{
+		qsc_memutils_alloc_free((void*)bitmap);
+	}
+
+	return res;
+}
+
+bool qsctest_nonce_persistence()
+{
+	qsc_nonce_allocator alloc;
+	qsc_nonce_allocator resumed;
+	uint8_t prefix[QSC_NONCE_PREFIX_SIZE];
+	uint8_t nonce[QSC_CSX_NONCE_SIZE];
+	uint64_t maximum;
+	bool res;
+
+	remove(NONCE_TEST_PATH);
+	remove(NONCE_TEST_TEMP_PATH);
+	res = qsc_nonce_initialize(&alloc, NONCE_TEST_PATH);
+
+	if (res == false)
+	{
+		qsctest_print_safe("Failure! qsctest_nonce_persistence: the allocator could not create the mark file -NP1 \n");
+	}
+
+	/* an orderly shutdown lowers the mark, the next process resumes above it with the same prefix */
+	if (res == true)
+	{
+		qsc_memutils_copy(prefix, alloc.prefix, QSC_NONCE_PREFIX_SIZE);
+		res = nonce_test_sequence(&alloc, &maximum);
+		qsc_nonce_dispose(&alloc);
+
+		if (res == true)
+		{
+			res = qsc_nonce_initialize(&alloc, NONCE_TEST_PATH) && qsc_nonce_generate(&alloc, nonce) &&
+				nonce_test_counter(nonce) > maximum && qsc_intutils_are_equal8(nonce + 4, prefix, QSC_NONCE_PREFIX_SIZE);
+		}
+
+		if (res == false)
+		{
+			qsctest_print_safe("Failure! qsctest_nonce_persistence: a nonce repeated after a restart -NP2 \n");
+		}
+	}
+
+	/* without a dispose, as after a crash, the next process resumes above the leased mark */
+	if (res == true)
+	{
+		res = nonce_test_sequence(&alloc, &maximum) && qsc_nonce_initialize(&resumed, NONCE_TEST_PATH) &&
+			qsc_nonce_generate(&resumed, nonce) && nonce_test_counter(nonce) > maximum;
+
+		if (res == false)
+		{
+			qsctest_print_safe("Failure! qsctest_nonce_persistence: a nonce repeated after a crash -NP3 \n");
+		}
+
+		qsc_memutils_clear(&resumed, sizeof(resumed));
+	}
+
+	qsc_memutils_clear(&alloc, sizeof(alloc));
+	remove(NONCE_TEST_PATH);
+	remove(NONCE_TEST_TEMP_PATH);
+
+	return res;
+}
+
+bool qsctest_nonce_interleave()
+{
+	qsc_nonce_allocator alloc[QSC_NONCE_THREAD_ALLOCATORS];
+	qsc_nonce_allocator spacer;
+	uint8_t nonce[QSC_CSX_NONCE_SIZE];
+	uint64_t prev[QSC_NONCE_THREAD_ALLOCATORS] = { 0 };
+	size_t j;
+	bool res;
+
+	res = true;
+
+	/* identifiers are issued in sequence; the spacers make every allocator identifier equal modulo the cache size */
+	for (size_t i = 0; i < QSC_NONCE_THREAD_ALLOCATORS; ++i)
+	{
+		res = res && qsc_nonce_initialize(&alloc[i], NULL);
+
+		for (j = 1; j < QSC_NONCE_THREAD_ALLOCATORS; ++j)
+		{
+			res = res && qsc_nonce_initialize(&spacer, NULL);
+			qsc_nonce_dispose(&spacer);
+		}
+	}
+
+	/* each allocator keeps its block while the others are used, so its counters stay consecutive */
+	for (size_t i = 0; res == true && i < NONCE_TEST_SEQUENCE; ++i)
+	{
+		j = i % QSC_NONCE_THREAD_ALLOCATORS;
+		res = qsc_nonce_generate(&alloc[j], nonce);
+
+		if (res == true && i >= QSC_NONCE_THREAD_ALLOCATORS)
+		{
+			res = (nonce_test_counter(nonce) == prev[j] + 1) || ((prev[j] + 1) % QSC_NONCE_BLOCK_SIZE) == 0;
+		}
+
+		prev[j] = nonce_test_counter(nonce);
+	}
+
+	if (res == false)
+	{
+		qsctest_print_safe("Failure! qsctest_nonce_interleave: an allocator lost its counter block to another allocator -NI1 \n");
+	}
+
+	for (size_t i = 0; i < QSC_NONCE_THREAD_ALLOCATORS; ++i)
+	{
+		qsc_nonce_dispose(&alloc[i]);
+	}
+
+	return res;
+}
+
+void qsctest_nonce_run()
+{
+	if (qsctest_nonce_stress() == true)
+	{
+		qsctest_print_safe("Success! Passed the nonce allocator stress test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the nonce allocator stress test. \n");
+	}
+
+	if (qsctest_nonce_interleave() == true)
+	{
+		qsctest_print_safe("Success! Passed the nonce allocator interleave test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the nonce allocator interleave test. \n");
+	}
+
+	if (qsctest_nonce_persistence() == true)
+	{
+		qsctest_print_safe("Success! Passed the nonce allocator persistence tests. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the nonce allocator persistence tests. \n");
+	}
+}
@@ -0,0 +1,54 @@
+/**
+* \file nonce_test.h
+* \brief <b>Nonce allocator tests</b> \n
+* Tests the nonce allocator for collisions under concurrent allocation, for block reuse across interleaved allocators,
+* and for resumption above the persisted high-water mark after an orderly shutdown and after a simulated crash.
+*/
+
+#ifndef QSCTEST_NONCE_TEST_H
+#define QSCTEST_NONCE_TEST_H
+
+#include "common.h"
+
+/*!
+* \def QSCTEST_NONCE_THREADS
+* \brief The number of threads allocating nonces at once in the stress test
+*/
+#define QSCTEST_NONCE_THREADS 4
+
+/*!
+* \def QSCTEST_NONCE_ALLOCATIONS
+* \brief The number of nonces allocated by each thread in the stress test
+*/
+#define QSCTEST_NONCE_ALLOCATIONS 8000000
+
+/**
+* \brief Allocates nonces from several threads at once, and checks every nonce against a shared bitmap of issued counters.
+* Prints the aggregate allocation rate.
+*
+* \return Returns true if no nonce was issued twice
+*/
+bool qsctest_nonce_stress(void);
+
+/**
+* \brief Allocates nonces from as many allocators as a thread caches blocks for, in turn,
+* and checks that each allocator's counters stay consecutive within its block.
+*
+* \return Returns true if no allocator's block was replaced while it was in use
+*/
+bool qsctest_nonce_interleave(void);
+
+/**
+* \brief Allocates nonces from a persisted allocator, then re-opens the high-water mark file,
+* after disposing the allocator and without disposing it, and checks the new nonces are above every earlier nonce.
+*
+* \return Returns true for success
+*/
+bool qsctest_nonce_persistence(void);
+
+/**
+* \brief Run all tests.
+*/
+void qsctest_nonce_run(void);
+
+#endif
@@ -0,0 +1,184 @@
+#include "perfcounters.h"
+#include "testutils.h"
+#if defined(QSC_SYSTEM_OS_LINUX)
+#	include <linux/perf_event.h>
+#	include <sys/ioctl.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+#if defined(QSC_SYSTEM_OS_LINUX)
+
+static int32_t perfcounters_event_open(uint32_t type, uint64_t config)
+{
+	struct perf_event_attr attr;
+	long fd;
+
+	memset(&attr, 0x00, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.disabled = 1;
+	/* user space only, so the default paranoid level permits access */
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	/* the counters are opened independently; a group fails if any one member is unsupported */
+	fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+
+	return (fd >= 0) ? (int32_t)fd : -1;
+}
+
+#endif
+
+bool qsctest_perfcounters_open(qsctest_perfcounters_state* ctx)
+{
+	assert(ctx != NULL);
+
+	size_t i;
+	bool res;
+
+	res = false;
+
+	if (ctx != NULL)
+	{
+		for (i = 0; i < QSCTEST_PERFCOUNTERS_EVENTS; ++i)
+		{
+			ctx->fds[i] = -1;
+			ctx->values[i] = 0;
+		}
+
+#if defined(QSC_SYSTEM_OS_LINUX)
+		ctx->fds[qsctest_perfcounters_cycles] = perfcounters_event_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+		ctx->fds[qsctest_perfcounters_instructions] = perfcounters_event_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+		ctx->fds[qsctest_perfcounters_l1d_misses] = perfcounters_event_open(PERF_TYPE_HW_CACHE,
+			(uint64_t)PERF_COUNT_HW_CACHE_L1D | ((uint64_t)PERF_COUNT_HW_CACHE_OP_READ << 8) | ((uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+		ctx->fds[qsctest_perfcounters_llc_misses] = perfcounters_event_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+		ctx->fds[qsctest_perfcounters_branch_misses] = perfcounters_event_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+
+		for (i = 0; i < QSCTEST_PERFCOUNTERS_EVENTS; ++i)
+		{
+			res = res || (ctx->fds[i] >= 0);
+		}
+	}
+
+	return res;
+}
+
+void qsctest_perfcounters_start(qsctest_perfcounters_state* ctx)
+{
+	assert(ctx != NULL);
+
+	if (ctx != NULL)
+	{
+#if defined(QSC_SYSTEM_OS_LINUX)
+		for (size_t i = 0; i < QSCTEST_PERFCOUNTERS_EVENTS; ++i)
+		{
+			if (ctx->fds[i] >= 0)
+			{
+				ioctl(ctx->fds[i], PERF_EVENT_IOC_RESET, 0);
+				ioctl(ctx->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+#endif
+	}
+}
+
+void qsctest_perfcounters_stop(qsctest_perfcounters_state* ctx)
+{
+	assert(ctx != NULL);
+
+	if (ctx != NULL)
+	{
+#if defined(QSC_SYSTEM_OS_LINUX)
+		uint64_t rval[3];
+		size_t i;
+
+		for (i = 0; i < QSCTEST_PERFCOUNTERS_EVENTS; ++i)
+		{
+			if (ctx->fds[i] >= 0)
+			{
+				ioctl(ctx->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+			}
+		}
+
+		for (i = 0; i < QSCTEST_PERFCOUNTERS_EVENTS; ++i)
+		{
+			ctx->values[i] = 0;
+
+			/* the value, the time enabled, and the time the counter was scheduled on the pmu */
+			if (ctx->fds[i] >= 0 && read(ctx->fds[i], rval, sizeof(rval)) == (ssize_t)sizeof(rval))
+			{
+				if (rval[2] != 0 && rval[2] < rval[1])
+				{
+					ctx->values[i] = (uint64_t)((double)rval[0] * ((double)rval[1] / (double)rval[2]));
+				}
+				else
+				{
+					ctx->values[i] = rval[0];
+				}
+			}
+		}
+#endif
+	}
+}
+
+void qsctest_perfcounters_close(qsctest_perfcounters_state* ctx)
+{
+	assert(ctx != NULL);
+
+	if (ctx != NULL)
+	{
+		for (size_t i = 0; i < QSCTEST_PERFCOUNTERS_EVENTS; ++i)
+		{
+#if defined(QSC_SYSTEM_OS_LINUX)
+			if (ctx->fds[i] >= 0)
+			{
+				close(ctx->fds[i]);
+			}
+#endif
+			ctx->fds[i] = -1;
+		}
+	}
+}
+
+void qsctest_perfcounters_print(const qsctest_perfcounters_state* ctx, uint64_t bytes)
+{
+	assert(ctx != NULL);
+
+	const char* NAMES[QSCTEST_PERFCOUNTERS_EVENTS] = { "", "", ", L1D misses/KiB ", ", LLC misses/KiB ", ", branch misses/KiB " };
+	const double KIB = (double)bytes / 1024.0;
+
+	if (ctx != NULL && bytes != 0)
+	{
+		qsctest_print_safe("  IPC ");
+
+		if (ctx->fds[qsctest_perfcounters_cycles] >= 0 && ctx->fds[qsctest_perfcounters_instructions] >= 0 &&
+			ctx->values[qsctest_perfcounters_cycles] != 0)
+		{
+			qsctest_print_double((double)ctx->values[qsctest_perfcounters_instructions] / (double)ctx->values[qsctest_perfcounters_cycles]);
+		}
+		else
+		{
+			qsctest_print_safe("n/a");
+		}
+
+		for (size_t i = qsctest_perfcounters_l1d_misses; i < QSCTEST_PERFCOUNTERS_EVENTS; ++i)
+		{
+			qsctest_print_safe(NAMES[i]);
+
+			if (ctx->fds[i] >= 0)
+			{
+				qsctest_print_double((double)ctx->values[i] / KIB);
+			}
+			else
+			{
+				qsctest_print_safe("n/a");
+			}
+		}
+
+		qsctest_print_line("");
+	}
+}
@@ -0,0 +1,82 @@
+/**
+* \file perfcounters.h
+* \brief <b>Hardware performance counters for the benchmarks</b> \n
+* Collects cycles, instructions, cache misses, and branch misses around a benchmarked kernel
+* using the Linux perf_event_open interface. On other systems, or when the kernel does not
+* permit counter access, the counters are reported as unavailable and the benchmarks use timing only.
+*/
+
+#ifndef QSCTEST_PERFCOUNTERS_H
+#define QSCTEST_PERFCOUNTERS_H
+
+#include "common.h"
+
+/*!
+* \enum qsctest_perfcounters_event
+* \brief The hardware events collected by the counters
+*/
+typedef enum
+{
+	qsctest_perfcounters_cycles = 0,		/*!< The core clock cycles */
+	qsctest_perfcounters_instructions = 1,	/*!< The retired instructions */
+	qsctest_perfcounters_l1d_misses = 2,	/*!< The L1 data cache read misses */
+	qsctest_perfcounters_llc_misses = 3,	/*!< The last level cache misses */
+	qsctest_perfcounters_branch_misses = 4,	/*!< The mispredicted branches */
+} qsctest_perfcounters_event;
+
+/*!
+* \def QSCTEST_PERFCOUNTERS_EVENTS
+* \brief The number of collected hardware events
+*/
+#define QSCTEST_PERFCOUNTERS_EVENTS 5
+
+/*!
+* \struct qsctest_perfcounters_state
+* \brief The performance counter state
+*/
+typedef struct
+{
+	int32_t fds[QSCTEST_PERFCOUNTERS_EVENTS];		/*!< The counter file descriptors, -1 if the event is unavailable */
+	uint64_t values[QSCTEST_PERFCOUNTERS_EVENTS];	/*!< The event counts from the last measurement */
+} qsctest_perfcounters_state;
+
+/**
+* \brief Open the hardware counters for the calling thread.
+* Events the processor or kernel do not support are marked unavailable.
+*
+* \param ctx: [struct] The counter state
+* \return Returns true if at least one counter is available
+*/
+bool qsctest_perfcounters_open(qsctest_perfcounters_state* ctx);
+
+/**
+* \brief Reset and enable the counters at the start of a measured region
+*
+* \param ctx: [struct] The counter state
+*/
+void qsctest_perfcounters_start(qsctest_perfcounters_state* ctx);
+
+/**
+* \brief Disable the counters at the end of a measured region and read the event counts.
+* Counts are scaled when the kernel multiplexed a counter for part of the region.
+*
+* \param ctx: [struct] The counter state
+*/
+void qsctest_perfcounters_stop(qsctest_perfcounters_state* ctx);
+
+/**
+* \brief Close the counters
+*
+* \param ctx: [struct] The counter state
+*/
+void qsctest_perfcounters_close(qsctest_perfcounters_state* ctx);
+
+/**
+* \brief Print the instructions per cycle, and the cache and branch misses per KiB of processed data
+*
+* \param ctx: [const][struct] The counter state after a measurement
+* \param bytes: The number of bytes processed in the measured region
+*/
+void qsctest_perfcounters_print(const qsctest_perfcounters_state* ctx, uint64_t bytes);
+
+#endif
@@ -1,10 +1,25 @@
 #include "sha3.h"
+#include "async.h"
 #include "intutils.h"
 #include "memutils.h"
 
 #define KPA_LEAF_HASH128 16
 #define KPA_LEAF_HASH256 32
 #define KPA_LEAF_HASH512 64
+#define KT_DOMAIN_SINGLE 0x07
+#define KT_DOMAIN_LEAF 0x0B
+#define KT_DOMAIN_FINAL 0x06
+#define KT128_CV_SIZE 32
+#define KT256_CV_SIZE 64
+#define PARALLELHASH128_CV_SIZE 32
+#define PARALLELHASH256_CV_SIZE 64
+
+/* the number of rate blocks ahead of the absorb that the message is prefetched */
+#if !defined(KECCAK_PREFETCH_BLOCKS)
+#	define KECCAK_PREFETCH_BLOCKS 4
+#endif
+/* Keccak-p[1600,12] uses the last 12 of the 24 round constants */
+#define KT_ROUND_CONSTANTS (KECCAK_ROUND_CONSTANTS + (QSC_KECCAK_PERMUTATION_ROUNDS - QSC_KECCAK_PERMUTATION_MIN_ROUNDS))
 
 /* keccak round constants */
 static const uint64_t KECCAK_ROUND_CONSTANTS[QSC_KECCAK_PERMUTATION_MAX_ROUNDS] =
@@ -27,16 +42,32 @@ static const uint64_t KECCAK_ROUND_CONSTANTS[QSC_KECCAK_PERMUTATION_MAX_ROUNDS]
 
 static void keccak_fast_absorb(uint64_t* state, const uint8_t* message, size_t msglen)
 {
-#if defined(QSC_SYSTEM_IS_LITTLE_ENDIAN)
+#if !defined(QSC_SYSTEM_IS_BIG_ENDIAN)
 	qsc_memutils_xor((uint8_t*)state, message, msglen);
 #else
+	uint64_t tmp[QSC_KECCAK_STATE_SIZE];
+
+	qsc_intutils_le8to64_array(tmp, message, msglen / sizeof(uint64_t));
+
 	for (size_t i = 0; i < msglen / sizeof(uint64_t); ++i)
 	{
-		state[i] ^= qsc_intutils_le8to64((message + (sizeof(uint64_t) * i)));
+		state[i] ^= tmp[i];
 	}
+
+	qsc_memutils_clear(tmp, sizeof(tmp));
 #endif
 }
 
+static void keccak_buffer_wipe(qsc_keccak_state* ctx)
+{
+	/* the buffer is only written by the buffered update and finalize functions, most states never use it */
+	if (ctx->dirty == true)
+	{
+		qsc_memutils_secure_wipe(ctx->buffer, sizeof(ctx->buffer));
+		ctx->dirty = false;
+	}
+}
+
 static size_t keccak_left_encode(uint8_t* buffer, size_t value)
 {
 	size_t n;
@@ -84,7 +115,7 @@ static size_t keccak_right_encode(uint8_t* buffer, size_t value)
 #if defined(QSC_SYSTEM_HAS_AVX512)
 #	if defined(QSC_KECCAK_UNROLLED_PERMUTATION)
 
-void qsc_keccak_permute_p8x1600(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rounds)
+static void keccak_permute_p8x1600_rc(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rounds, const uint64_t* rc)
 {
 	assert(rounds % 2 == 0);
 
@@ -200,7 +231,7 @@ void qsc_keccak_permute_p8x1600(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rou
 		a24 = _mm512_xor_si512(a24, d4);
 		c4 = _mm512_or_si512(_mm512_slli_epi64(a24, 14), _mm512_srli_epi64(a24, 64 - 14));
 		e0 = _mm512_xor_si512(c0, _mm512_and_si512(_mm512_xor_epi64(c1, _mm512_set1_epi64(-1)), c2));
-		e0 = _mm512_xor_si512(e0, _mm512_set1_epi64(KECCAK_ROUND_CONSTANTS[i]));
+		e0 = _mm512_xor_si512(e0, _mm512_set1_epi64(rc[i]));
 		e1 = _mm512_xor_si512(c1, _mm512_and_si512(_mm512_xor_epi64(c2, _mm512_set1_epi64(-1)), c3));
 		e2 = _mm512_xor_si512(c2, _mm512_and_si512(_mm512_xor_epi64(c3, _mm512_set1_epi64(-1)), c4));
 		e3 = _mm512_xor_si512(c3, _mm512_and_si512(_mm512_xor_epi64(c4, _mm512_set1_epi64(-1)), c0));
@@ -287,7 +318,7 @@ void qsc_keccak_permute_p8x1600(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rou
 		e24 = _mm512_xor_si512(e24, d4);
 		c4 = _mm512_or_si512(_mm512_slli_epi64(e24, 14), _mm512_srli_epi64(e24, 64 - 14));
 		a0 = _mm512_xor_si512(c0, _mm512_and_si512(_mm512_xor_epi64(c1, _mm512_set1_epi64(-1)), c2));
-		a0 = _mm512_xor_si512(a0, _mm512_set1_epi64(KECCAK_ROUND_CONSTANTS[i + 1]));
+		a0 = _mm512_xor_si512(a0, _mm512_set1_epi64(rc[i + 1]));
 		a1 = _mm512_xor_si512(c1, _mm512_and_si512(_mm512_xor_epi64(c2, _mm512_set1_epi64(-1)), c3));
 		a2 = _mm512_xor_si512(c2, _mm512_and_si512(_mm512_xor_epi64(c3, _mm512_set1_epi64(-1)), c4));
 		a3 = _mm512_xor_si512(c3, _mm512_and_si512(_mm512_xor_epi64(c4, _mm512_set1_epi64(-1)), c0));
@@ -383,7 +414,7 @@ void qsc_keccak_permute_p8x1600(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rou
 
 #	else
 
-void qsc_keccak_permute_p8x1600(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rounds)
+static void keccak_permute_p8x1600_rc(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rounds, const uint64_t* rc)
 {
 	assert(rounds % 2 == 0);
 
@@ -422,7 +453,7 @@ void qsc_keccak_permute_p8x1600(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rou
 		a[24] = _mm512_xor_si512(a[24], d[4]);
 		c[4] = _mm512_or_si512(_mm512_slli_epi64(a[24], 14), _mm512_srli_epi64(a[24], 64 - 14));
 		e[0] = _mm512_xor_si512(c[0], _mm512_and_si512(_mm512_xor_epi64(c[1], _mm512_set1_epi64(-1)), c[2]));
-		e[0] = _mm512_xor_si512(e[0], _mm512_set1_epi64(KECCAK_ROUND_CONSTANTS[i]));
+		e[0] = _mm512_xor_si512(e[0], _mm512_set1_epi64(rc[i]));
 		e[1] = _mm512_xor_si512(c[1], _mm512_and_si512(_mm512_xor_epi64(c[2], _mm512_set1_epi64(-1)), c[3]));
 		e[2] = _mm512_xor_si512(c[2], _mm512_and_si512(_mm512_xor_epi64(c[3], _mm512_set1_epi64(-1)), c[4]));
 		e[3] = _mm512_xor_si512(c[3], _mm512_and_si512(_mm512_xor_epi64(c[4], _mm512_set1_epi64(-1)), c[0]));
@@ -510,7 +541,7 @@ void qsc_keccak_permute_p8x1600(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rou
 		e[24] = _mm512_xor_si512(e[24], d[4]);
 		c[4] = _mm512_or_si512(_mm512_slli_epi64(e[24], 14), _mm512_srli_epi64(e[24], 64 - 14));
 		a[0] = _mm512_xor_si512(c[0], _mm512_and_si512(_mm512_xor_epi64(c[1], _mm512_set1_epi64(-1)), c[2]));
-		a[0] = _mm512_xor_si512(a[0], _mm512_set1_epi64(KECCAK_ROUND_CONSTANTS[i + 1]));
+		a[0] = _mm512_xor_si512(a[0], _mm512_set1_epi64(rc[i + 1]));
 		a[1] = _mm512_xor_si512(c[1], _mm512_and_si512(_mm512_xor_epi64(c[2], _mm512_set1_epi64(-1)), c[3]));
 		a[2] = _mm512_xor_si512(c[2], _mm512_and_si512(_mm512_xor_epi64(c[3], _mm512_set1_epi64(-1)), c[4]));
 		a[3] = _mm512_xor_si512(c[3], _mm512_and_si512(_mm512_xor_epi64(c[4], _mm512_set1_epi64(-1)), c[0]));
@@ -584,12 +615,176 @@ void qsc_keccak_permute_p8x1600(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rou
 }
 
 #	endif
+
+void qsc_keccak_permute_p8x1600(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rounds)
+{
+	keccak_permute_p8x1600_rc(state, rounds, KECCAK_ROUND_CONSTANTS);
+}
+
+static void keccak_permute_p16x1600(__m512i state[2][QSC_KECCAK_STATE_SIZE], size_t rounds)
+{
+	/* two independent x8 states are interleaved to hide the latency of the theta and chi dependency chains */
+	__m512i a0[25];
+	__m512i a1[25];
+	__m512i b0[25];
+	__m512i b1[25];
+	__m512i c0[5];
+	__m512i c1[5];
+	__m512i d0[5];
+	__m512i d1[5];
+	__m512i rc;
+	size_t i;
+
+	for (i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		a0[i] = state[0][i];
+		a1[i] = state[1][i];
+	}
+
+	for (i = 0; i < rounds; ++i)
+	{
+		/* theta */
+		c0[0] = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a0[0], a0[5], a0[10], 0x96), a0[15], a0[20], 0x96);
+		c1[0] = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a1[0], a1[5], a1[10], 0x96), a1[15], a1[20], 0x96);
+		c0[1] = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a0[1], a0[6], a0[11], 0x96), a0[16], a0[21], 0x96);
+		c1[1] = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a1[1], a1[6], a1[11], 0x96), a1[16], a1[21], 0x96);
+		c0[2] = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a0[2], a0[7], a0[12], 0x96), a0[17], a0[22], 0x96);
+		c1[2] = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a1[2], a1[7], a1[12], 0x96), a1[17], a1[22], 0x96);
+		c0[3] = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a0[3], a0[8], a0[13], 0x96), a0[18], a0[23], 0x96);
+		c1[3] = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a1[3], a1[8], a1[13], 0x96), a1[18], a1[23], 0x96);
+		c0[4] = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a0[4], a0[9], a0[14], 0x96), a0[19], a0[24], 0x96);
+		c1[4] = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a1[4], a1[9], a1[14], 0x96), a1[19], a1[24], 0x96);
+		d0[0] = _mm512_xor_si512(c0[4], _mm512_rol_epi64(c0[1], 1));
+		d1[0] = _mm512_xor_si512(c1[4], _mm512_rol_epi64(c1[1], 1));
+		d0[1] = _mm512_xor_si512(c0[0], _mm512_rol_epi64(c0[2], 1));
+		d1[1] = _mm512_xor_si512(c1[0], _mm512_rol_epi64(c1[2], 1));
+		d0[2] = _mm512_xor_si512(c0[1], _mm512_rol_epi64(c0[3], 1));
+		d1[2] = _mm512_xor_si512(c1[1], _mm512_rol_epi64(c1[3], 1));
+		d0[3] = _mm512_xor_si512(c0[2], _mm512_rol_epi64(c0[4], 1));
+		d1[3] = _mm512_xor_si512(c1[2], _mm512_rol_epi64(c1[4], 1));
+		d0[4] = _mm512_xor_si512(c0[3], _mm512_rol_epi64(c0[0], 1));
+		d1[4] = _mm512_xor_si512(c1[3], _mm512_rol_epi64(c1[0], 1));
+		/* rho and pi */
+		b0[0] = _mm512_xor_si512(a0[0], d0[0]);
+		b1[0] = _mm512_xor_si512(a1[0], d1[0]);
+		b0[10] = _mm512_rol_epi64(_mm512_xor_si512(a0[1], d0[1]), 1);
+		b1[10] = _mm512_rol_epi64(_mm512_xor_si512(a1[1], d1[1]), 1);
+		b0[20] = _mm512_rol_epi64(_mm512_xor_si512(a0[2], d0[2]), 62);
+		b1[20] = _mm512_rol_epi64(_mm512_xor_si512(a1[2], d1[2]), 62);
+		b0[5] = _mm512_rol_epi64(_mm512_xor_si512(a0[3], d0[3]), 28);
+		b1[5] = _mm512_rol_epi64(_mm512_xor_si512(a1[3], d1[3]), 28);
+		b0[15] = _mm512_rol_epi64(_mm512_xor_si512(a0[4], d0[4]), 27);
+		b1[15] = _mm512_rol_epi64(_mm512_xor_si512(a1[4], d1[4]), 27);
+		b0[16] = _mm512_rol_epi64(_mm512_xor_si512(a0[5], d0[0]), 36);
+		b1[16] = _mm512_rol_epi64(_mm512_xor_si512(a1[5], d1[0]), 36);
+		b0[1] = _mm512_rol_epi64(_mm512_xor_si512(a0[6], d0[1]), 44);
+		b1[1] = _mm512_rol_epi64(_mm512_xor_si512(a1[6], d1[1]), 44);
+		b0[11] = _mm512_rol_epi64(_mm512_xor_si512(a0[7], d0[2]), 6);
+		b1[11] = _mm512_rol_epi64(_mm512_xor_si512(a1[7], d1[2]), 6);
+		b0[21] = _mm512_rol_epi64(_mm512_xor_si512(a0[8], d0[3]), 55);
+		b1[21] = _mm512_rol_epi64(_mm512_xor_si512(a1[8], d1[3]), 55);
+		b0[6] = _mm512_rol_epi64(_mm512_xor_si512(a0[9], d0[4]), 20);
+		b1[6] = _mm512_rol_epi64(_mm512_xor_si512(a1[9], d1[4]), 20);
+		b0[7] = _mm512_rol_epi64(_mm512_xor_si512(a0[10], d0[0]), 3);
+		b1[7] = _mm512_rol_epi64(_mm512_xor_si512(a1[10], d1[0]), 3);
+		b0[17] = _mm512_rol_epi64(_mm512_xor_si512(a0[11], d0[1]), 10);
+		b1[17] = _mm512_rol_epi64(_mm512_xor_si512(a1[11], d1[1]), 10);
+		b0[2] = _mm512_rol_epi64(_mm512_xor_si512(a0[12], d0[2]), 43);
+		b1[2] = _mm512_rol_epi64(_mm512_xor_si512(a1[12], d1[2]), 43);
+		b0[12] = _mm512_rol_epi64(_mm512_xor_si512(a0[13], d0[3]), 25);
+		b1[12] = _mm512_rol_epi64(_mm512_xor_si512(a1[13], d1[3]), 25);
+		b0[22] = _mm512_rol_epi64(_mm512_xor_si512(a0[14], d0[4]), 39);
+		b1[22] = _mm512_rol_epi64(_mm512_xor_si512(a1[14], d1[4]), 39);
+		b0[23] = _mm512_rol_epi64(_mm512_xor_si512(a0[15], d0[0]), 41);
+		b1[23] = _mm512_rol_epi64(_mm512_xor_si512(a1[15], d1[0]), 41);
+		b0[8] = _mm512_rol_epi64(_mm512_xor_si512(a0[16], d0[1]), 45);
+		b1[8] = _mm512_rol_epi64(_mm512_xor_si512(a1[16], d1[1]), 45);
+		b0[18] = _mm512_rol_epi64(_mm512_xor_si512(a0[17], d0[2]), 15);
+		b1[18] = _mm512_rol_epi64(_mm512_xor_si512(a1[17], d1[2]), 15);
+		b0[3] = _mm512_rol_epi64(_mm512_xor_si512(a0[18], d0[3]), 21);
+		b1[3] = _mm512_rol_epi64(_mm512_xor_si512(a1[18], d1[3]), 21);
+		b0[13] = _mm512_rol_epi64(_mm512_xor_si512(a0[19], d0[4]), 8);
+		b1[13] = _mm512_rol_epi64(_mm512_xor_si512(a1[19], d1[4]), 8);
+		b0[14] = _mm512_rol_epi64(_mm512_xor_si512(a0[20], d0[0]), 18);
+		b1[14] = _mm512_rol_epi64(_mm512_xor_si512(a1[20], d1[0]), 18);
+		b0[24] = _mm512_rol_epi64(_mm512_xor_si512(a0[21], d0[1]), 2);
+		b1[24] = _mm512_rol_epi64(_mm512_xor_si512(a1[21], d1[1]), 2);
+		b0[9] = _mm512_rol_epi64(_mm512_xor_si512(a0[22], d0[2]), 61);
+		b1[9] = _mm512_rol_epi64(_mm512_xor_si512(a1[22], d1[2]), 61);
+		b0[19] = _mm512_rol_epi64(_mm512_xor_si512(a0[23], d0[3]), 56);
+		b1[19] = _mm512_rol_epi64(_mm512_xor_si512(a1[23], d1[3]), 56);
+		b0[4] = _mm512_rol_epi64(_mm512_xor_si512(a0[24], d0[4]), 14);
+		b1[4] = _mm512_rol_epi64(_mm512_xor_si512(a1[24], d1[4]), 14);
+		/* chi */
+		a0[0] = _mm512_ternarylogic_epi64(b0[0], b0[1], b0[2], 0xD2);
+		a1[0] = _mm512_ternarylogic_epi64(b1[0], b1[1], b1[2], 0xD2);
+		a0[1] = _mm512_ternarylogic_epi64(b0[1], b0[2], b0[3], 0xD2);
+		a1[1] = _mm512_ternarylogic_epi64(b1[1], b1[2], b1[3], 0xD2);
+		a0[2] = _mm512_ternarylogic_epi64(b0[2], b0[3], b0[4], 0xD2);
+		a1[2] = _mm512_ternarylogic_epi64(b1[2], b1[3], b1[4], 0xD2);
+		a0[3] = _mm512_ternarylogic_epi64(b0[3], b0[4], b0[0], 0xD2);
+		a1[3] = _mm512_ternarylogic_epi64(b1[3], b1[4], b1[0], 0xD2);
+		a0[4] = _mm512_ternarylogic_epi64(b0[4], b0[0], b0[1], 0xD2);
+		a1[4] = _mm512_ternarylogic_epi64(b1[4], b1[0], b1[1], 0xD2);
+		a0[5] = _mm512_ternarylogic_epi64(b0[5], b0[6], b0[7], 0xD2);
+		a1[5] = _mm512_ternarylogic_epi64(b1[5], b1[6], b1[7], 0xD2);
+		a0[6] = _mm512_ternarylogic_epi64(b0[6], b0[7], b0[8], 0xD2);
+		a1[6] = _mm512_ternarylogic_epi64(b1[6], b1[7], b1[8], 0xD2);
+		a0[7] = _mm512_ternarylogic_epi64(b0[7], b0[8], b0[9], 0xD2);
+		a1[7] = _mm512_ternarylogic_epi64(b1[7], b1[8], b1[9], 0xD2);
+		a0[8] = _mm512_ternarylogic_epi64(b0[8], b0[9], b0[5], 0xD2);
+		a1[8] = _mm512_ternarylogic_epi64(b1[8], b1[9], b1[5], 0xD2);
+		a0[9] = _mm512_ternarylogic_epi64(b0[9], b0[5], b0[6], 0xD2);
+		a1[9] = _mm512_ternarylogic_epi64(b1[9], b1[5], b1[6], 0xD2);
+		a0[10] = _mm512_ternarylogic_epi64(b0[10], b0[11], b0[12], 0xD2);
+		a1[10] = _mm512_ternarylogic_epi64(b1[10], b1[11], b1[12], 0xD2);
+		a0[11] = _mm512_ternarylogic_epi64(b0[11], b0[12], b0[13], 0xD2);
+		a1[11] = _mm512_ternarylogic_epi64(b1[11], b1[12], b1[13], 0xD2);
+		a0[12] = _mm512_ternarylogic_epi64(b0[12], b0[13], b0[14], 0xD2);
+		a1[12] = _mm512_ternarylogic_epi64(b1[12], b1[13], b1[14], 0xD2);
+		a0[13] = _mm512_ternarylogic_epi64(b0[13], b0[14], b0[10], 0xD2);
+		a1[13] = _mm512_ternarylogic_epi64(b1[13], b1[14], b1[10], 0xD2);
+		a0[14] = _mm512_ternarylogic_epi64(b0[14], b0[10], b0[11], 0xD2);
+		a1[14] = _mm512_ternarylogic_epi64(b1[14], b1[10], b1[11], 0xD2);
+		a0[15] = _mm512_ternarylogic_epi64(b0[15], b0[16], b0[17], 0xD2);
+		a1[15] = _mm512_ternarylogic_epi64(b1[15], b1[16], b1[17], 0xD2);
+		a0[16] = _mm512_ternarylogic_epi64(b0[16], b0[17], b0[18], 0xD2);
+		a1[16] = _mm512_ternarylogic_epi64(b1[16], b1[17], b1[18], 0xD2);
+		a0[17] = _mm512_ternarylogic_epi64(b0[17], b0[18], b0[19], 0xD2);
+		a1[17] = _mm512_ternarylogic_epi64(b1[17], b1[18], b1[19], 0xD2);
+		a0[18] = _mm512_ternarylogic_epi64(b0[18], b0[19], b0[15], 0xD2);
+		a1[18] = _mm512_ternarylogic_epi64(b1[18], b1[19], b1[15], 0xD2);
+		a0[19] = _mm512_ternarylogic_epi64(b0[19], b0[15], b0[16], 0xD2);
+		a1[19] = _mm512_ternarylogic_epi64(b1[19], b1[15], b1[16], 0xD2);
+		a0[20] = _mm512_ternarylogic_epi64(b0[20], b0[21], b0[22], 0xD2);
+		a1[20] = _mm512_ternarylogic_epi64(b1[20], b1[21], b1[22], 0xD2);
+		a0[21] = _mm512_ternarylogic_epi64(b0[21], b0[22], b0[23], 0xD2);
+		a1[21] = _mm512_ternarylogic_epi64(b1[21], b1[22], b1[23], 0xD2);
+		a0[22] = _mm512_ternarylogic_epi64(b0[22], b0[23], b0[24], 0xD2);
+		a1[22] = _mm512_ternarylogic_epi64(b1[22], b1[23], b1[24], 0xD2);
+		a0[23] = _mm512_ternarylogic_epi64(b0[23], b0[24], b0[20], 0xD2);
+		a1[23] = _mm512_ternarylogic_epi64(b1[23], b1[24], b1[20], 0xD2);
+		a0[24] = _mm512_ternarylogic_epi64(b0[24], b0[20], b0[21], 0xD2);
+		a1[24] = _mm512_ternarylogic_epi64(b1[24], b1[20], b1[21], 0xD2);
+		/* iota */
+		rc = _mm512_set1_epi64((int64_t)KECCAK_ROUND_CONSTANTS[i]);
+		a0[0] = _mm512_xor_si512(a0[0], rc);
+		a1[0] = _mm512_xor_si512(a1[0], rc);
+	}
+
+	for (i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		state[0][i] = a0[i];
+		state[1][i] = a1[i];
+	}
+}
+
 #endif
 
 #if defined(QSC_SYSTEM_HAS_AVX2)
 #	if defined(QSC_KECCAK_UNROLLED_PERMUTATION)
 
-void qsc_keccak_permute_p4x1600(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rounds)
+static void keccak_permute_p4x1600_rc(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rounds, const uint64_t* rc)
 {
 	assert(rounds % 2 == 0);
 
@@ -707,7 +902,7 @@ void qsc_keccak_permute_p4x1600(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rou
 		a24 = _mm256_xor_si256(a24, d4);
 		c4 = _mm256_or_si256(_mm256_slli_epi64(a24, 14), _mm256_srli_epi64(a24, 64 - 14));
 		e0 = _mm256_xor_si256(c0, _mm256_and_si256(_mm256_xor_si256(c1, _mm256_set1_epi64x(-1)), c2));
-		e0 = _mm256_xor_si256(e0, _mm256_set1_epi64x(KECCAK_ROUND_CONSTANTS[i]));
+		e0 = _mm256_xor_si256(e0, _mm256_set1_epi64x(rc[i]));
 		e1 = _mm256_xor_si256(c1, _mm256_and_si256(_mm256_xor_si256(c2, _mm256_set1_epi64x(-1)), c3));
 		e2 = _mm256_xor_si256(c2, _mm256_and_si256(_mm256_xor_si256(c3, _mm256_set1_epi64x(-1)), c4));
 		e3 = _mm256_xor_si256(c3, _mm256_and_si256(_mm256_xor_si256(c4, _mm256_set1_epi64x(-1)), c0));
@@ -794,7 +989,7 @@ void qsc_keccak_permute_p4x1600(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rou
 		e24 = _mm256_xor_si256(e24, d4);
 		c4 = _mm256_or_si256(_mm256_slli_epi64(e24, 14), _mm256_srli_epi64(e24, 64 - 14));
 		a0 = _mm256_xor_si256(c0, _mm256_and_si256(_mm256_xor_si256(c1, _mm256_set1_epi64x(-1)), c2));
-		a0 = _mm256_xor_si256(a0, _mm256_set1_epi64x(KECCAK_ROUND_CONSTANTS[i + 1]));
+		a0 = _mm256_xor_si256(a0, _mm256_set1_epi64x(rc[i + 1]));
 		a1 = _mm256_xor_si256(c1, _mm256_and_si256(_mm256_xor_si256(c2, _mm256_set1_epi64x(-1)), c3));
 		a2 = _mm256_xor_si256(c2, _mm256_and_si256(_mm256_xor_si256(c3, _mm256_set1_epi64x(-1)), c4));
 		a3 = _mm256_xor_si256(c3, _mm256_and_si256(_mm256_xor_si256(c4, _mm256_set1_epi64x(-1)), c0));
@@ -890,7 +1085,7 @@ void qsc_keccak_permute_p4x1600(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rou
 
 #	else
 
-void qsc_keccak_permute_p4x1600(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rounds)
+static void keccak_permute_p4x1600_rc(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rounds, const uint64_t* rc)
 {
 	assert(rounds % 2 == 0);
 
@@ -929,7 +1124,7 @@ void qsc_keccak_permute_p4x1600(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rou
 		a[24] = _mm256_xor_si256(a[24], d[4]);
 		c[4] = _mm256_or_si256(_mm256_slli_epi64(a[24], 14), _mm256_srli_epi64(a[24], 64 - 14));
 		e[0] = _mm256_xor_si256(c[0], _mm256_and_si256(_mm256_xor_si256(c[1], _mm256_set1_epi64x(-1)), c[2]));
-		e[0] = _mm256_xor_si256(e[0], _mm256_set1_epi64x(KECCAK_ROUND_CONSTANTS[i]));
+		e[0] = _mm256_xor_si256(e[0], _mm256_set1_epi64x(rc[i]));
 		e[1] = _mm256_xor_si256(c[1], _mm256_and_si256(_mm256_xor_si256(c[2], _mm256_set1_epi64x(-1)), c[3]));
 		e[2] = _mm256_xor_si256(c[2], _mm256_and_si256(_mm256_xor_si256(c[3], _mm256_set1_epi64x(-1)), c[4]));
 		e[3] = _mm256_xor_si256(c[3], _mm256_and_si256(_mm256_xor_si256(c[4], _mm256_set1_epi64x(-1)), c[0]));
@@ -1017,7 +1212,7 @@ void qsc_keccak_permute_p4x1600(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rou
 		e[24] = _mm256_xor_si256(e[24], d[4]);
 		c[4] = _mm256_or_si256(_mm256_slli_epi64(e[24], 14), _mm256_srli_epi64(e[24], 64 - 14));
 		a[0] = _mm256_xor_si256(c[0], _mm256_and_si256(_mm256_xor_si256(c[1], _mm256_set1_epi64x(-1)), c[2]));
-		a[0] = _mm256_xor_si256(a[0], _mm256_set1_epi64x(KECCAK_ROUND_CONSTANTS[i + 1]));
+		a[0] = _mm256_xor_si256(a[0], _mm256_set1_epi64x(rc[i + 1]));
 		a[1] = _mm256_xor_si256(c[1], _mm256_and_si256(_mm256_xor_si256(c[2], _mm256_set1_epi64x(-1)), c[3]));
 		a[2] = _mm256_xor_si256(c[2], _mm256_and_si256(_mm256_xor_si256(c[3], _mm256_set1_epi64x(-1)), c[4]));
 		a[3] = _mm256_xor_si256(c[3], _mm256_and_si256(_mm256_xor_si256(c[4], _mm256_set1_epi64x(-1)), c[0]));
@@ -1091,6 +1286,11 @@ void qsc_keccak_permute_p4x1600(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rou
 }
 
 #	endif
+
+void qsc_keccak_permute_p4x1600(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rounds)
+{
+	keccak_permute_p4x1600_rc(state, rounds, KECCAK_ROUND_CONSTANTS);
+}
 #endif
 
 /* Keccak */
@@ -1106,14 +1306,7 @@ void qsc_keccak_absorb(qsc_keccak_state* ctx, qsc_keccak_rate rate, const uint8_
 
 		while (msglen >= (size_t)rate)
 		{
-#if defined(QSC_SYSTEM_IS_LITTLE_ENDIAN)
-			qsc_memutils_xor((uint8_t*)ctx->state, message, rate);
-#else
-			for (size_t i = 0; i < rate / sizeof(uint64_t); ++i)
-			{
-				ctx->state[i] ^= qsc_intutils_le8to64((message + (sizeof(uint64_t) * i)));
-			}
-#endif
+			keccak_fast_absorb(ctx->state, message, rate);
 			qsc_keccak_permute(ctx, rounds);
 			msglen -= rate;
 			message += rate;
@@ -1124,14 +1317,7 @@ void qsc_keccak_absorb(qsc_keccak_state* ctx, qsc_keccak_rate rate, const uint8_
 		qsc_memutils_clear((msg + msglen + 1), rate - msglen + 1);
 		msg[rate - 1] |= 128U;
 
-#if defined(QSC_SYSTEM_IS_LITTLE_ENDIAN)
-		qsc_memutils_xor((uint8_t*)ctx->state, msg, rate);
-#else
-		for (size_t i = 0; i < rate / 8; ++i)
-		{
-			ctx->state[i] ^= qsc_intutils_le8to64((msg + (8 * i)));
-		}
-#endif
+		keccak_fast_absorb(ctx->state, msg, rate);
 	}
 }
 
@@ -1193,9 +1379,11 @@ void qsc_keccak_absorb_key_custom(qsc_keccak_state* ctx, qsc_keccak_rate rate, c
 	size_t oft;
 	size_t i;
 
+	/* the state may be new, so the dirty flag is not yet valid and the buffer is always erased */
 	qsc_memutils_clear((uint8_t*)ctx->state, sizeof(ctx->state));
-	qsc_memutils_clear(ctx->buffer, sizeof(ctx->buffer));
+	qsc_memutils_secure_wipe(ctx->buffer, sizeof(ctx->buffer));
 	ctx->position = 0;
+	ctx->dirty = false;
 
 	/* stage 1: name + custom */
 
@@ -1233,10 +1421,18 @@ void qsc_keccak_absorb_key_custom(qsc_keccak_state* ctx, qsc_keccak_rate rate, c
 	keccak_fast_absorb(ctx->state, pad, rate);
 	qsc_keccak_permute(ctx, rounds);
 
-
 	/* stage 2: key */
 
-	qsc_memutils_clear(pad, rate);
+	qsc_keccak_absorb_key(ctx, rate, key, keylen, rounds);
+}
+
+void qsc_keccak_absorb_key(qsc_keccak_state* ctx, qsc_keccak_rate rate, const uint8_t* key, size_t keylen, size_t rounds)
+{
+	assert(ctx != NULL);
+
+	uint8_t pad[QSC_KECCAK_STATE_BYTE_SIZE] = { 0 };
+	size_t oft;
+	size_t i;
 
 	oft = keccak_left_encode(pad, rate);
 	oft += keccak_left_encode((pad + oft), keylen * 8);
@@ -1268,8 +1464,8 @@ void qsc_keccak_dispose(qsc_keccak_state* ctx)
 
 	if (ctx != NULL)
 	{
-		qsc_memutils_clear((uint8_t*)ctx->state, sizeof(ctx->state));
-		qsc_memutils_clear(ctx->buffer, sizeof(ctx->buffer));
+		qsc_memutils_secure_wipe((uint8_t*)ctx->state, sizeof(ctx->state));
+		keccak_buffer_wipe(ctx);
 		ctx->position = 0;
 	}
 }
@@ -1313,7 +1509,7 @@ void qsc_keccak_finalize(qsc_keccak_state* ctx, qsc_keccak_rate rate, uint8_t* o
 		qsc_memutils_copy(output, pad, outlen);
 	}
 
-	qsc_memutils_clear(ctx->buffer, sizeof(ctx->buffer));
+	keccak_buffer_wipe(ctx);
 	ctx->position = 0;
 }
 
@@ -1343,11 +1539,7 @@ void qsc_keccak_incremental_absorb(qsc_keccak_state* ctx, uint32_t rate, const u
 
 	if (ctx->position && msglen >= rate - ctx->position)
 	{
-		for (i = 0; i < (rate - ctx->position) / 8; ++i)
-		{
-			ctx->state[(ctx->position / 8) + i] ^= qsc_intutils_le8to64(message + (8 * i));
-		}
-
+		keccak_fast_absorb(ctx->state + (ctx->position / 8), message, rate - ctx->position);
 		message += rate - ctx->position;
 		msglen -= rate - ctx->position;
 		ctx->position = 0;
@@ -1356,21 +1548,14 @@ void qsc_keccak_incremental_absorb(qsc_keccak_state* ctx, uint32_t rate, const u
 
 	while (msglen >= rate)
 	{
-		for (i = 0; i < rate / 8; i++)
-		{
-			ctx->state[i] ^= qsc_intutils_le8to64(message + (8 * i));
-		}
-
+		keccak_fast_absorb(ctx->state, message, rate);
 		message += rate;
 		msglen -= rate;
 		qsc_keccak_permute_p1600c(ctx->state, QSC_KECCAK_PERMUTATION_ROUNDS);
 	}
 
-	for (i = 0; i < msglen / 8; ++i)
-	{
-		ctx->state[(ctx->position / 8) + i] ^= qsc_intutils_le8to64(message + (8 * i));
-	}
-
+	i = msglen / 8;
+	keccak_fast_absorb(ctx->state + (ctx->position / 8), message, 8 * i);
 	message += 8 * i;
 	msglen -= 8 * i;
 	ctx->position += 8 * i;
@@ -1431,11 +1616,7 @@ void qsc_keccak_incremental_squeeze(qsc_keccak_state* ctx, size_t rate, uint8_t*
 
 	if (ctx->position && outlen >= rate - ctx->position)
 	{
-		for (i = 0; i < (rate - ctx->position) / 8; ++i)
-		{
-			qsc_intutils_le64to8(output + (8 * i), ctx->state[(ctx->position / 8) + i]);
-		}
-
+		qsc_intutils_le64to8_array(output, ctx->state + (ctx->position / 8), (rate - ctx->position) / 8);
 		output += rate - ctx->position;
 		outlen -= rate - ctx->position;
 		ctx->position = 0;
@@ -1445,11 +1626,7 @@ void qsc_keccak_incremental_squeeze(qsc_keccak_state* ctx, size_t rate, uint8_t*
 	{
 		qsc_keccak_permute_p1600c(ctx->state, QSC_KECCAK_PERMUTATION_ROUNDS);
 
-		for (i = 0; i < rate / 8; ++i)
-		{
-			qsc_intutils_le64to8(output + (8 * i), ctx->state[i]);
-		}
-
+		qsc_intutils_le64to8_array(output, ctx->state, rate / 8);
 		output += rate;
 		outlen -= rate;
 	}
@@ -1461,11 +1638,8 @@ void qsc_keccak_incremental_squeeze(qsc_keccak_state* ctx, size_t rate, uint8_t*
 			qsc_keccak_permute_p1600c(ctx->state, QSC_KECCAK_PERMUTATION_ROUNDS);
 		}
 
-		for (i = 0; i < outlen / 8; ++i)
-		{
-			qsc_intutils_le64to8(output + (8 * i), ctx->state[(ctx->position / 8) + i]);
-		}
-
+		i = outlen / 8;
+		qsc_intutils_le64to8_array(output, ctx->state + (ctx->position / 8), i);
 		output += 8 * i;
 		outlen -= 8 * i;
 		ctx->position += 8 * i;
@@ -1495,7 +1669,7 @@ void qsc_keccak_permute(qsc_keccak_state* ctx, size_t rounds)
 	}
 }
 
-void qsc_keccak_permute_p1600c(uint64_t* state, size_t rounds)
+static void keccak_permute_p1600c_rc(uint64_t* state, size_t rounds, const uint64_t* rc)
 {
 	assert(state != NULL);
 	assert(rounds % 2 == 0);
@@ -1615,7 +1789,7 @@ void qsc_keccak_permute_p1600c(uint64_t* state, size_t rounds)
 		Asu ^= Du;
 		BCu = qsc_intutils_rotl64(Asu, 14);
 		Eba = BCa ^ ((~BCe) & BCi);
-		Eba ^= KECCAK_ROUND_CONSTANTS[i];
+		Eba ^= rc[i];
 		Ebe = BCe ^ ((~BCi) & BCo);
 		Ebi = BCi ^ ((~BCo) & BCu);
 		Ebo = BCo ^ ((~BCu) & BCa);
@@ -1710,7 +1884,7 @@ void qsc_keccak_permute_p1600c(uint64_t* state, size_t rounds)
 		Esu ^= Du;
 		BCu = qsc_intutils_rotl64(Esu, 14);
 		Aba = BCa ^ ((~BCe) & BCi);
-		Aba ^= KECCAK_ROUND_CONSTANTS[i + 1];
+		Aba ^= rc[i + 1];
 		Abe = BCe ^ ((~BCi) & BCo);
 		Abi = BCi ^ ((~BCo) & BCu);
 		Abo = BCo ^ ((~BCu) & BCa);
@@ -1809,6 +1983,11 @@ void qsc_keccak_permute_p1600c(uint64_t* state, size_t rounds)
 	state[24] = Asu;
 }
 
+void qsc_keccak_permute_p1600c(uint64_t* state, size_t rounds)
+{
+	keccak_permute_p1600c_rc(state, rounds, KECCAK_ROUND_CONSTANTS);
+}
+
 void qsc_keccak_permute_p1600u(uint64_t* state)
 {
 	assert(state != NULL);
@@ -4027,14 +4206,7 @@ void qsc_keccak_squeezeblocks(qsc_keccak_state* ctx, uint8_t* output, size_t nbl
 		{
 			qsc_keccak_permute(ctx, rounds);
 
-#if defined(QSC_SYSTEM_IS_LITTLE_ENDIAN)
-			qsc_memutils_copy(output, (uint8_t*)ctx->state, rate);
-#else
-			for (size_t i = 0; i < (rate >> 3); ++i)
-			{
-				qsc_intutils_le64to8((output + sizeof(uint64_t) * i), ctx->state[i]);
-			}
-#endif
+			qsc_intutils_le64to8_array(output, ctx->state, rate >> 3);
 			output += rate;
 			nblocks--;
 		}
@@ -4047,9 +4219,11 @@ void qsc_keccak_initialize_state(qsc_keccak_state* ctx)
 
 	if (ctx != NULL)
 	{
+		/* the state may be new, so the dirty flag is not yet valid and the buffer is always erased */
 		qsc_memutils_clear((uint8_t*)ctx->state, sizeof(ctx->state));
-		qsc_memutils_clear(ctx->buffer, sizeof(ctx->buffer));
+		qsc_memutils_secure_wipe(ctx->buffer, sizeof(ctx->buffer));
 		ctx->position = 0;
+		ctx->dirty = false;
 	}
 }
 
@@ -4067,6 +4241,7 @@ void qsc_keccak_update(qsc_keccak_state* ctx, qsc_keccak_rate rate, const uint8_
 			if (RMDLEN != 0)
 			{
 				qsc_memutils_copy((ctx->buffer + ctx->position), message, RMDLEN);
+				ctx->dirty = true;
 			}
 
 			keccak_fast_absorb(ctx->state, ctx->buffer, (size_t)rate);
@@ -4079,6 +4254,7 @@ void qsc_keccak_update(qsc_keccak_state* ctx, qsc_keccak_rate rate, const uint8_
 		/* sequential loop through blocks */
 		while (msglen >= (size_t)rate)
 		{
+			qsc_memutils_prefetch_ahead(message, msglen, 0, KECCAK_PREFETCH_BLOCKS * (size_t)rate, (size_t)rate, qsc_memutils_cache_level_l1);
 			keccak_fast_absorb(ctx->state, message, rate);
 			qsc_keccak_permute(ctx, rounds);
 			message += rate;
@@ -4090,6 +4266,7 @@ void qsc_keccak_update(qsc_keccak_state* ctx, qsc_keccak_rate rate, const uint8_
 		{
 			qsc_memutils_copy((ctx->buffer + ctx->position), message, msglen);
 			ctx->position += msglen;
+			ctx->dirty = true;
 		}
 	}
 }
@@ -4151,19 +4328,12 @@ void qsc_sha3_finalize(qsc_keccak_state* ctx, qsc_keccak_rate rate, uint8_t* out
 	hlen = (((QSC_KECCAK_STATE_SIZE * sizeof(uint64_t)) - rate) / 2);
 	qsc_memutils_clear((ctx->buffer + ctx->position), sizeof(ctx->buffer) - ctx->position);
 	ctx->buffer[ctx->position] = QSC_KECCAK_SHA3_DOMAIN_ID;
+	ctx->dirty = true;
 	ctx->buffer[rate - 1] |= 128U;
 	keccak_fast_absorb(ctx->state, ctx->buffer, rate);
 	qsc_keccak_permute(ctx, QSC_KECCAK_PERMUTATION_ROUNDS);
 
-#if defined(QSC_SYSTEM_IS_LITTLE_ENDIAN)
-	qsc_memutils_copy(output, (uint8_t*)ctx->state, hlen);
-#else
-	for (size_t i = 0; i < hlen / sizeof(uint64_t); ++i)
-	{
-		qsc_intutils_le64to8(output, ctx->state[i]);
-		output += sizeof(uint64_t);
-	}
-#endif
+	qsc_intutils_le64to8_array(output, ctx->state, hlen / sizeof(uint64_t));
 
 	qsc_keccak_dispose(ctx);
 }
@@ -4472,14 +4642,7 @@ static void kpa_absorb_leaves(uint64_t* state, qsc_keccak_rate rate, const uint8
 
 	while (inplen >= (size_t)rate)
 	{
-#if defined(QSC_SYSTEM_IS_LITTLE_ENDIAN)
-		qsc_memutils_xor((uint8_t*)state, input, rate);
-#else
-		for (size_t i = 0; i < rate / sizeof(uint64_t); ++i)
-		{
-			state[i] ^= qsc_intutils_le8to64(input + (sizeof(uint64_t) * i));
-		}
-#endif
+		keccak_fast_absorb(state, input, (size_t)rate);
 		qsc_keccak_permute_p1600c(state, QSC_KPA_ROUNDS);
 		inplen -= rate;
 		input += rate;
@@ -4487,15 +4650,7 @@ static void kpa_absorb_leaves(uint64_t* state, qsc_keccak_rate rate, const uint8
 
 	if (inplen != 0)
 	{
-#if defined(QSC_SYSTEM_IS_LITTLE_ENDIAN)
-		qsc_memutils_xor((uint8_t*)state, input, inplen);
-#else
-		for (size_t i = 0; i < inplen / sizeof(uint64_t); ++i)
-		{
-			state[i] ^= qsc_intutils_le8to64(input + (sizeof(uint64_t) * i));
-		}
-#endif
-
+		keccak_fast_absorb(state, input, inplen);
 		qsc_keccak_permute_p1600c(state, QSC_KPA_ROUNDS);
 	}
 }
@@ -4554,14 +4709,7 @@ static void kpa_fast_absorbx8(qsc_kpa_state* ctx, const uint8_t* message)
 
 	for (size_t i = 0; i < QSC_KPA_PARALLELISM; ++i)
 	{
-#if defined(QSC_SYSTEM_IS_LITTLE_ENDIAN)
-		qsc_memutils_xor((uint8_t*)ctx->state[i], (message + (i * (size_t)ctx->rate)), (size_t)ctx->rate);
-#else
-		for (size_t j = 0; j < (size_t)ctx->rate / sizeof(uint64_t); ++j)
-		{
-			ctx->state[i][j] ^= qsc_intutils_le8to64((message + (i * (size_t)ctx->rate) + (j * sizeof(uint64_t))));
-		}
-#endif
+		keccak_fast_absorb(ctx->state[i], (message + (i * (size_t)ctx->rate)), (size_t)ctx->rate);
 	}
 #endif
 }
@@ -4592,23 +4740,133 @@ static void kpa_squeezeblocks(uint64_t* state, uint8_t* output, size_t nblocks,
 	{
 		qsc_keccak_permute_p1600c(state, QSC_KPA_ROUNDS);
 
-#if defined(QSC_SYSTEM_IS_LITTLE_ENDIAN)
-		qsc_memutils_copy(output, (uint8_t*)state, (size_t)rate);
-#else
-		for (size_t i = 0; i < (rate >> 3); ++i)
+		qsc_intutils_le64to8_array(output, state, (size_t)rate >> 3);
+		output += rate;
+		nblocks--;
+	}
+}
+
+static size_t kpa_leaf_size(qsc_keccak_rate rate)
+{
+	return (rate == QSC_KECCAK_512_RATE) ?
+		KPA_LEAF_HASH512 : (rate == QSC_KECCAK_256_RATE) ?
+		KPA_LEAF_HASH256 : KPA_LEAF_HASH128;
+}
+
+static void kpa_absorb_prefix(uint64_t* tmps, qsc_keccak_rate rate, const uint8_t* key, size_t keylen, const uint8_t* custom, size_t custlen)
+{
+	assert(tmps != NULL);
+
+	uint8_t pad[QSC_KECCAK_STATE_BYTE_SIZE] = { 0 };
+	size_t oft;
+	size_t i;
+
+	/* stage 1: add customization to state */
+
+	if (custlen != 0)
+	{
+		oft = keccak_left_encode(pad, rate);
+		oft += keccak_left_encode((pad + oft), custlen * 8);
+
+		for (i = 0; i < custlen; ++i)
 		{
-			qsc_intutils_le64to8((output + sizeof(uint64_t) * i), state[i]);
+			if (oft == (size_t)rate)
+			{
+				keccak_fast_absorb(tmps, pad, rate);
+				qsc_keccak_permute_p1600c(tmps, QSC_KPA_ROUNDS);
+				oft = 0;
+			}
+
+			pad[oft] = custom[i];
+			++oft;
 		}
-#endif
+
+		if (oft != 0)
+		{
+			/* absorb custom and name, and permute state */
+			qsc_memutils_clear((pad + oft), (size_t)rate - oft);
+			keccak_fast_absorb(tmps, pad, rate);
+			qsc_keccak_permute_p1600c(tmps, QSC_KPA_ROUNDS);
+		}
+	}
+
+	/* stage 2: add key to state  */
+
+	if (keylen != 0)
+	{
+		qsc_memutils_clear(pad, rate);
+		oft = keccak_left_encode(pad, rate);
+		oft += keccak_left_encode((pad + oft), keylen * 8);
+
+		for (i = 0; i < keylen; ++i)
+		{
+			if (oft == (size_t)rate)
+			{
+				keccak_fast_absorb(tmps, pad, rate);
+				qsc_keccak_permute_p1600c(tmps, QSC_KPA_ROUNDS);
+				oft = 0;
+			}
+
+			pad[oft] = key[i];
+			++oft;
+		}
+
+		if (oft != 0)
+		{
+			/* absorb the key and permute the state */
+			qsc_memutils_clear((pad + oft), (size_t)rate - oft);
+			keccak_fast_absorb(tmps, pad, rate);
+			qsc_keccak_permute_p1600c(tmps, QSC_KPA_ROUNDS);
+		}
+	}
+}
+
+static void kpa_root_finalize(uint64_t* pstate, qsc_keccak_rate rate, size_t processed, uint8_t domain, uint8_t* output, size_t outlen)
+{
+	assert(pstate != NULL);
+	assert(output != NULL);
+
+	uint8_t pad[QSC_KECCAK_STATE_BYTE_SIZE] = { 0 };
+	uint8_t prcb[2 * sizeof(uint64_t)] = { 0 };
+	size_t bitlen;
+
+	/* add total processed bytes and output length to padding string */
+	bitlen = keccak_right_encode(prcb, outlen * 8);
+	bitlen += keccak_right_encode((prcb + bitlen), processed * 8);
+	/* copy to buffer */
+	qsc_memutils_copy(pad, prcb, bitlen);
+
+	/* add the domain id */
+	pad[bitlen] = domain;
+	/* clamp the last byte */
+	pad[(size_t)rate - 1] |= 128U;
+
+	/* absorb the buffer into parent state */
+	keccak_fast_absorb(pstate, pad, (size_t)rate);
+
+	/* squeeze blocks to produce the output hash */
+	while (outlen >= (size_t)rate)
+	{
+		kpa_squeezeblocks(pstate, pad, 1, rate);
+		qsc_memutils_copy(output, pad, rate);
 		output += rate;
-		nblocks--;
+		outlen -= rate;
+	}
+
+	/* add unaligned hash bytes */
+	if (outlen > 0)
+	{
+		kpa_squeezeblocks(pstate, pad, 1, rate);
+		qsc_memutils_copy(output, pad, outlen);
 	}
+
+	qsc_memutils_clear(pad, sizeof(pad));
 }
 
 #if defined(QSC_KPA_AVX_PARALLEL)
 
 #if defined(KPA_HISTORICAL_ENABLE)
-static void kpa_load_state(qsc_kpa_state* ctx)
+static void kpa_load_state(qsc_kpa_state* ctx, const uint64_t state[QSC_KPA_PARALLELISM][QSC_KECCAK_STATE_SIZE])
 {
 	/* Note: artifact, not currently used */
 	assert(ctx != NULL);
@@ -4618,8 +4876,8 @@ static void kpa_load_state(qsc_kpa_state* ctx)
 	__m512i idx;
 	size_t pos;
 
-	idx = _mm512_set_epi64((int64_t)&ctx->state[7][0], (int64_t)&ctx->state[6][0], (int64_t)&ctx->state[5][0], (int64_t)&ctx->state[4][0],
-		(int64_t)&ctx->state[3][0], (int64_t)&ctx->state[2][0], (int64_t)&ctx->state[1][0], (int64_t)&ctx->state[0][0]);
+	idx = _mm512_set_epi64((int64_t)&state[7][0], (int64_t)&state[6][0], (int64_t)&state[5][0], (int64_t)&state[4][0],
+		(int64_t)&state[3][0], (int64_t)&state[2][0], (int64_t)&state[1][0], (int64_t)&state[0][0]);
 
 	pos = 0;
 
@@ -4635,40 +4893,41 @@ static void kpa_load_state(qsc_kpa_state* ctx)
 
 	for (size_t i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
 	{
-		tmp[0] = ctx->state[0][i];
-		tmp[1] = ctx->state[1][i];
-		tmp[2] = ctx->state[2][i];
-		tmp[3] = ctx->state[3][i];
+		tmp[0] = state[0][i];
+		tmp[1] = state[1][i];
+		tmp[2] = state[2][i];
+		tmp[3] = state[3][i];
 		ctx->statew[0][i] = _mm256_loadu_si256((const __m256i*)tmp);
-		tmp[0] = ctx->state[4][i];
-		tmp[1] = ctx->state[5][i];
-		tmp[2] = ctx->state[6][i];
-		tmp[3] = ctx->state[7][i];
+		tmp[0] = state[4][i];
+		tmp[1] = state[5][i];
+		tmp[2] = state[6][i];
+		tmp[3] = state[7][i];
 		ctx->statew[1][i] = _mm256_loadu_si256((const __m256i*)tmp);
 	}
 #endif
 }
 #endif
 
-static void kpa_store_state(qsc_kpa_state* ctx)
+static void kpa_store_state(const qsc_kpa_state* ctx, uint64_t state[QSC_KPA_PARALLELISM][QSC_KECCAK_STATE_SIZE])
 {
 	assert(ctx != NULL);
+	assert(state != NULL);
 
 #if defined(QSC_SYSTEM_HAS_AVX512)
 
-	uint64_t tmp[8] = { 0 };
+	QSC_ALIGN(64) uint64_t tmp[8] = { 0 };
 
 	for (size_t i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
 	{
-		_mm512_storeu_si512((__m512i*)tmp, ctx->statew[i]);
-		ctx->state[0][i] = tmp[0];
-		ctx->state[1][i] = tmp[1];
-		ctx->state[2][i] = tmp[2];
-		ctx->state[3][i] = tmp[3];
-		ctx->state[4][i] = tmp[4];
-		ctx->state[5][i] = tmp[5];
-		ctx->state[6][i] = tmp[6];
-		ctx->state[7][i] = tmp[7];
+		_mm512_store_si512((__m512i*)tmp, ctx->statew[i]);
+		state[0][i] = tmp[0];
+		state[1][i] = tmp[1];
+		state[2][i] = tmp[2];
+		state[3][i] = tmp[3];
+		state[4][i] = tmp[4];
+		state[5][i] = tmp[5];
+		state[6][i] = tmp[6];
+		state[7][i] = tmp[7];
 	}
 
 #elif defined(QSC_SYSTEM_HAS_AVX2)
@@ -4677,16 +4936,16 @@ static void kpa_store_state(qsc_kpa_state* ctx)
 
 	for (size_t i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
 	{
-		_mm256_storeu_si256((__m256i*)tmp, ctx->statew[0][i]);
-		ctx->state[0][i] = tmp[0];
-		ctx->state[1][i] = tmp[1];
-		ctx->state[2][i] = tmp[2];
-		ctx->state[3][i] = tmp[3];
-		_mm256_storeu_si256((__m256i*)tmp, ctx->statew[1][i]);
-		ctx->state[4][i] = tmp[0];
-		ctx->state[5][i] = tmp[1];
-		ctx->state[6][i] = tmp[2];
-		ctx->state[7][i] = tmp[3];
+		_mm256_store_si256((__m256i*)tmp, ctx->statew[0][i]);
+		state[0][i] = tmp[0];
+		state[1][i] = tmp[1];
+		state[2][i] = tmp[2];
+		state[3][i] = tmp[3];
+		_mm256_store_si256((__m256i*)tmp, ctx->statew[1][i]);
+		state[4][i] = tmp[0];
+		state[5][i] = tmp[1];
+		state[6][i] = tmp[2];
+		state[7][i] = tmp[3];
 	}
 
 #endif
@@ -4700,15 +4959,15 @@ void qsc_kpa_dispose(qsc_kpa_state* ctx)
 
 	if (ctx != NULL)
 	{
+#if defined(QSC_KPA_AVX_PARALLEL)
+		qsc_memutils_clear((uint8_t*)ctx->statew, sizeof(ctx->statew));
+#else
 		qsc_memutils_clear((uint8_t*)ctx->state, sizeof(ctx->state));
+#endif
 		qsc_memutils_clear(ctx->buffer, sizeof(ctx->buffer));
 		ctx->position = 0;
 		ctx->processed = 0;
 		ctx->rate = 0;
-
-#if defined(QSC_KPA_AVX_PARALLEL)
-		qsc_memutils_clear((uint8_t*)ctx->statew, sizeof(ctx->statew));
-#endif
 	}
 }
 
@@ -4724,8 +4983,6 @@ void qsc_kpa_finalize(qsc_kpa_state* ctx, uint8_t* output, size_t outlen)
 
 	uint8_t fbuf[QSC_KPA_PARALLELISM * KPA_LEAF_HASH512] = { 0 };
 	uint64_t pstate[QSC_KECCAK_STATE_SIZE] = { 0 };
-	uint8_t prcb[2 * sizeof(uint64_t)] = { 0 };
-	size_t bitlen;
 
 	/* clear unused buffer */
 	if (ctx->position != 0)
@@ -4739,51 +4996,29 @@ void qsc_kpa_finalize(qsc_kpa_state* ctx, uint8_t* output, size_t outlen)
 	ctx->processed += ctx->position;
 
 #if defined(QSC_KPA_AVX_PARALLEL)
-	kpa_store_state(ctx);
+	/* convert the native state to scalar leaves only at finalization */
+	uint64_t leaves[QSC_KPA_PARALLELISM][QSC_KECCAK_STATE_SIZE];
+	kpa_store_state(ctx, leaves);
+#else
+	uint64_t (*leaves)[QSC_KECCAK_STATE_SIZE] = ctx->state;
 #endif
 
 	/* collect leaf node hashes */
 	for (size_t i = 0; i < QSC_KPA_PARALLELISM; ++i)
 	{
 		/* copy each of the leaf hashes to the buffer */
-		qsc_memutils_copy((fbuf + (i * HASHLEN)), (uint8_t*)ctx->state[i], HASHLEN);
+		qsc_memutils_copy((fbuf + (i * HASHLEN)), (uint8_t*)leaves[i], HASHLEN);
 	}
 
+#if defined(QSC_KPA_AVX_PARALLEL)
+	qsc_memutils_clear((uint8_t*)leaves, sizeof(leaves));
+#endif
+
 	/* absorb the leaves into the root state and permute */
 	kpa_absorb_leaves(pstate, ctx->rate, fbuf, QSC_KPA_PARALLELISM * HASHLEN);
 
-	/* clear buffer */
-	qsc_memutils_clear(ctx->buffer, sizeof(ctx->buffer));
-
-	/* add total processed bytes and output length to padding string */
-	bitlen = keccak_right_encode(prcb, outlen * 8);
-	bitlen += keccak_right_encode((prcb + bitlen), ctx->processed * 8);
-	/* copy to buffer */
-	qsc_memutils_copy(ctx->buffer, prcb, bitlen);
-
-	/* add the domain id */
-	ctx->buffer[bitlen] = QSC_KECCAK_KPA_DOMAIN_ID;
-	/* clamp the last byte */
-	ctx->buffer[(size_t)ctx->rate - 1] |= 128U;
-
-	/* absorb the buffer into parent state */
-	keccak_fast_absorb(pstate, ctx->buffer, (size_t)ctx->rate);
-
-	/* squeeze blocks to produce the output hash */
-	while (outlen >= (size_t)ctx->rate)
-	{
-		kpa_squeezeblocks(pstate, ctx->buffer, 1, ctx->rate);
-		qsc_memutils_copy(output, ctx->buffer, ctx->rate);
-		output += ctx->rate;
-		outlen -= ctx->rate;
-	}
-
-	/* add unaligned hash bytes */
-	if (outlen > 0)
-	{
-		kpa_squeezeblocks(pstate, ctx->buffer, 1, ctx->rate);
-		qsc_memutils_copy(output, ctx->buffer, outlen);
-	}
+	/* pad, permute, and squeeze the root state */
+	kpa_root_finalize(pstate, ctx->rate, ctx->processed, QSC_KECCAK_KPA_DOMAIN_ID, output, outlen);
 
 	/* reset the buffer and counters */
 	qsc_memutils_clear(ctx->buffer, sizeof(ctx->buffer));
@@ -4797,10 +5032,8 @@ void qsc_kpa_initialize(qsc_kpa_state* ctx, const uint8_t* key, size_t keylen, c
 	assert(key != NULL);
 
 	uint64_t tmps[QSC_KECCAK_STATE_SIZE] = { 0 };
-	uint8_t pad[QSC_KECCAK_STATE_BYTE_SIZE] = { 0 };
 	uint8_t algb[8] = { 0x00, 0x00, 0x4B, 0x42, 0x41, 0xAD, 0x31, 0x32 };
 	uint64_t algn;
-	size_t oft;
 	size_t i;
 
 	/* set state values */
@@ -4810,74 +5043,17 @@ void qsc_kpa_initialize(qsc_kpa_state* ctx, const uint8_t* key, size_t keylen, c
 		QSC_KECCAK_128_RATE : (keylen == QSC_KPA_256_KEY_SIZE) ?
 		QSC_KECCAK_256_RATE : QSC_KECCAK_512_RATE;
 
-	qsc_memutils_clear((uint8_t*)ctx->state, sizeof(ctx->state));
 	qsc_memutils_clear(ctx->buffer, sizeof(ctx->buffer));
 
-	/* stage 1: add customization to state */
+	/* stages 1 and 2: add customization and key to state */
+	kpa_absorb_prefix(tmps, ctx->rate, key, keylen, custom, custlen);
 
-	if (custlen != 0)
-	{
-		oft = keccak_left_encode(pad, ctx->rate);
-		oft += keccak_left_encode((pad + oft), custlen * 8);
+	/* stage 3: copy state to leaf nodes, and add leaf-unique name string */
+#if defined(QSC_KPA_AVX_PARALLEL)
 
-		for (i = 0; i < custlen; ++i)
-		{
-			if (oft == (size_t)ctx->rate)
-			{
-				keccak_fast_absorb(tmps, pad, ctx->rate);
-				qsc_keccak_permute_p1600c(tmps, QSC_KPA_ROUNDS);
-				oft = 0;
-			}
+	uint64_t tmpi[8] = { 0 };
 
-			pad[oft] = custom[i];
-			++oft;
-		}
-
-		if (oft != 0)
-		{
-			/* absorb custom and name, and permute state */
-			qsc_memutils_clear((pad + oft), (size_t)ctx->rate - oft);
-			keccak_fast_absorb(tmps, pad, ctx->rate);
-			qsc_keccak_permute_p1600c(tmps, QSC_KPA_ROUNDS);
-		}
-	}
-
-	/* stage 2: add key to state  */
-
-	if (keylen != 0)
-	{
-		qsc_memutils_clear(pad, ctx->rate);
-		oft = keccak_left_encode(pad, ctx->rate);
-		oft += keccak_left_encode((pad + oft), keylen * 8);
-
-		for (i = 0; i < keylen; ++i)
-		{
-			if (oft == (size_t)ctx->rate)
-			{
-				keccak_fast_absorb(tmps, pad, ctx->rate);
-				qsc_keccak_permute_p1600c(tmps, QSC_KPA_ROUNDS);
-				oft = 0;
-			}
-
-			pad[oft] = key[i];
-			++oft;
-		}
-
-		if (oft != 0)
-		{
-			/* absorb the key and permute the state */
-			qsc_memutils_clear((pad + oft), (size_t)ctx->rate - oft);
-			keccak_fast_absorb(tmps, pad, ctx->rate);
-			qsc_keccak_permute_p1600c(tmps, QSC_KPA_ROUNDS);
-		}
-	}
-
-	/* stage 3: copy state to leaf nodes, and add leaf-unique name string */
-#if defined(QSC_KPA_AVX_PARALLEL)
-
-	uint64_t tmpi[8] = { 0 };
-
-#	if defined(QSC_SYSTEM_HAS_AVX512)
+#	if defined(QSC_SYSTEM_HAS_AVX512)
 
 	for (i = 1; i < QSC_KECCAK_STATE_SIZE; ++i)
 	{
@@ -4984,6 +5160,1159 @@ void qsc_kpa_update(qsc_kpa_state* ctx, const uint8_t* message, size_t msglen)
 	}
 }
 
+/* KPA-16 */
+
+static void kpa16_fast_absorb(qsc_kpa16_state* ctx, const uint8_t* message)
+{
+	assert(ctx != NULL);
+	assert(message != NULL);
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+
+	const int64_t ROFT = (int64_t)ctx->rate;
+	const __m512i idx = _mm512_set_epi64(7 * ROFT, 6 * ROFT, 5 * ROFT, 4 * ROFT, 3 * ROFT, 2 * ROFT, ROFT, 0);
+	const uint8_t* pmsg;
+	__m512i wbuf;
+
+	for (size_t i = 0; i < 2; ++i)
+	{
+		pmsg = message + (i * 8 * (size_t)ctx->rate);
+
+		for (size_t j = 0; j < (size_t)ctx->rate / sizeof(uint64_t); ++j)
+		{
+			wbuf = _mm512_i64gather_epi64(idx, (const void*)(pmsg + (j * sizeof(uint64_t))), 1);
+			ctx->statew[i][j] = _mm512_xor_si512(ctx->statew[i][j], wbuf);
+		}
+	}
+
+#elif defined(QSC_SYSTEM_HAS_AVX2)
+
+	const size_t ROFT = (size_t)ctx->rate;
+	QSC_ALIGN(32) uint64_t tmp[4] = { 0 };
+	const uint8_t* pmsg;
+	__m256i wbuf;
+
+	for (size_t i = 0; i < 4; ++i)
+	{
+		pmsg = message + (i * 4 * ROFT);
+
+		for (size_t j = 0; j < ROFT / sizeof(uint64_t); ++j)
+		{
+			tmp[0] = qsc_intutils_le8to64(pmsg);
+			tmp[1] = qsc_intutils_le8to64(pmsg + ROFT);
+			tmp[2] = qsc_intutils_le8to64(pmsg + (2 * ROFT));
+			tmp[3] = qsc_intutils_le8to64(pmsg + (3 * ROFT));
+			wbuf = _mm256_load_si256((const __m256i*)tmp);
+			ctx->statew[i][j] = _mm256_xor_si256(ctx->statew[i][j], wbuf);
+			pmsg += sizeof(uint64_t);
+		}
+	}
+
+#else
+
+	for (size_t i = 0; i < QSC_KPA16_PARALLELISM; ++i)
+	{
+		keccak_fast_absorb(ctx->state[i], (message + (i * (size_t)ctx->rate)), (size_t)ctx->rate);
+	}
+
+#endif
+}
+
+static void kpa16_permute(qsc_kpa16_state* ctx)
+{
+	assert(ctx != NULL);
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+	keccak_permute_p16x1600(ctx->statew, QSC_KPA_ROUNDS);
+#elif defined(QSC_SYSTEM_HAS_AVX2)
+	qsc_keccak_permute_p4x1600(ctx->statew[0], QSC_KPA_ROUNDS);
+	qsc_keccak_permute_p4x1600(ctx->statew[1], QSC_KPA_ROUNDS);
+	qsc_keccak_permute_p4x1600(ctx->statew[2], QSC_KPA_ROUNDS);
+	qsc_keccak_permute_p4x1600(ctx->statew[3], QSC_KPA_ROUNDS);
+#else
+	for (size_t i = 0; i < QSC_KPA16_PARALLELISM; ++i)
+	{
+		qsc_keccak_permute_p1600c(ctx->state[i], QSC_KPA_ROUNDS);
+	}
+#endif
+}
+
+#if defined(QSC_KPA_AVX_PARALLEL)
+static void kpa16_store_state(const qsc_kpa16_state* ctx, uint64_t state[QSC_KPA16_PARALLELISM][QSC_KECCAK_STATE_SIZE])
+{
+	assert(ctx != NULL);
+	assert(state != NULL);
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+
+	QSC_ALIGN(64) uint64_t tmp[8] = { 0 };
+
+	for (size_t i = 0; i < 2; ++i)
+	{
+		for (size_t j = 0; j < QSC_KECCAK_STATE_SIZE; ++j)
+		{
+			_mm512_store_si512((__m512i*)tmp, ctx->statew[i][j]);
+
+			for (size_t k = 0; k < 8; ++k)
+			{
+				state[(i * 8) + k][j] = tmp[k];
+			}
+		}
+	}
+
+#else
+
+	QSC_ALIGN(32) uint64_t tmp[4] = { 0 };
+
+	for (size_t i = 0; i < 4; ++i)
+	{
+		for (size_t j = 0; j < QSC_KECCAK_STATE_SIZE; ++j)
+		{
+			_mm256_store_si256((__m256i*)tmp, ctx->statew[i][j]);
+
+			for (size_t k = 0; k < 4; ++k)
+			{
+				state[(i * 4) + k][j] = tmp[k];
+			}
+		}
+	}
+
+#endif
+}
+#endif
+
+void qsc_kpa16_dispose(qsc_kpa16_state* ctx)
+{
+	assert(ctx != NULL);
+
+	if (ctx != NULL)
+	{
+#if defined(QSC_KPA_AVX_PARALLEL)
+		qsc_memutils_clear((uint8_t*)ctx->statew, sizeof(ctx->statew));
+#else
+		qsc_memutils_clear((uint8_t*)ctx->state, sizeof(ctx->state));
+#endif
+		qsc_memutils_clear(ctx->buffer, sizeof(ctx->buffer));
+		ctx->position = 0;
+		ctx->processed = 0;
+		ctx->rate = 0;
+	}
+}
+
+void qsc_kpa16_finalize(qsc_kpa16_state* ctx, uint8_t* output, size_t outlen)
+{
+	assert(ctx != NULL);
+	assert(output != NULL);
+	assert(outlen != 0);
+
+	const size_t HASHLEN = kpa_leaf_size(ctx->rate);
+	uint8_t fbuf[QSC_KPA16_PARALLELISM * KPA_LEAF_HASH512] = { 0 };
+	uint64_t pstate[QSC_KECCAK_STATE_SIZE] = { 0 };
+
+	/* clear unused buffer */
+	if (ctx->position != 0)
+	{
+		qsc_memutils_clear((ctx->buffer + ctx->position), sizeof(ctx->buffer) - ctx->position);
+		kpa16_fast_absorb(ctx, ctx->buffer);
+		kpa16_permute(ctx);
+	}
+
+	/* set processed counter to final position */
+	ctx->processed += ctx->position;
+
+#if defined(QSC_KPA_AVX_PARALLEL)
+	/* convert the native state to scalar leaves only at finalization */
+	uint64_t leaves[QSC_KPA16_PARALLELISM][QSC_KECCAK_STATE_SIZE];
+	kpa16_store_state(ctx, leaves);
+#else
+	uint64_t (*leaves)[QSC_KECCAK_STATE_SIZE] = ctx->state;
+#endif
+
+	/* collect leaf node hashes */
+	for (size_t i = 0; i < QSC_KPA16_PARALLELISM; ++i)
+	{
+		qsc_memutils_copy((fbuf + (i * HASHLEN)), (uint8_t*)leaves[i], HASHLEN);
+	}
+
+#if defined(QSC_KPA_AVX_PARALLEL)
+	qsc_memutils_clear((uint8_t*)leaves, sizeof(leaves));
+#endif
+
+	/* absorb the leaves into the root state, then pad and squeeze */
+	kpa_absorb_leaves(pstate, ctx->rate, fbuf, QSC_KPA16_PARALLELISM * HASHLEN);
+	kpa_root_finalize(pstate, ctx->rate, ctx->processed, QSC_KECCAK_KPA16_DOMAIN_ID, output, outlen);
+
+	/* reset the buffer and counters */
+	qsc_memutils_clear(fbuf, sizeof(fbuf));
+	qsc_memutils_clear(ctx->buffer, sizeof(ctx->buffer));
+	ctx->position = 0;
+	ctx->processed = 0;
+}
+
+void qsc_kpa16_initialize(qsc_kpa16_state* ctx, const uint8_t* key, size_t keylen, const uint8_t* custom, size_t custlen)
+{
+	assert(ctx != NULL);
+	assert(key != NULL);
+
+	uint64_t tmps[QSC_KECCAK_STATE_SIZE] = { 0 };
+	uint64_t tmpi[QSC_KPA16_PARALLELISM] = { 0 };
+	/* leaf name: 16-bit leaf index, KPA16, and the round count */
+	uint8_t algb[8] = { 0x00, 0x00, 0x4B, 0x50, 0x41, 0x31, 0x36, 0x0C };
+	size_t i;
+
+	/* set state values */
+	ctx->position = 0;
+	ctx->processed = 0;
+	ctx->rate = (keylen == QSC_KPA_128_KEY_SIZE) ?
+		QSC_KECCAK_128_RATE : (keylen == QSC_KPA_256_KEY_SIZE) ?
+		QSC_KECCAK_256_RATE : QSC_KECCAK_512_RATE;
+
+	qsc_memutils_clear(ctx->buffer, sizeof(ctx->buffer));
+
+	/* add customization and key to state */
+	kpa_absorb_prefix(tmps, ctx->rate, key, keylen, custom, custlen);
+
+	/* create each leafs unique name */
+	for (i = 0; i < QSC_KPA16_PARALLELISM; ++i)
+	{
+		qsc_intutils_be16to8(algb, ((uint16_t)i + 1));
+		tmpi[i] = tmps[0] ^ qsc_intutils_be8to64(algb);
+	}
+
+	/* copy state to leaf nodes, and add the leaf name */
+#if defined(QSC_SYSTEM_HAS_AVX512)
+
+	for (i = 1; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		ctx->statew[0][i] = _mm512_set1_epi64((int64_t)tmps[i]);
+		ctx->statew[1][i] = ctx->statew[0][i];
+	}
+
+	ctx->statew[0][0] = _mm512_loadu_si512((const __m512i*)tmpi);
+	ctx->statew[1][0] = _mm512_loadu_si512((const __m512i*)&tmpi[8]);
+
+#elif defined(QSC_SYSTEM_HAS_AVX2)
+
+	for (size_t j = 0; j < 4; ++j)
+	{
+		for (i = 1; i < QSC_KECCAK_STATE_SIZE; ++i)
+		{
+			ctx->statew[j][i] = _mm256_set1_epi64x((int64_t)tmps[i]);
+		}
+
+		ctx->statew[j][0] = _mm256_loadu_si256((const __m256i*)&tmpi[j * 4]);
+	}
+
+#else
+
+	for (i = 0; i < QSC_KPA16_PARALLELISM; ++i)
+	{
+		qsc_memutils_copy((uint8_t*)ctx->state[i], (uint8_t*)tmps, QSC_KECCAK_STATE_BYTE_SIZE);
+		ctx->state[i][0] = tmpi[i];
+	}
+
+#endif
+
+	/* permute leaf nodes */
+	kpa16_permute(ctx);
+}
+
+void qsc_kpa16_update(qsc_kpa16_state* ctx, const uint8_t* message, size_t msglen)
+{
+	assert(ctx != NULL);
+	assert(message != NULL);
+
+	const size_t BLKLEN = (size_t)ctx->rate * QSC_KPA16_PARALLELISM;
+
+	if (msglen != 0)
+	{
+		if (ctx->position != 0 && (ctx->position + msglen >= BLKLEN))
+		{
+			const size_t RMDLEN = BLKLEN - ctx->position;
+
+			if (RMDLEN != 0)
+			{
+				qsc_memutils_copy((ctx->buffer + ctx->position), message, RMDLEN);
+			}
+
+			kpa16_fast_absorb(ctx, ctx->buffer);
+			kpa16_permute(ctx);
+			ctx->processed += BLKLEN;
+			ctx->position = 0;
+			message += RMDLEN;
+			msglen -= RMDLEN;
+		}
+
+		/* sequential loop through blocks */
+		while (msglen >= BLKLEN)
+		{
+			kpa16_fast_absorb(ctx, message);
+			kpa16_permute(ctx);
+			ctx->processed += BLKLEN;
+			message += BLKLEN;
+			msglen -= BLKLEN;
+		}
+
+		/* store unaligned bytes */
+		if (msglen != 0)
+		{
+			qsc_memutils_copy((ctx->buffer + ctx->position), message, msglen);
+			ctx->position += msglen;
+		}
+	}
+}
+
+/* KPA tree mode */
+
+typedef struct
+{
+	const qsc_kpa_state* base;
+	const uint8_t* message;
+	size_t msglen;
+	uint8_t* cvs;
+	size_t first;
+	size_t count;
+} kpa_tree_job;
+
+static void kpa_tree_index(qsc_kpa_state* ctx, uint64_t index)
+{
+	assert(ctx != NULL);
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+	ctx->statew[1] = _mm512_xor_si512(ctx->statew[1], _mm512_set1_epi64((int64_t)index));
+#elif defined(QSC_SYSTEM_HAS_AVX2)
+	ctx->statew[0][1] = _mm256_xor_si256(ctx->statew[0][1], _mm256_set1_epi64x((int64_t)index));
+	ctx->statew[1][1] = _mm256_xor_si256(ctx->statew[1][1], _mm256_set1_epi64x((int64_t)index));
+#else
+	for (size_t i = 0; i < QSC_KPA_PARALLELISM; ++i)
+	{
+		ctx->state[i][1] ^= index;
+	}
+#endif
+
+	kpa_permutex8(ctx);
+}
+
+static void kpa_tree_subtrees(void* state)
+{
+	assert(state != NULL);
+
+	kpa_tree_job* job = (kpa_tree_job*)state;
+	const size_t CVLEN = kpa_leaf_size(job->base->rate);
+	const size_t TRELEN = (size_t)job->base->rate * QSC_KPA_PARALLELISM * QSC_KPA_TREE_SUBTREE_BLOCKS;
+	qsc_kpa_state ctx;
+	size_t oft;
+	size_t len;
+
+	for (size_t i = job->first; i < job->first + job->count; ++i)
+	{
+		oft = i * TRELEN;
+		len = (job->msglen - oft < TRELEN) ? job->msglen - oft : TRELEN;
+
+		/* copy the keyed state and add the subtree index */
+		ctx = *job->base;
+		kpa_tree_index(&ctx, (uint64_t)i + 1);
+
+		if (len != 0)
+		{
+			qsc_kpa_update(&ctx, job->message + oft, len);
+		}
+
+		qsc_kpa_finalize(&ctx, job->cvs + (i * CVLEN), CVLEN);
+	}
+
+	qsc_kpa_dispose(&ctx);
+}
+
+bool qsc_kpa_tree_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, const uint8_t* key, size_t keylen, const uint8_t* custom, size_t custlen, size_t threads)
+{
+	assert(output != NULL);
+	assert(outlen != 0);
+	assert(key != NULL);
+
+	kpa_tree_job jobs[QSC_ASYNC_THREADS_MAX];
+	qsc_thread tids[QSC_ASYNC_THREADS_MAX];
+	bool tact[QSC_ASYNC_THREADS_MAX] = { false };
+	uint8_t enc[sizeof(size_t) + 1] = { 0 };
+	qsc_keccak_state rctx = { 0 };
+	qsc_kpa_state base;
+	uint8_t* cvs;
+	size_t cvlen;
+	size_t elen;
+	size_t first;
+	size_t trecnt;
+	size_t trelen;
+	bool res;
+
+	res = false;
+
+	if (output != NULL && key != NULL && (message != NULL || msglen == 0))
+	{
+		qsc_kpa_initialize(&base, key, keylen, custom, custlen);
+
+		trelen = (size_t)base.rate * QSC_KPA_PARALLELISM * QSC_KPA_TREE_SUBTREE_BLOCKS;
+		trecnt = (msglen == 0) ? 1 : (msglen + trelen - 1) / trelen;
+		cvlen = kpa_leaf_size(base.rate);
+		cvs = (uint8_t*)qsc_memutils_malloc(trecnt * cvlen);
+
+		if (cvs != NULL)
+		{
+			if (threads == 0)
+			{
+				threads = qsc_async_processor_count();
+			}
+
+			threads = qsc_intutils_min(threads, QSC_ASYNC_THREADS_MAX);
+			threads = qsc_intutils_min(threads, trecnt);
+			first = 0;
+
+			/* assign a contiguous range of subtrees to each thread */
+			for (size_t i = 0; i < threads; ++i)
+			{
+				jobs[i].base = &base;
+				jobs[i].message = message;
+				jobs[i].msglen = msglen;
+				jobs[i].cvs = cvs;
+				jobs[i].first = first;
+				jobs[i].count = ((trecnt * (i + 1)) / threads) - first;
+				first += jobs[i].count;
+
+				/* the calling thread processes the first range */
+				if (i != 0)
+				{
+					tact[i] = qsc_async_thread_create(&tids[i], kpa_tree_subtrees, &jobs[i]);
+				}
+			}
+
+			kpa_tree_subtrees(&jobs[0]);
+
+			for (size_t i = 1; i < threads; ++i)
+			{
+				if (tact[i] == true)
+				{
+					qsc_async_thread_wait(&tids[i]);
+				}
+				else
+				{
+					kpa_tree_subtrees(&jobs[i]);
+				}
+			}
+
+			/* absorb the subtree chaining values into the root */
+			qsc_keccak_update(&rctx, base.rate, cvs, trecnt * cvlen, QSC_KPA_ROUNDS);
+			elen = keccak_right_encode(enc, msglen * 8);
+			qsc_keccak_update(&rctx, base.rate, enc, elen, QSC_KPA_ROUNDS);
+			qsc_keccak_finalize(&rctx, base.rate, output, outlen, QSC_KECCAK_KPA_TREE_DOMAIN_ID, QSC_KPA_ROUNDS);
+
+			qsc_keccak_dispose(&rctx);
+			qsc_memutils_clear(cvs, trecnt * cvlen);
+			qsc_memutils_alloc_free(cvs);
+			res = true;
+		}
+
+		qsc_kpa_dispose(&base);
+	}
+
+	return res;
+}
+
+/* TurboSHAKE and KangarooTwelve */
+
+static void turboshake_absorb(qsc_keccak_state* ctx, qsc_keccak_rate rate, const uint8_t* message, size_t msglen)
+{
+	assert(ctx != NULL);
+	assert(message != NULL);
+
+	size_t rmdlen;
+
+	if (ctx->position != 0 && (ctx->position + msglen >= (size_t)rate))
+	{
+		rmdlen = (size_t)rate - ctx->position;
+		qsc_memutils_copy((ctx->buffer + ctx->position), message, rmdlen);
+		ctx->dirty = true;
+		keccak_fast_absorb(ctx->state, ctx->buffer, (size_t)rate);
+		keccak_permute_p1600c_rc(ctx->state, QSC_KECCAK_PERMUTATION_MIN_ROUNDS, KT_ROUND_CONSTANTS);
+		ctx->position = 0;
+		message += rmdlen;
+		msglen -= rmdlen;
+	}
+
+	while (msglen >= (size_t)rate)
+	{
+		keccak_fast_absorb(ctx->state, message, (size_t)rate);
+		keccak_permute_p1600c_rc(ctx->state, QSC_KECCAK_PERMUTATION_MIN_ROUNDS, KT_ROUND_CONSTANTS);
+		message += rate;
+		msglen -= rate;
+	}
+
+	if (msglen != 0)
+	{
+		qsc_memutils_copy((ctx->buffer + ctx->position), message, msglen);
+		ctx->position += msglen;
+		ctx->dirty = true;
+	}
+}
+
+static void turboshake_finalize(qsc_keccak_state* ctx, qsc_keccak_rate rate, uint8_t domain, uint8_t* output, size_t outlen)
+{
+	assert(ctx != NULL);
+	assert(output != NULL);
+
+	uint8_t blk[QSC_KECCAK_STATE_BYTE_SIZE] = { 0 };
+	size_t olen;
+
+	/* pad the last block with the domain byte and the final bit */
+	qsc_memutils_clear((ctx->buffer + ctx->position), (size_t)rate - ctx->position);
+	ctx->buffer[ctx->position] = domain;
+	ctx->dirty = true;
+	ctx->buffer[(size_t)rate - 1] |= 0x80U;
+	keccak_fast_absorb(ctx->state, ctx->buffer, (size_t)rate);
+
+	while (outlen != 0)
+	{
+		keccak_permute_p1600c_rc(ctx->state, QSC_KECCAK_PERMUTATION_MIN_ROUNDS, KT_ROUND_CONSTANTS);
+
+		qsc_intutils_le64to8_array(blk, ctx->state, (size_t)rate / sizeof(uint64_t));
+
+		olen = qsc_intutils_min(outlen, (size_t)rate);
+		qsc_memutils_copy(output, blk, olen);
+		output += olen;
+		outlen -= olen;
+	}
+
+	qsc_memutils_clear(blk, sizeof(blk));
+	keccak_buffer_wipe(ctx);
+	ctx->position = 0;
+}
+
+static size_t kt_length_encode(uint8_t* output, size_t value)
+{
+	size_t len;
+	size_t i;
+
+	/* big-endian value with no leading zero bytes, followed by the byte count */
+	len = 0;
+
+	for (size_t v = value; v != 0; v >>= 8)
+	{
+		++len;
+	}
+
+	for (i = 0; i < len; ++i)
+	{
+		output[i] = (uint8_t)(value >> (8 * (len - i - 1)));
+	}
+
+	output[len] = (uint8_t)len;
+
+	return len + 1;
+}
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+static void kt_leaves_x8(const uint8_t* message, uint8_t* output, qsc_keccak_rate rate, size_t cvlen)
+{
+	const int64_t CHK = QSC_KT_CHUNK_SIZE;
+	const size_t RWRDS = (size_t)rate / sizeof(uint64_t);
+	const size_t BLKCNT = QSC_KT_CHUNK_SIZE / (size_t)rate;
+	const size_t RMDWRD = (QSC_KT_CHUNK_SIZE - (BLKCNT * (size_t)rate)) / sizeof(uint64_t);
+	const __m512i idx = _mm512_set_epi64(7 * CHK, 6 * CHK, 5 * CHK, 4 * CHK, 3 * CHK, 2 * CHK, CHK, 0);
+	QSC_ALIGN(64) uint64_t tmp[8] = { 0 };
+	__m512i state[QSC_KECCAK_STATE_SIZE];
+	size_t i;
+
+	for (i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		state[i] = _mm512_setzero_si512();
+	}
+
+	for (size_t j = 0; j < BLKCNT; ++j)
+	{
+		for (i = 0; i < RWRDS; ++i)
+		{
+			state[i] = _mm512_xor_si512(state[i], _mm512_i64gather_epi64(idx, (const void*)message, 1));
+			message += sizeof(uint64_t);
+		}
+
+		keccak_permute_p8x1600_rc(state, QSC_KECCAK_PERMUTATION_MIN_ROUNDS, KT_ROUND_CONSTANTS);
+	}
+
+	/* absorb the chunk remainder and the leaf padding */
+	for (i = 0; i < RMDWRD; ++i)
+	{
+		state[i] = _mm512_xor_si512(state[i], _mm512_i64gather_epi64(idx, (const void*)message, 1));
+		message += sizeof(uint64_t);
+	}
+
+	state[RMDWRD] = _mm512_xor_si512(state[RMDWRD], _mm512_set1_epi64(KT_DOMAIN_LEAF));
+	state[RWRDS - 1] = _mm512_xor_si512(state[RWRDS - 1], _mm512_set1_epi64((int64_t)0x8000000000000000ULL));
+	keccak_permute_p8x1600_rc(state, QSC_KECCAK_PERMUTATION_MIN_ROUNDS, KT_ROUND_CONSTANTS);
+
+	/* the chaining values are the first bytes of each lane state */
+	for (i = 0; i < cvlen / sizeof(uint64_t); ++i)
+	{
+		_mm512_store_si512((__m512i*)tmp, state[i]);
+
+		for (size_t j = 0; j < 8; ++j)
+		{
+			qsc_intutils_le64to8((output + (j * cvlen) + (i * sizeof(uint64_t))), tmp[j]);
+		}
+	}
+}
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX2)
+static void kt_leaves_x4(const uint8_t* message, uint8_t* output, qsc_keccak_rate rate, size_t cvlen)
+{
+	const size_t RWRDS = (size_t)rate / sizeof(uint64_t);
+	const size_t BLKCNT = QSC_KT_CHUNK_SIZE / (size_t)rate;
+	const size_t RMDWRD = (QSC_KT_CHUNK_SIZE - (BLKCNT * (size_t)rate)) / sizeof(uint64_t);
+	const __m256i idx = _mm256_set_epi64x(3 * QSC_KT_CHUNK_SIZE, 2 * QSC_KT_CHUNK_SIZE, QSC_KT_CHUNK_SIZE, 0);
+	QSC_ALIGN(32) uint64_t tmp[4] = { 0 };
+	__m256i state[QSC_KECCAK_STATE_SIZE];
+	size_t i;
+
+	for (i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		state[i] = _mm256_setzero_si256();
+	}
+
+	for (size_t j = 0; j < BLKCNT; ++j)
+	{
+		for (i = 0; i < RWRDS; ++i)
+		{
+			state[i] = _mm256_xor_si256(state[i], _mm256_i64gather_epi64((const long long*)message, idx, 1));
+			message += sizeof(uint64_t);
+		}
+
+		keccak_permute_p4x1600_rc(state, QSC_KECCAK_PERMUTATION_MIN_ROUNDS, KT_ROUND_CONSTANTS);
+	}
+
+	/* absorb the chunk remainder and the leaf padding */
+	for (i = 0; i < RMDWRD; ++i)
+	{
+		state[i] = _mm256_xor_si256(state[i], _mm256_i64gather_epi64((const long long*)message, idx, 1));
+		message += sizeof(uint64_t);
+	}
+
+	state[RMDWRD] = _mm256_xor_si256(state[RMDWRD], _mm256_set1_epi64x(KT_DOMAIN_LEAF));
+	state[RWRDS - 1] = _mm256_xor_si256(state[RWRDS - 1], _mm256_set1_epi64x((int64_t)0x8000000000000000ULL));
+	keccak_permute_p4x1600_rc(state, QSC_KECCAK_PERMUTATION_MIN_ROUNDS, KT_ROUND_CONSTANTS);
+
+	/* the chaining values are the first bytes of each lane state */
+	for (i = 0; i < cvlen / sizeof(uint64_t); ++i)
+	{
+		_mm256_store_si256((__m256i*)tmp, state[i]);
+
+		for (size_t j = 0; j < 4; ++j)
+		{
+			qsc_intutils_le64to8((output + (j * cvlen) + (i * sizeof(uint64_t))), tmp[j]);
+		}
+	}
+}
+#endif
+
+static size_t kt_cv_size(qsc_keccak_rate rate)
+{
+	return (rate == qsc_keccak_rate_128) ? KT128_CV_SIZE : KT256_CV_SIZE;
+}
+
+static void kt_leaf_complete(qsc_kt_state* ctx)
+{
+	uint8_t cv[KT256_CV_SIZE] = { 0 };
+	const size_t CVLEN = kt_cv_size(ctx->rate);
+
+	turboshake_finalize(&ctx->lstate, ctx->rate, KT_DOMAIN_LEAF, cv, CVLEN);
+	turboshake_absorb(&ctx->fstate, ctx->rate, cv, CVLEN);
+	qsc_memutils_clear((uint8_t*)ctx->lstate.state, sizeof(ctx->lstate.state));
+	++ctx->leaves;
+	ctx->position = 0;
+}
+
+void qsc_turboshake128_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, uint8_t domain)
+{
+	assert(output != NULL);
+	assert(message != NULL || msglen == 0);
+
+	qsc_keccak_state ctx = { 0 };
+
+	if (msglen != 0)
+	{
+		turboshake_absorb(&ctx, qsc_keccak_rate_128, message, msglen);
+	}
+
+	turboshake_finalize(&ctx, qsc_keccak_rate_128, domain, output, outlen);
+	qsc_keccak_dispose(&ctx);
+}
+
+void qsc_turboshake256_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, uint8_t domain)
+{
+	assert(output != NULL);
+	assert(message != NULL || msglen == 0);
+
+	qsc_keccak_state ctx = { 0 };
+
+	if (msglen != 0)
+	{
+		turboshake_absorb(&ctx, qsc_keccak_rate_256, message, msglen);
+	}
+
+	turboshake_finalize(&ctx, qsc_keccak_rate_256, domain, output, outlen);
+	qsc_keccak_dispose(&ctx);
+}
+
+void qsc_kt128_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, const uint8_t* custom, size_t custlen)
+{
+	assert(output != NULL);
+
+	qsc_kt_state ctx;
+
+	qsc_kt_initialize(&ctx, qsc_keccak_rate_128);
+	qsc_kt_update(&ctx, message, msglen);
+	qsc_kt_finalize(&ctx, output, outlen, custom, custlen);
+	qsc_kt_dispose(&ctx);
+}
+
+void qsc_kt256_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, const uint8_t* custom, size_t custlen)
+{
+	assert(output != NULL);
+
+	qsc_kt_state ctx;
+
+	qsc_kt_initialize(&ctx, qsc_keccak_rate_256);
+	qsc_kt_update(&ctx, message, msglen);
+	qsc_kt_finalize(&ctx, output, outlen, custom, custlen);
+	qsc_kt_dispose(&ctx);
+}
+
+void qsc_kt_dispose(qsc_kt_state* ctx)
+{
+	assert(ctx != NULL);
+
+	if (ctx != NULL)
+	{
+		qsc_keccak_dispose(&ctx->fstate);
+		qsc_keccak_dispose(&ctx->lstate);
+		ctx->leaves = 0;
+		ctx->position = 0;
+		ctx->tree = false;
+	}
+}
+
+void qsc_kt_finalize(qsc_kt_state* ctx, uint8_t* output, size_t outlen, const uint8_t* custom, size_t custlen)
+{
+	assert(ctx != NULL);
+	assert(output != NULL);
+
+	const uint8_t FINAL[2] = { 0xFF, 0xFF };
+	uint8_t enc[sizeof(size_t) + 1] = { 0 };
+	size_t elen;
+
+	if (ctx != NULL && output != NULL)
+	{
+		/* the customization string and its encoded length are appended to the message */
+		if (custlen != 0)
+		{
+			qsc_kt_update(ctx, custom, custlen);
+		}
+
+		elen = kt_length_encode(enc, custlen);
+		qsc_kt_update(ctx, enc, elen);
+
+		if (ctx->tree == false)
+		{
+			/* a single chunk is hashed directly */
+			turboshake_finalize(&ctx->fstate, ctx->rate, KT_DOMAIN_SINGLE, output, outlen);
+		}
+		else
+		{
+			if (ctx->position != 0)
+			{
+				kt_leaf_complete(ctx);
+			}
+
+			elen = kt_length_encode(enc, ctx->leaves);
+			turboshake_absorb(&ctx->fstate, ctx->rate, enc, elen);
+			turboshake_absorb(&ctx->fstate, ctx->rate, FINAL, sizeof(FINAL));
+			turboshake_finalize(&ctx->fstate, ctx->rate, KT_DOMAIN_FINAL, output, outlen);
+		}
+
+		qsc_kt_initialize(ctx, ctx->rate);
+	}
+}
+
+void qsc_kt_initialize(qsc_kt_state* ctx, qsc_keccak_rate rate)
+{
+	assert(ctx != NULL);
+	assert(rate == qsc_keccak_rate_128 || rate == qsc_keccak_rate_256);
+
+	if (ctx != NULL)
+	{
+		/* the state may be new, so it is reset without reading the dirty flags */
+		qsc_keccak_initialize_state(&ctx->fstate);
+		qsc_keccak_initialize_state(&ctx->lstate);
+		ctx->leaves = 0;
+		ctx->position = 0;
+		ctx->rate = rate;
+		ctx->tree = false;
+	}
+}
+
+void qsc_kt_update(qsc_kt_state* ctx, const uint8_t* message, size_t msglen)
+{
+	assert(ctx != NULL);
+	assert(message != NULL || msglen == 0);
+
+	const uint8_t MARKER[8] = { 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+	size_t plen;
+
+	while (msglen != 0)
+	{
+		if (ctx->tree == false)
+		{
+			if (ctx->position < QSC_KT_CHUNK_SIZE)
+			{
+				/* the first chunk is absorbed directly into the final node */
+				plen = qsc_intutils_min(QSC_KT_CHUNK_SIZE - ctx->position, msglen);
+				turboshake_absorb(&ctx->fstate, ctx->rate, message, plen);
+				ctx->position += plen;
+				message += plen;
+				msglen -= plen;
+			}
+			else
+			{
+				/* more than one chunk; switch to tree hashing */
+				turboshake_absorb(&ctx->fstate, ctx->rate, MARKER, sizeof(MARKER));
+				ctx->tree = true;
+				ctx->position = 0;
+			}
+		}
+#if defined(QSC_SYSTEM_HAS_AVX512)
+		else if (ctx->position == 0 && msglen >= 8 * QSC_KT_CHUNK_SIZE)
+		{
+			uint8_t cvs[8 * KT256_CV_SIZE];
+			const size_t CVLEN = kt_cv_size(ctx->rate);
+
+			kt_leaves_x8(message, cvs, ctx->rate, CVLEN);
+			turboshake_absorb(&ctx->fstate, ctx->rate, cvs, 8 * CVLEN);
+			ctx->leaves += 8;
+			message += 8 * QSC_KT_CHUNK_SIZE;
+			msglen -= 8 * QSC_KT_CHUNK_SIZE;
+		}
+#endif
+#if defined(QSC_SYSTEM_HAS_AVX2)
+		else if (ctx->position == 0 && msglen >= 4 * QSC_KT_CHUNK_SIZE)
+		{
+			uint8_t cvs[4 * KT256_CV_SIZE];
+			const size_t CVLEN = kt_cv_size(ctx->rate);
+
+			kt_leaves_x4(message, cvs, ctx->rate, CVLEN);
+			turboshake_absorb(&ctx->fstate, ctx->rate, cvs, 4 * CVLEN);
+			ctx->leaves += 4;
+			message += 4 * QSC_KT_CHUNK_SIZE;
+			msglen -= 4 * QSC_KT_CHUNK_SIZE;
+		}
+#endif
+		else
+		{
+			/* sequential leaf processing */
+			plen = qsc_intutils_min(QSC_KT_CHUNK_SIZE - ctx->position, msglen);
+			turboshake_absorb(&ctx->lstate, ctx->rate, message, plen);
+			ctx->position += plen;
+			message += plen;
+			msglen -= plen;
+
+			if (ctx->position == QSC_KT_CHUNK_SIZE)
+			{
+				kt_leaf_complete(ctx);
+			}
+		}
+	}
+}
+
+/* ParallelHash */
+
+static void parallelhash_squeeze(qsc_keccak_state* ctx, qsc_keccak_rate rate, uint8_t domain, uint8_t* output, size_t outlen)
+{
+	assert(ctx != NULL);
+	assert(output != NULL);
+
+	uint8_t blk[QSC_KECCAK_STATE_BYTE_SIZE] = { 0 };
+	size_t olen;
+
+	/* pad the buffered bytes with the domain byte and the final bit */
+	qsc_memutils_clear((ctx->buffer + ctx->position), (size_t)rate - ctx->position);
+	ctx->buffer[ctx->position] = domain;
+	ctx->dirty = true;
+	ctx->buffer[(size_t)rate - 1] |= 0x80U;
+	keccak_fast_absorb(ctx->state, ctx->buffer, (size_t)rate);
+
+	while (outlen != 0)
+	{
+		qsc_keccak_squeezeblocks(ctx, blk, 1, rate, QSC_KECCAK_PERMUTATION_ROUNDS);
+		olen = qsc_intutils_min(outlen, (size_t)rate);
+		qsc_memutils_copy(output, blk, olen);
+		output += olen;
+		outlen -= olen;
+	}
+
+	qsc_memutils_clear(blk, sizeof(blk));
+	keccak_buffer_wipe(ctx);
+	ctx->position = 0;
+}
+
+static size_t parallelhash_cv_size(qsc_keccak_rate rate)
+{
+	return (rate == qsc_keccak_rate_128) ? PARALLELHASH128_CV_SIZE : PARALLELHASH256_CV_SIZE;
+}
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+static void parallelhash_blocks_x8(const uint8_t* message, size_t blocksize, uint8_t* output, qsc_keccak_rate rate, size_t cvlen)
+{
+	/* each lane computes cSHAKE(X[i], L, "", ""), which is SHAKE, over one block */
+	uint8_t tmp[8][QSC_KECCAK_128_RATE] = { 0 };
+	__m512i state[QSC_KECCAK_STATE_SIZE];
+	size_t i;
+
+	for (i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		state[i] = _mm512_setzero_si512();
+	}
+
+	qsc_keccakx8_absorb(state, rate, message, message + blocksize, message + (2 * blocksize), message + (3 * blocksize),
+		message + (4 * blocksize), message + (5 * blocksize), message + (6 * blocksize), message + (7 * blocksize), blocksize, QSC_KECCAK_SHAKE_DOMAIN_ID);
+	qsc_keccakx8_squeezeblocks(state, rate, tmp[0], tmp[1], tmp[2], tmp[3], tmp[4], tmp[5], tmp[6], tmp[7], 1);
+
+	for (i = 0; i < 8; ++i)
+	{
+		qsc_memutils_copy((output + (i * cvlen)), tmp[i], cvlen);
+	}
+
+	qsc_memutils_clear((uint8_t*)tmp, sizeof(tmp));
+}
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX2)
+static void parallelhash_blocks_x4(const uint8_t* message, size_t blocksize, uint8_t* output, qsc_keccak_rate rate, size_t cvlen)
+{
+	/* each lane computes cSHAKE(X[i], L, "", ""), which is SHAKE, over one block */
+	uint8_t tmp[4][QSC_KECCAK_128_RATE] = { 0 };
+	__m256i state[QSC_KECCAK_STATE_SIZE];
+	size_t i;
+
+	for (i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		state[i] = _mm256_setzero_si256();
+	}
+
+	qsc_keccakx4_absorb(state, rate, message, message + blocksize, message + (2 * blocksize), message + (3 * blocksize),
+		blocksize, QSC_KECCAK_SHAKE_DOMAIN_ID);
+	qsc_keccakx4_squeezeblocks(state, rate, tmp[0], tmp[1], tmp[2], tmp[3], 1);
+
+	for (i = 0; i < 4; ++i)
+	{
+		qsc_memutils_copy((output + (i * cvlen)), tmp[i], cvlen);
+	}
+
+	qsc_memutils_clear((uint8_t*)tmp, sizeof(tmp));
+}
+#endif
+
+static void parallelhash_block_complete(qsc_parallelhash_state* ctx)
+{
+	uint8_t cv[PARALLELHASH256_CV_SIZE] = { 0 };
+	const size_t CVLEN = parallelhash_cv_size(ctx->rate);
+
+	parallelhash_squeeze(&ctx->lstate, ctx->rate, QSC_KECCAK_SHAKE_DOMAIN_ID, cv, CVLEN);
+	qsc_keccak_update(&ctx->fstate, ctx->rate, cv, CVLEN, QSC_KECCAK_PERMUTATION_ROUNDS);
+	qsc_memutils_clear((uint8_t*)ctx->lstate.state, sizeof(ctx->lstate.state));
+	qsc_memutils_clear(cv, sizeof(cv));
+	++ctx->blocks;
+	ctx->position = 0;
+}
+
+static void parallelhash_finalize(qsc_parallelhash_state* ctx, uint8_t* output, size_t outlen, size_t bitlen)
+{
+	uint8_t enc[sizeof(size_t) + 1] = { 0 };
+	size_t elen;
+
+	/* a trailing partial block is hashed as the last block */
+	if (ctx->position != 0)
+	{
+		parallelhash_block_complete(ctx);
+	}
+
+	elen = keccak_right_encode(enc, ctx->blocks);
+	qsc_keccak_update(&ctx->fstate, ctx->rate, enc, elen, QSC_KECCAK_PERMUTATION_ROUNDS);
+	elen = keccak_right_encode(enc, bitlen);
+	qsc_keccak_update(&ctx->fstate, ctx->rate, enc, elen, QSC_KECCAK_PERMUTATION_ROUNDS);
+	parallelhash_squeeze(&ctx->fstate, ctx->rate, QSC_KECCAK_CSHAKE_DOMAIN_ID, output, outlen);
+	qsc_parallelhash_dispose(ctx);
+}
+
+void qsc_parallelhash128_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, const uint8_t* custom, size_t custlen, size_t blocksize)
+{
+	assert(output != NULL);
+
+	qsc_parallelhash_state ctx;
+
+	qsc_parallelhash_initialize(&ctx, qsc_keccak_rate_128, custom, custlen, blocksize);
+	qsc_parallelhash_update(&ctx, message, msglen);
+	qsc_parallelhash_finalize(&ctx, output, outlen);
+}
+
+void qsc_parallelhash256_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, const uint8_t* custom, size_t custlen, size_t blocksize)
+{
+	assert(output != NULL);
+
+	qsc_parallelhash_state ctx;
+
+	qsc_parallelhash_initialize(&ctx, qsc_keccak_rate_256, custom, custlen, blocksize);
+	qsc_parallelhash_update(&ctx, message, msglen);
+	qsc_parallelhash_finalize(&ctx, output, outlen);
+}
+
+void qsc_parallelhash128_xof_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, const uint8_t* custom, size_t custlen, size_t blocksize)
+{
+	assert(output != NULL);
+
+	qsc_parallelhash_state ctx;
+
+	qsc_parallelhash_initialize(&ctx, qsc_keccak_rate_128, custom, custlen, blocksize);
+	qsc_parallelhash_update(&ctx, message, msglen);
+	qsc_parallelhash_xof_finalize(&ctx, output, outlen);
+}
+
+void qsc_parallelhash256_xof_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, const uint8_t* custom, size_t custlen, size_t blocksize)
+{
+	assert(output != NULL);
+
+	qsc_parallelhash_state ctx;
+
+	qsc_parallelhash_initialize(&ctx, qsc_keccak_rate_256, custom, custlen, blocksize);
+	qsc_parallelhash_update(&ctx, message, msglen);
+	qsc_parallelhash_xof_finalize(&ctx, output, outlen);
+}
+
+void qsc_parallelhash_dispose(qsc_parallelhash_state* ctx)
+{
+	assert(ctx != NULL);
+
+	if (ctx != NULL)
+	{
+		qsc_keccak_dispose(&ctx->fstate);
+		qsc_keccak_dispose(&ctx->lstate);
+		ctx->blocks = 0;
+		ctx->blocksize = 0;
+		ctx->position = 0;
+	}
+}
+
+void qsc_parallelhash_finalize(qsc_parallelhash_state* ctx, uint8_t* output, size_t outlen)
+{
+	assert(ctx != NULL);
+	assert(output != NULL);
+
+	if (ctx != NULL && output != NULL)
+	{
+		parallelhash_finalize(ctx, output, outlen, outlen * 8);
+	}
+}
+
+void qsc_parallelhash_initialize(qsc_parallelhash_state* ctx, qsc_keccak_rate rate, const uint8_t* custom, size_t custlen, size_t blocksize)
+{
+	assert(ctx != NULL);
+	assert(rate == qsc_keccak_rate_128 || rate == qsc_keccak_rate_256);
+	assert(blocksize != 0);
+
+	/* the function name string "ParallelHash" */
+	const uint8_t NAME[12] = { 0x50, 0x61, 0x72, 0x61, 0x6C, 0x6C, 0x65, 0x6C, 0x48, 0x61, 0x73, 0x68 };
+	uint8_t enc[sizeof(size_t) + 1] = { 0 };
+	size_t elen;
+
+	if (ctx != NULL && blocksize != 0)
+	{
+		/* the state may be new, so it is reset without reading the dirty flags */
+		qsc_keccak_initialize_state(&ctx->fstate);
+		qsc_keccak_initialize_state(&ctx->lstate);
+		ctx->blocks = 0;
+		ctx->position = 0;
+		ctx->blocksize = blocksize;
+		ctx->rate = rate;
+
+		/* the outer cSHAKE absorbs bytepad(N, S) followed by left_encode(B) */
+		qsc_keccak_absorb_custom(&ctx->fstate, rate, custom, custlen, NAME, sizeof(NAME), QSC_KECCAK_PERMUTATION_ROUNDS);
+		elen = keccak_left_encode(enc, blocksize);
+		qsc_keccak_update(&ctx->fstate, rate, enc, elen, QSC_KECCAK_PERMUTATION_ROUNDS);
+	}
+}
+
+void qsc_parallelhash_update(qsc_parallelhash_state* ctx, const uint8_t* message, size_t msglen)
+{
+	assert(ctx != NULL);
+	assert(message != NULL || msglen == 0);
+
+	size_t plen;
+
+	if (ctx != NULL && ctx->blocksize != 0)
+	{
+		while (msglen != 0)
+		{
+#if defined(QSC_SYSTEM_HAS_AVX2)
+			/* the lane gathers read whole words, so parallel blocks must be word sized */
+			if (ctx->position == 0 && (ctx->blocksize % sizeof(uint64_t)) == 0 && msglen / 4 >= ctx->blocksize)
+			{
+				uint8_t cvs[8 * PARALLELHASH256_CV_SIZE];
+				const size_t CVLEN = parallelhash_cv_size(ctx->rate);
+				size_t lanes;
+
+#if defined(QSC_SYSTEM_HAS_AVX512)
+				if (msglen / 8 >= ctx->blocksize)
+				{
+					parallelhash_blocks_x8(message, ctx->blocksize, cvs, ctx->rate, CVLEN);
+					lanes = 8;
+				}
+				else
+#endif
+				{
+					parallelhash_blocks_x4(message, ctx->blocksize, cvs, ctx->rate, CVLEN);
+					lanes = 4;
+				}
+
+				qsc_keccak_update(&ctx->fstate, ctx->rate, cvs, lanes * CVLEN, QSC_KECCAK_PERMUTATION_ROUNDS);
+				ctx->blocks += lanes;
+				message += lanes * ctx->blocksize;
+				msglen -= lanes * ctx->blocksize;
+				continue;
+			}
+#endif
+
+			/* sequential block processing */
+			plen = qsc_intutils_min(ctx->blocksize - ctx->position, msglen);
+			qsc_keccak_update(&ctx->lstate, ctx->rate, message, plen, QSC_KECCAK_PERMUTATION_ROUNDS);
+			ctx->position += plen;
+			message += plen;
+			msglen -= plen;
+
+			if (ctx->position == ctx->blocksize)
+			{
+				parallelhash_block_complete(ctx);
+			}
+		}
+	}
+}
+
+void qsc_parallelhash_xof_finalize(qsc_parallelhash_state* ctx, uint8_t* output, size_t outlen)
+{
+	assert(ctx != NULL);
+	assert(output != NULL);
+
+	if (ctx != NULL && output != NULL)
+	{
+		/* the XOF variant encodes an output length of zero */
+		parallelhash_finalize(ctx, output, outlen, 0);
+	}
+}
+
 /* parallel SHAKE x4 */
 
 #if defined(QSC_SYSTEM_HAS_AVX2)
@@ -120,6 +120,18 @@
 */
 #define QSC_KECCAK_KPA_DOMAIN_ID 0x41
 
+/*!
+* \def QSC_KECCAK_KPA_TREE_DOMAIN_ID
+* \brief The KPA tree-mode root domain id
+*/
+#define QSC_KECCAK_KPA_TREE_DOMAIN_ID 0x42
+
+/*!
+* \def QSC_KECCAK_KPA16_DOMAIN_ID
+* \brief The KPA-16 domain id
+*/
+#define QSC_KECCAK_KPA16_DOMAIN_ID 0x43
+
 /*!
 * \def QSC_KECCAK_PERMUTATION_ROUNDS
 * \brief The standard number of permutation rounds
@@ -239,6 +251,7 @@ QSC_EXPORT_API typedef struct
 	uint64_t state[QSC_KECCAK_STATE_SIZE];			/*!< The SHA3 state  */
 	uint8_t buffer[QSC_KECCAK_STATE_BYTE_SIZE];		/*!< The message buffer  */
 	size_t position;								/*!< The buffer position  */
+	bool dirty;										/*!< The message buffer has been written since it was last erased  */
 } qsc_keccak_state;
 
 /*!
@@ -278,6 +291,19 @@ QSC_EXPORT_API void qsc_keccak_absorb(qsc_keccak_state* ctx, qsc_keccak_rate rat
 */
 QSC_EXPORT_API void qsc_keccak_absorb_custom(qsc_keccak_state* ctx, qsc_keccak_rate rate, const uint8_t* custom, size_t custlen, const uint8_t* name, size_t namelen, size_t rounds);
 
+/**
+* \brief Absorb a bytepad encoded key into the Keccak state; the key stage of the keyed functions.
+* Internal function: the state must already hold the absorbed name and customization block,
+* ex. restored from a precomputed state.
+*
+* \param ctx: [struct] The Keccak state structure
+* \param rate: The rate of absorption in bytes
+* \param key: [const] The input key byte array
+* \param keylen: The number of key bytes to process
+* \param rounds: The number of permutation rounds, the default is 24, maximum is 48
+*/
+QSC_EXPORT_API void qsc_keccak_absorb_key(qsc_keccak_state* ctx, qsc_keccak_rate rate, const uint8_t* key, size_t keylen, size_t rounds);
+
 /**
 * \brief Absorb the custom, name, and key arrays into the Keccak state.
 *
@@ -773,7 +799,8 @@ QSC_EXPORT_API void qsc_kmac_initialize(qsc_keccak_state* ctx, qsc_keccak_rate r
 
 /*!
 * \struct qsc_kpa_state
-* \brief The KPA state array; state array must be initialized by the caller
+* \brief The KPA state array; state array must be initialized by the caller.
+* The leaf states are held only in the native (SIMD or scalar) form, and are converted to scalar leaves at finalization.
 */
 QSC_EXPORT_API typedef struct
 {
@@ -781,10 +808,10 @@ QSC_EXPORT_API typedef struct
 	__m512i statew[QSC_KECCAK_STATE_SIZE];								/*!< The AVX512 state array  */
 #elif defined(QSC_SYSTEM_HAS_AVX2)
 	__m256i statew[2][QSC_KECCAK_STATE_SIZE];							/*!< The AVX2 state array  */
-#endif
-
+#else
 	uint64_t state[QSC_KPA_PARALLELISM][QSC_KECCAK_STATE_SIZE];			/*!< The long state array  */
-	uint8_t buffer[QSC_KPA_PARALLELISM * QSC_KECCAK_STATE_BYTE_SIZE];	/*!< The message buffer  */
+#endif
+	uint8_t buffer[QSC_KPA_PARALLELISM * QSC_KECCAK_128_RATE];			/*!< The message buffer, one block per leaf at the largest rate  */
 	size_t position;													/*!< The buffer position  */
 	size_t processed;													/*!< The number of message bytes processed  */
 	qsc_keccak_rate rate;												/*!< The absorption rate  */
@@ -838,6 +865,357 @@ QSC_EXPORT_API void qsc_kpa_update(qsc_kpa_state* ctx, const uint8_t* message, s
 */
 QSC_EXPORT_API void qsc_kpa_dispose(qsc_kpa_state* ctx);
 
+/* KPA-16 */
+
+/*!
+* \def QSC_KPA16_PARALLELISM
+* \brief The KPA-16 degree of parallelization
+*/
+#define QSC_KPA16_PARALLELISM 16
+
+/*!
+* \struct qsc_kpa16_state
+* \brief The KPA-16 state array; processes 16 leaves as two interleaved AVX512 x8 states, or four AVX2 x4 states
+*/
+QSC_EXPORT_API typedef struct
+{
+#if defined(QSC_SYSTEM_HAS_AVX512)
+	__m512i statew[2][QSC_KECCAK_STATE_SIZE];							/*!< The AVX512 state array  */
+#elif defined(QSC_SYSTEM_HAS_AVX2)
+	__m256i statew[4][QSC_KECCAK_STATE_SIZE];							/*!< The AVX2 state array  */
+#else
+	uint64_t state[QSC_KPA16_PARALLELISM][QSC_KECCAK_STATE_SIZE];		/*!< The long state array  */
+#endif
+	uint8_t buffer[QSC_KPA16_PARALLELISM * QSC_KECCAK_128_RATE];		/*!< The message buffer, one block per leaf at the largest rate  */
+	size_t position;													/*!< The buffer position  */
+	size_t processed;													/*!< The number of message bytes processed  */
+	qsc_keccak_rate rate;												/*!< The absorption rate  */
+} qsc_kpa16_state;
+
+/**
+* \brief The KPA-16 finalize function.
+* Long form api: must be used in conjunction with the initialize and blockupdate functions.
+* Final processing and calculation of the MAC code.
+*
+* \warning The state must be initialized before calling.
+*
+* \param ctx: [struct] A reference to the KPA-16 state; must be initialized
+* \param output: The output byte array
+* \param outlen: The number of bytes to extract
+*/
+QSC_EXPORT_API void qsc_kpa16_finalize(qsc_kpa16_state* ctx, uint8_t* output, size_t outlen);
+
+/**
+* \brief Initialize a KPA-16 instance.
+* Long form api: must be used in conjunction with the blockupdate and finalize functions.
+* Key the MAC generator and initialize the internal state.
+* KPA-16 uses the KPA keying and root functions, with 16 leaves, its own leaf names, and the KPA-16 domain id.
+*
+* \param ctx: [struct] A reference to the KPA-16 state; must be initialized
+* \param key: [const] The input key byte array
+* \param keylen: The number of key bytes to process
+* \param custom: [const] The customization string
+* \param custlen: The byte length of the customization string
+*/
+QSC_EXPORT_API void qsc_kpa16_initialize(qsc_kpa16_state* ctx, const uint8_t* key, size_t keylen, const uint8_t* custom, size_t custlen);
+
+/**
+* \brief The KPA-16 message update function.
+* Long form api: must be used in conjunction with the initialize and finalize functions.
+*
+* \warning The state must be initialized before calling.
+*
+* \param ctx: [struct] A reference to the KPA-16 state; must be initialized
+* \param message: [const] The message input byte array
+* \param msglen: The number of message bytes to process
+*/
+QSC_EXPORT_API void qsc_kpa16_update(qsc_kpa16_state* ctx, const uint8_t* message, size_t msglen);
+
+/**
+* \brief Dispose of the KPA-16 state.
+*
+* \warning The dispose function must be called when disposing of the function state.
+* This function safely destroys the internal state.
+*
+* \param ctx: [struct] The KPA-16 state structure
+*/
+QSC_EXPORT_API void qsc_kpa16_dispose(qsc_kpa16_state* ctx);
+
+/* KPA tree mode */
+
+/*!
+* \def QSC_KPA_TREE_SUBTREE_BLOCKS
+* \brief The number of KPA parallel blocks (QSC_KPA_PARALLELISM * rate bytes) in each subtree
+*/
+#define QSC_KPA_TREE_SUBTREE_BLOCKS 1024
+
+/**
+* \brief Compute a KPA tree-mode MAC over a message, using multiple threads.
+*
+* The message is divided into subtrees of QSC_KPA_TREE_SUBTREE_BLOCKS * QSC_KPA_PARALLELISM * rate bytes,
+* the final subtree may be shorter, and an empty message is processed as one empty subtree.
+* Subtree j (starting at zero) is a KPA instance keyed with the key and customization string,
+* with the 64-bit value j + 1 added to word 1 of every leaf state, followed by a leaf permutation.
+* Each subtree is finalized to a chaining value the size of the KPA leaf hash (16, 32, or 64 bytes).
+* The root is a Keccak state at the same rate using QSC_KPA_ROUNDS, which absorbs the chaining values in order,
+* then right_encode(msglen * 8), and is finalized with right_encode(outlen * 8) and QSC_KECCAK_KPA_TREE_DOMAIN_ID.
+* The output does not depend on the number of threads.
+*
+* \param output: The output byte array
+* \param outlen: The number of bytes to extract
+* \param message: [const] The message input byte array
+* \param msglen: The number of message bytes to process
+* \param key: [const] The input key byte array
+* \param keylen: The number of key bytes to process; 16, 32, or 64 bytes
+* \param custom: [const] The customization string
+* \param custlen: The byte length of the customization string
+* \param threads: The number of threads to use; zero uses the processor count
+* \return Returns false if the chaining value buffer could not be allocated
+*/
+QSC_EXPORT_API bool qsc_kpa_tree_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, const uint8_t* key, size_t keylen, const uint8_t* custom, size_t custlen, size_t threads);
+
+/* TurboSHAKE and KangarooTwelve */
+
+/*!
+* \def QSC_KT_CHUNK_SIZE
+* \brief The KangarooTwelve chunk size in bytes
+*/
+#define QSC_KT_CHUNK_SIZE 8192
+
+/*!
+* \def QSC_TURBOSHAKE_DOMAIN_ID
+* \brief The default TurboSHAKE domain separation byte
+*/
+#define QSC_TURBOSHAKE_DOMAIN_ID 0x1F
+
+/*!
+* \struct qsc_kt_state
+* \brief The KangarooTwelve (KT128 and KT256) state; state must be initialized by the caller
+*/
+QSC_EXPORT_API typedef struct
+{
+	qsc_keccak_state fstate;	/*!< The final node state  */
+	qsc_keccak_state lstate;	/*!< The current leaf node state  */
+	size_t leaves;				/*!< The number of leaf chaining values added to the final node  */
+	size_t position;			/*!< The number of bytes processed in the current chunk  */
+	qsc_keccak_rate rate;		/*!< The absorption rate; 128 for KT128, 256 for KT256  */
+	bool tree;					/*!< The message exceeds one chunk and is processed as a tree  */
+} qsc_kt_state;
+
+/**
+* \brief Compute TurboSHAKE128 (RFC 9861) over a message, using the 12-round Keccak-p[1600,12] permutation.
+*
+* \param output: The output byte array
+* \param outlen: The number of bytes to extract
+* \param message: [const] The message input byte array
+* \param msglen: The number of message bytes to process
+* \param domain: The domain separation byte; 0x01 to 0x7F, the default is QSC_TURBOSHAKE_DOMAIN_ID
+*/
+QSC_EXPORT_API void qsc_turboshake128_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, uint8_t domain);
+
+/**
+* \brief Compute TurboSHAKE256 (RFC 9861) over a message, using the 12-round Keccak-p[1600,12] permutation.
+*
+* \param output: The output byte array
+* \param outlen: The number of bytes to extract
+* \param message: [const] The message input byte array
+* \param msglen: The number of message bytes to process
+* \param domain: The domain separation byte; 0x01 to 0x7F, the default is QSC_TURBOSHAKE_DOMAIN_ID
+*/
+QSC_EXPORT_API void qsc_turboshake256_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, uint8_t domain);
+
+/**
+* \brief Compute the KT128 (KangarooTwelve) hash of a message.
+*
+* \param output: The output byte array
+* \param outlen: The number of bytes to extract
+* \param message: [const] The message input byte array
+* \param msglen: The number of message bytes to process
+* \param custom: [const] The customization string
+* \param custlen: The byte length of the customization string
+*/
+QSC_EXPORT_API void qsc_kt128_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, const uint8_t* custom, size_t custlen);
+
+/**
+* \brief Compute the KT256 hash of a message.
+*
+* \param output: The output byte array
+* \param outlen: The number of bytes to extract
+* \param message: [const] The message input byte array
+* \param msglen: The number of message bytes to process
+* \param custom: [const] The customization string
+* \param custlen: The byte length of the customization string
+*/
+QSC_EXPORT_API void qsc_kt256_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, const uint8_t* custom, size_t custlen);
+
+/**
+* \brief Dispose of the KangarooTwelve state.
+*
+* \param ctx: [struct] The KangarooTwelve state structure
+*/
+QSC_EXPORT_API void qsc_kt_dispose(qsc_kt_state* ctx);
+
+/**
+* \brief The KangarooTwelve finalize function.
+* Long form api: must be used in conjunction with the initialize and update functions.
+* The customization string is appended to the message, as defined by RFC 9861.
+*
+* \warning The state must be initialized before calling.
+*
+* \param ctx: [struct] A reference to the KangarooTwelve state; must be initialized
+* \param output: The output byte array
+* \param outlen: The number of bytes to extract
+* \param custom: [const] The customization string
+* \param custlen: The byte length of the customization string
+*/
+QSC_EXPORT_API void qsc_kt_finalize(qsc_kt_state* ctx, uint8_t* output, size_t outlen, const uint8_t* custom, size_t custlen);
+
+/**
+* \brief Initialize a KangarooTwelve instance.
+* Long form api: must be used in conjunction with the update and finalize functions.
+*
+* \param ctx: [struct] A reference to the KangarooTwelve state
+* \param rate: The rate; qsc_keccak_rate_128 for KT128, or qsc_keccak_rate_256 for KT256
+*/
+QSC_EXPORT_API void qsc_kt_initialize(qsc_kt_state* ctx, qsc_keccak_rate rate);
+
+/**
+* \brief The KangarooTwelve message update function.
+* Runs of eight (AVX512) or four (AVX2) whole chunks are processed in parallel.
+* Long form api: must be used in conjunction with the initialize and finalize functions.
+*
+* \warning The state must be initialized before calling.
+*
+* \param ctx: [struct] A reference to the KangarooTwelve state; must be initialized
+* \param message: [const] The message input byte array
+* \param msglen: The number of message bytes to process
+*/
+QSC_EXPORT_API void qsc_kt_update(qsc_kt_state* ctx, const uint8_t* message, size_t msglen);
+
+/* ParallelHash */
+
+/*!
+* \struct qsc_parallelhash_state
+* \brief The SP 800-185 ParallelHash state; state must be initialized by the caller
+*/
+QSC_EXPORT_API typedef struct
+{
+	qsc_keccak_state fstate;	/*!< The outer cSHAKE state  */
+	qsc_keccak_state lstate;	/*!< The current block state  */
+	size_t blocks;				/*!< The number of block chaining values added to the outer state  */
+	size_t blocksize;			/*!< The block size B in bytes  */
+	size_t position;			/*!< The number of bytes processed in the current block  */
+	qsc_keccak_rate rate;		/*!< The absorption rate; 128 for ParallelHash128, 256 for ParallelHash256  */
+} qsc_parallelhash_state;
+
+/**
+* \brief Compute the ParallelHash128 (SP 800-185) hash of a message.
+*
+* \param output: The output byte array
+* \param outlen: The number of bytes to extract; the output length is bound to the hash
+* \param message: [const] The message input byte array
+* \param msglen: The number of message bytes to process
+* \param custom: [const] The customization string
+* \param custlen: The byte length of the customization string
+* \param blocksize: The block size B in bytes; must be non-zero
+*/
+QSC_EXPORT_API void qsc_parallelhash128_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, const uint8_t* custom, size_t custlen, size_t blocksize);
+
+/**
+* \brief Compute the ParallelHash256 (SP 800-185) hash of a message.
+*
+* \param output: The output byte array
+* \param outlen: The number of bytes to extract; the output length is bound to the hash
+* \param message: [const] The message input byte array
+* \param msglen: The number of message bytes to process
+* \param custom: [const] The customization string
+* \param custlen: The byte length of the customization string
+* \param blocksize: The block size B in bytes; must be non-zero
+*/
+QSC_EXPORT_API void qsc_parallelhash256_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, const uint8_t* custom, size_t custlen, size_t blocksize);
+
+/**
+* \brief Compute the ParallelHashXOF128 (SP 800-185) output of a message.
+*
+* \param output: The output byte array
+* \param outlen: The number of bytes to extract
+* \param message: [const] The message input byte array
+* \param msglen: The number of message bytes to process
+* \param custom: [const] The customization string
+* \param custlen: The byte length of the customization string
+* \param blocksize: The block size B in bytes; must be non-zero
+*/
+QSC_EXPORT_API void qsc_parallelhash128_xof_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, const uint8_t* custom, size_t custlen, size_t blocksize);
+
+/**
+* \brief Compute the ParallelHashXOF256 (SP 800-185) output of a message.
+*
+* \param output: The output byte array
+* \param outlen: The number of bytes to extract
+* \param message: [const] The message input byte array
+* \param msglen: The number of message bytes to process
+* \param custom: [const] The customization string
+* \param custlen: The byte length of the customization string
+* \param blocksize: The block size B in bytes; must be non-zero
+*/
+QSC_EXPORT_API void qsc_parallelhash256_xof_compute(uint8_t* output, size_t outlen, const uint8_t* message, size_t msglen, const uint8_t* custom, size_t custlen, size_t blocksize);
+
+/**
+* \brief Dispose of the ParallelHash state.
+*
+* \param ctx: [struct] The ParallelHash state structure
+*/
+QSC_EXPORT_API void qsc_parallelhash_dispose(qsc_parallelhash_state* ctx);
+
+/**
+* \brief The ParallelHash finalize function; the output length is bound to the hash.
+* Long form api: must be used in conjunction with the initialize and update functions.
+*
+* \warning The state must be initialized before calling.
+*
+* \param ctx: [struct] A reference to the ParallelHash state; must be initialized
+* \param output: The output byte array
+* \param outlen: The number of bytes to extract
+*/
+QSC_EXPORT_API void qsc_parallelhash_finalize(qsc_parallelhash_state* ctx, uint8_t* output, size_t outlen);
+
+/**
+* \brief Initialize a ParallelHash instance.
+* Long form api: must be used in conjunction with the update and finalize functions.
+*
+* \param ctx: [struct] A reference to the ParallelHash state
+* \param rate: The rate; qsc_keccak_rate_128 for ParallelHash128, or qsc_keccak_rate_256 for ParallelHash256
+* \param custom: [const] The customization string
+* \param custlen: The byte length of the customization string
+* \param blocksize: The block size B in bytes; must be non-zero
+*/
+QSC_EXPORT_API void qsc_parallelhash_initialize(qsc_parallelhash_state* ctx, qsc_keccak_rate rate, const uint8_t* custom, size_t custlen, size_t blocksize);
+
+/**
+* \brief The ParallelHash message update function.
+* Runs of eight (AVX512) or four (AVX2) whole blocks are processed in parallel.
+* Long form api: must be used in conjunction with the initialize and finalize functions.
+*
+* \warning The state must be initialized before calling.
+*
+* \param ctx: [struct] A reference to the ParallelHash state; must be initialized
+* \param message: [const] The message input byte array
+* \param msglen: The number of message bytes to process
+*/
+QSC_EXPORT_API void qsc_parallelhash_update(qsc_parallelhash_state* ctx, const uint8_t* message, size_t msglen);
+
+/**
+* \brief The ParallelHashXOF finalize function; the output length is not bound to the hash.
+* Long form api: must be used in conjunction with the initialize and update functions.
+*
+* \warning The state must be initialized before calling.
+*
+* \param ctx: [struct] A reference to the ParallelHash state; must be initialized
+* \param output: The output byte array
+* \param outlen: The number of bytes to extract
+*/
+QSC_EXPORT_API void qsc_parallelhash_xof_finalize(qsc_parallelhash_state* ctx, uint8_t* output, size_t outlen);
+
 /* parallel Keccak x4 */
 
 #if defined(QSC_SYSTEM_HAS_AVX2)
@@ -877,6 +1255,16 @@ void qsc_keccakx4_absorb(__m256i state[QSC_KECCAK_STATE_SIZE], qsc_keccak_rate r
 void qsc_keccakx4_squeezeblocks(__m256i state[QSC_KECCAK_STATE_SIZE], qsc_keccak_rate rate,
 	uint8_t* out0, uint8_t* out1, uint8_t* out2, uint8_t* out3, size_t nblocks);
 
+/**
+* \brief Permute 4 Keccak states simultaneously using SIMD instructions.
+* Internal function: can be used in external constructions.
+* This function requires the AVX2 instruction set.
+*
+* \param state: The interleaved Keccak state array
+* \param rounds: The number of permutation rounds, the default and maximum is 24
+*/
+void qsc_keccak_permute_p4x1600(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rounds);
+
 #endif
 
 /* parallel Keccak x8 */
@@ -924,6 +1312,16 @@ void qsc_keccakx8_squeezeblocks(__m512i state[QSC_KECCAK_STATE_SIZE], qsc_keccak
 	uint8_t* out0, uint8_t* out1, uint8_t* out2, uint8_t* out3, uint8_t* out4,
 	uint8_t* out5, uint8_t* out6, uint8_t* out7, size_t nblocks);
 
+/**
+* \brief Permute 8 Keccak states simultaneously using SIMD instructions.
+* Internal function: can be used in external constructions.
+* This function requires the AVX512 instruction set.
+*
+* \param state: The interleaved Keccak state array
+* \param rounds: The number of permutation rounds, the default and maximum is 24
+*/
+void qsc_keccak_permute_p8x1600(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rounds);
+
 #endif
 
 /* parallel SHAKE x4 */
@@ -1,6 +1,7 @@
 #include "sha3_test.h"
 #include "testutils.h"
 #include "intutils.h"
+#include "memutils.h"
 #include "sha3.h"
 
 bool qsctest_sha3_256_kat()
@@ -1096,6 +1097,848 @@ bool qsctest_kpa_512_kat()
 	return status;
 }
 
+bool qsctest_kpa16_kat()
+{
+	uint8_t cust168[21] = { 0 };
+	uint8_t exp256a[32] = { 0 };
+	uint8_t exp256b[32] = { 0 };
+	uint8_t exp512a[64] = { 0 };
+	uint8_t key512[64] = { 0 };
+	uint8_t msg[(2 * QSC_KPA16_PARALLELISM * QSC_KECCAK_128_RATE) + 100] = { 0 };
+	uint8_t output[64] = { 0 };
+	qsc_kpa16_state ctx;
+	bool status;
+
+	qsctest_hex_to_bin("4D7920546167676564204170706C69636174696F6E", cust168, sizeof(cust168));
+	qsctest_hex_to_bin("F2296269539CE6D7EBF8243EE75B89AA0F620471FD9E00E48761682C96CC1552", exp256a, sizeof(exp256a));
+	qsctest_hex_to_bin("B484C40D22867527BFE8F083411A60EABB8035035819645308240C252C6F055F", exp256b, sizeof(exp256b));
+	qsctest_hex_to_bin("3F156A7592E1C62697D2E1766FF41E2E3361E77843F2036064DCDAE221512374"
+		"2277BE9CDAD06880E3F6F6581666C139E5C26E2DFFBFB14162957BC18D775CCC", exp512a, sizeof(exp512a));
+	qsctest_hex_to_bin("000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+		"202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F", key512, sizeof(key512));
+
+	for (size_t i = 0; i < sizeof(msg); ++i)
+	{
+		msg[i] = (uint8_t)i;
+	}
+
+	status = true;
+
+	/* two full blocks and a partial block, updated in two uneven parts */
+	qsc_kpa16_initialize(&ctx, key512, QSC_KPA_256_KEY_SIZE, cust168, sizeof(cust168));
+	qsc_kpa16_update(&ctx, msg, 1000);
+	qsc_kpa16_update(&ctx, msg + 1000, sizeof(msg) - 1000);
+	qsc_kpa16_finalize(&ctx, output, sizeof(exp256a));
+
+	if (qsc_intutils_are_equal8(output, exp256a, sizeof(exp256a)) == false)
+	{
+		qsctest_print_safe("Failure! kpa16_kat: output does not match the known answer -KS1 \n");
+		status = false;
+	}
+
+	qsc_intutils_clear8(output, sizeof(output));
+	qsc_kpa16_initialize(&ctx, key512, QSC_KPA_256_KEY_SIZE, NULL, 0);
+	qsc_kpa16_update(&ctx, msg, 32);
+	qsc_kpa16_finalize(&ctx, output, sizeof(exp256b));
+
+	if (qsc_intutils_are_equal8(output, exp256b, sizeof(exp256b)) == false)
+	{
+		qsctest_print_safe("Failure! kpa16_kat: output does not match the known answer -KS2 \n");
+		status = false;
+	}
+
+	qsc_intutils_clear8(output, sizeof(output));
+	qsc_kpa16_initialize(&ctx, key512, sizeof(key512), cust168, sizeof(cust168));
+	qsc_kpa16_update(&ctx, msg, sizeof(msg));
+	qsc_kpa16_finalize(&ctx, output, sizeof(exp512a));
+
+	if (qsc_intutils_are_equal8(output, exp512a, sizeof(exp512a)) == false)
+	{
+		qsctest_print_safe("Failure! kpa16_kat: output does not match the known answer -KS3 \n");
+		status = false;
+	}
+
+	qsc_kpa16_dispose(&ctx);
+
+	return status;
+}
+
+bool qsctest_kpa_tree_kat()
+{
+	const size_t MSGLEN = (QSC_KECCAK_256_RATE * QSC_KPA_PARALLELISM * QSC_KPA_TREE_SUBTREE_BLOCKS * 3) + 1000;
+	uint8_t cust168[21] = { 0 };
+	uint8_t exp256a[32] = { 0 };
+	uint8_t exp256b[32] = { 0 };
+	uint8_t key256[32] = { 0 };
+	uint8_t output[32] = { 0 };
+	uint8_t otp[32] = { 0 };
+	uint8_t* msg;
+	bool status;
+
+	qsctest_hex_to_bin("4D7920546167676564204170706C69636174696F6E", cust168, sizeof(cust168));
+	qsctest_hex_to_bin("839E38A8E3BD0E41CD9237EC73E79518D27F6E803E511039E0AD57A5DB25C1E7", exp256a, sizeof(exp256a));
+	qsctest_hex_to_bin("D96A775E478D7979B092D3962330E3D2D6C0E3E48251E5AEF7E2FBB114210E13", exp256b, sizeof(exp256b));
+	qsctest_hex_to_bin("000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F", key256, sizeof(key256));
+
+	status = false;
+	msg = (uint8_t*)qsc_memutils_malloc(MSGLEN);
+
+	if (msg != NULL)
+	{
+		status = true;
+
+		for (size_t i = 0; i < MSGLEN; ++i)
+		{
+			msg[i] = (uint8_t)i;
+		}
+
+		/* three full subtrees and a partial subtree */
+		qsc_kpa_tree_compute(output, sizeof(output), msg, MSGLEN, key256, sizeof(key256), cust168, sizeof(cust168), 1);
+
+		if (qsc_intutils_are_equal8(output, exp256a, sizeof(exp256a)) == false)
+		{
+			qsctest_print_safe("Failure! kpa_tree_kat: output does not match the known answer -KT1 \n");
+			status = false;
+		}
+
+		/* the output must not depend on the thread count */
+		for (size_t i = 2; i <= 5; ++i)
+		{
+			qsc_kpa_tree_compute(otp, sizeof(otp), msg, MSGLEN, key256, sizeof(key256), cust168, sizeof(cust168), i);
+
+			if (qsc_intutils_are_equal8(output, otp, sizeof(otp)) == false)
+			{
+				qsctest_print_safe("Failure! kpa_tree_kat: threaded output does not match -KT2 \n");
+				status = false;
+			}
+		}
+
+		/* an empty message is a single empty subtree */
+		qsc_kpa_tree_compute(output, sizeof(output), msg, 0, key256, sizeof(key256), NULL, 0, 0);
+
+		if (qsc_intutils_are_equal8(output, exp256b, sizeof(exp256b)) == false)
+		{
+			qsctest_print_safe("Failure! kpa_tree_kat: output does not match the known answer -KT3 \n");
+			status = false;
+		}
+
+		qsc_memutils_alloc_free(msg);
+	}
+
+	return status;
+}
+
+static void kt_pattern(uint8_t* output, size_t length)
+{
+	/* the RFC 9861 test pattern: ptn(n) = 00 01 .. F9 FA 00 01 .. repeated to n bytes */
+	for (size_t i = 0; i < length; ++i)
+	{
+		output[i] = (uint8_t)(i % 251);
+	}
+}
+
+bool qsctest_kt128_kat()
+{
+	const size_t MSGLEN = 17 * 17 * 17 * 17;
+	const char* PTNEXP[5] =
+	{
+		"2BDA92450E8B147F8A7CB629E784A058EFCA7CF7D8218E02D345DFAA65244A1F",
+		"6BF75FA2239198DB4772E36478F8E19B0F371205F6A9A93A273F51DF37122888",
+		"0C315EBCDEDBF61426DE7DCF8FB725D1E74675D7F5327A5067F367B108ECB67C",
+		"CB552E2EC77D9910701D578B457DDF772C12E322E4EE7FE417F92C758F0D59D0",
+		"8701045E22205345FF4DDA05555CBB5C3AF1A771C2B89BAEF37DB43D9998B9FE"
+	};
+	uint8_t exp[64] = { 0 };
+	uint8_t output[10032] = { 0 };
+	qsc_kt_state ctx;
+	uint8_t* cust;
+	uint8_t* msg;
+	size_t plen;
+	bool status;
+
+	status = false;
+	msg = (uint8_t*)qsc_memutils_malloc(MSGLEN);
+	cust = (uint8_t*)qsc_memutils_malloc(8190);
+
+	if (msg != NULL && cust != NULL)
+	{
+		status = true;
+
+		/* M = empty, C = empty, 32 and 64 byte outputs */
+		qsctest_hex_to_bin("1AC2D450FC3B4205D19DA7BFCA1B37513C0803577AC7167F06FE2CE1F0EF39E5"
+			"4269C056B8C82E48276038B6D292966CC07A3D4645272E31FF38508139EB0A71", exp, sizeof(exp));
+		qsc_kt128_compute(output, 32, msg, 0, NULL, 0);
+
+		if (qsc_intutils_are_equal8(output, exp, 32) == false)
+		{
+			qsctest_print_safe("Failure! kt128_kat: output does not match the known answer -KA1 \n");
+			status = false;
+		}
+
+		qsc_kt128_compute(output, 64, msg, 0, NULL, 0);
+
+		if (qsc_intutils_are_equal8(output, exp, 64) == false)
+		{
+			qsctest_print_safe("Failure! kt128_kat: output does not match the known answer -KA2 \n");
+			status = false;
+		}
+
+		/* the last 32 bytes of a 10032 byte output */
+		qsctest_hex_to_bin("E8DC563642F7228C84684C898405D3A834799158C079B12880277A1D28E2FF6D", exp, 32);
+		qsc_kt128_compute(output, sizeof(output), msg, 0, NULL, 0);
+
+		if (qsc_intutils_are_equal8(output + sizeof(output) - 32, exp, 32) == false)
+		{
+			qsctest_print_safe("Failure! kt128_kat: output does not match the known answer -KA3 \n");
+			status = false;
+		}
+
+		/* M = ptn(17^i), the last two span multiple chunks */
+		plen = 1;
+
+		for (size_t i = 0; i < 5; ++i)
+		{
+			qsctest_hex_to_bin(PTNEXP[i], exp, 32);
+			kt_pattern(msg, plen);
+			qsc_kt128_compute(output, 32, msg, plen, NULL, 0);
+
+			if (qsc_intutils_are_equal8(output, exp, 32) == false)
+			{
+				qsctest_print_safe("Failure! kt128_kat: output does not match the known answer -KA4 \n");
+				status = false;
+			}
+
+			plen *= 17;
+		}
+
+		/* M = ptn(17^4) processed as a stream of uneven updates */
+		qsc_kt_initialize(&ctx, qsc_keccak_rate_128);
+		qsc_kt_update(&ctx, msg, 1);
+		qsc_kt_update(&ctx, msg + 1, 8192);
+		qsc_kt_update(&ctx, msg + 8193, 40000);
+		qsc_kt_update(&ctx, msg + 48193, MSGLEN - 48193);
+		qsc_kt_finalize(&ctx, output, 32, NULL, 0);
+
+		if (qsc_intutils_are_equal8(output, exp, 32) == false)
+		{
+			qsctest_print_safe("Failure! kt128_kat: output does not match the known answer -KA5 \n");
+			status = false;
+		}
+
+		/* M = empty, C = ptn(1) */
+		qsctest_hex_to_bin("FAB658DB63E94A246188BF7AF69A133045F46EE984C56E3C3328CAAF1AA1A583", exp, 32);
+		kt_pattern(cust, 1);
+		qsc_kt128_compute(output, 32, msg, 0, cust, 1);
+
+		if (qsc_intutils_are_equal8(output, exp, 32) == false)
+		{
+			qsctest_print_safe("Failure! kt128_kat: output does not match the known answer -KA6 \n");
+			status = false;
+		}
+
+		/* M = FF, C = ptn(41) */
+		qsctest_hex_to_bin("D848C5068CED736F4462159B9867FD4C20B808ACC3D5BC48E0B06BA0A3762EC4", exp, 32);
+		qsc_memutils_setvalue(msg, 0xFF, 3);
+		kt_pattern(cust, 41);
+		qsc_kt128_compute(output, 32, msg, 1, cust, 41);
+
+		if (qsc_intutils_are_equal8(output, exp, 32) == false)
+		{
+			qsctest_print_safe("Failure! kt128_kat: output does not match the known answer -KA7 \n");
+			status = false;
+		}
+
+		/* M = FF FF FF, C = ptn(41^2) */
+		qsctest_hex_to_bin("C389E5009AE57120854C2E8C64670AC01358CF4C1BAF89447A724234DC7CED74", exp, 32);
+		kt_pattern(cust, 1681);
+		qsc_kt128_compute(output, 32, msg, 3, cust, 1681);
+
+		if (qsc_intutils_are_equal8(output, exp, 32) == false)
+		{
+			qsctest_print_safe("Failure! kt128_kat: output does not match the known answer -KA8 \n");
+			status = false;
+		}
+
+		/* M = ptn(8191), one byte short of a chunk */
+		qsctest_hex_to_bin("1B577636F723643E990CC7D6A659837436FD6A103626600EB8301CD1DBE553D6", exp, 32);
+		kt_pattern(msg, 8191);
+		qsc_kt128_compute(output, 32, msg, 8191, NULL, 0);
+
+		if (qsc_intutils_are_equal8(output, exp, 32) == false)
+		{
+			qsctest_print_safe("Failure! kt128_kat: output does not match the known answer -KA9 \n");
+			status = false;
+		}
+
+		/* M = ptn(8192), C = ptn(8190), the encoded input crosses into a second chunk */
+		qsctest_hex_to_bin("6A7C1B6A5CD0D8C9CA943A4A216CC64604559A2EA45F78570A15253D67BA00AE", exp, 32);
+		kt_pattern(msg, 8192);
+		kt_pattern(cust, 8190);
+		qsc_kt128_compute(output, 32, msg, 8192, cust, 8190);
+
+		if (qsc_intutils_are_equal8(output, exp, 32) == false)
+		{
+			qsctest_print_safe("Failure! kt128_kat: output does not match the known answer -KA10 \n");
+			status = false;
+		}
+	}
+
+	if (msg != NULL)
+	{
+		qsc_memutils_alloc_free(msg);
+	}
+
+	if (cust != NULL)
+	{
+		qsc_memutils_alloc_free(cust);
+	}
+
+	return status;
+}
+
+bool qsctest_kt256_kat()
+{
+	const size_t MSGLEN = 17 * 17 * 17 * 17;
+	uint8_t exp[64] = { 0 };
+	uint8_t output[10064] = { 0 };
+	qsc_kt_state ctx;
+	uint8_t* cust;
+	uint8_t* msg;
+	bool status;
+
+	status = false;
+	msg = (uint8_t*)qsc_memutils_malloc(MSGLEN);
+	cust = (uint8_t*)qsc_memutils_malloc(8190);
+
+	if (msg != NULL && cust != NULL)
+	{
+		status = true;
+
+		/* M = empty, C = empty */
+		qsctest_hex_to_bin("B23D2E9CEA9F4904E02BEC06817FC10CE38CE8E93EF4C89E6537076AF8646404"
+			"E3E8B68107B8833A5D30490AA33482353FD4ADC7148ECB782855003AAEBDE4A9", exp, sizeof(exp));
+		qsc_kt256_compute(output, 64, msg, 0, NULL, 0);
+
+		if (qsc_intutils_are_equal8(output, exp, 64) == false)
+		{
+			qsctest_print_safe("Failure! kt256_kat: output does not match the known answer -KB1 \n");
+			status = false;
+		}
+
+		/* the last 64 bytes of a 10064 byte output */
+		qsctest_hex_to_bin("AD4A1D718CF950506709A4C33396139B4449041FC79A05D68DA35F1E453522E0"
+			"56C64FE94958E7085F2964888259B9932752F3CCD855288EFEE5FCBB8B563069", exp, sizeof(exp));
+		qsc_kt256_compute(output, sizeof(output), msg, 0, NULL, 0);
+
+		if (qsc_intutils_are_equal8(output + sizeof(output) - 64, exp, 64) == false)
+		{
+			qsctest_print_safe("Failure! kt256_kat: output does not match the known answer -KB2 \n");
+			status = false;
+		}
+
+		/* M = ptn(17) */
+		qsctest_hex_to_bin("1BA3C02B1FC514474F06C8979978A9056C8483F4A1B63D0DCCEFE3A28A2F323E"
+			"1CDCCA40EBF006AC76EF0397152346837B1277D3E7FAA9C9653B19075098527B", exp, sizeof(exp));
+		kt_pattern(msg, 17);
+		qsc_kt256_compute(output, 64, msg, 17, NULL, 0);
+
+		if (qsc_intutils_are_equal8(output, exp, 64) == false)
+		{
+			qsctest_print_safe("Failure! kt256_kat: output does not match the known answer -KB3 \n");
+			status = false;
+		}
+
+		/* M = ptn(17^3) */
+		qsctest_hex_to_bin("647EFB49FE9D717500171B41E7F11BD491544443209997CE1C2530D15EB1FFBB"
+			"598935EF954528FFC152B1E4D731EE2683680674365CD191D562BAE753B84AA5", exp, sizeof(exp));
+		kt_pattern(msg, 4913);
+		qsc_kt256_compute(output, 64, msg, 4913, NULL, 0);
+
+		if (qsc_intutils_are_equal8(output, exp, 64) == false)
+		{
+			qsctest_print_safe("Failure! kt256_kat: output does not match the known answer -KB4 \n");
+			status = false;
+		}
+
+		/* M = ptn(17^4), one-shot and streamed */
+		qsctest_hex_to_bin("B06275D284CD1CF205BCBE57DCCD3EC1FF6686E3ED15776383E1F2FA3C6AC8F0"
+			"8BF8A162829DB1A44B2A43FF83DD89C3CF1CEB61EDE659766D5CCF817A62BA8D", exp, sizeof(exp));
+		kt_pattern(msg, MSGLEN);
+		qsc_kt256_compute(output, 64, msg, MSGLEN, NULL, 0);
+
+		if (qsc_intutils_are_equal8(output, exp, 64) == false)
+		{
+			qsctest_print_safe("Failure! kt256_kat: output does not match the known answer -KB5 \n");
+			status = false;
+		}
+
+		qsc_intutils_clear8(output, 64);
+		qsc_kt_initialize(&ctx, qsc_keccak_rate_256);
+		qsc_kt_update(&ctx, msg, 9000);
+		qsc_kt_update(&ctx, msg + 9000, 33);
+		qsc_kt_update(&ctx, msg + 9033, MSGLEN - 9033);
+		qsc_kt_finalize(&ctx, output, 64, NULL, 0);
+
+		if (qsc_intutils_are_equal8(output, exp, 64) == false)
+		{
+			qsctest_print_safe("Failure! kt256_kat: output does not match the known answer -KB6 \n");
+			status = false;
+		}
+
+		/* M = FF, C = ptn(41) */
+		qsctest_hex_to_bin("47EF96DD616F200937AA7847E34EC2FEAE8087E3761DC0F8C1A154F51DC9CCF8"
+			"45D7ADBCE57FF64B639722C6A1672E3BF5372D87E00AFF89BE97240756998853", exp, sizeof(exp));
+		qsc_memutils_setvalue(msg, 0xFF, 1);
+		kt_pattern(cust, 41);
+		qsc_kt256_compute(output, 64, msg, 1, cust, 41);
+
+		if (qsc_intutils_are_equal8(output, exp, 64) == false)
+		{
+			qsctest_print_safe("Failure! kt256_kat: output does not match the known answer -KB7 \n");
+			status = false;
+		}
+
+		/* M = ptn(8192), C = ptn(8190) */
+		qsctest_hex_to_bin("F4B5908B929FFE01E0F79EC2F21243D41A396B2E7303A6AF1D6399CD6C7A0A2D"
+			"D7C4F607E8277F9C9B1CB4AB9DDC59D4B92D1FC7558441F1832C3279A4241B8B", exp, sizeof(exp));
+		kt_pattern(msg, 8192);
+		kt_pattern(cust, 8190);
+		qsc_kt256_compute(output, 64, msg, 8192, cust, 8190);
+
+		if (qsc_intutils_are_equal8(output, exp, 64) == false)
+		{
+			qsctest_print_safe("Failure! kt256_kat: output does not match the known answer -KB8 \n");
+			status = false;
+		}
+	}
+
+	if (msg != NULL)
+	{
+		qsc_memutils_alloc_free(msg);
+	}
+
+	if (cust != NULL)
+	{
+		qsc_memutils_alloc_free(cust);
+	}
+
+	return status;
+}
+
+bool qsctest_turboshake_kat()
+{
+	uint8_t exp[64] = { 0 };
+	uint8_t msg[289] = { 0 };
+	uint8_t output[64] = { 0 };
+	bool status;
+
+	status = true;
+
+	/* TurboSHAKE128, M = empty, D = 1F */
+	qsctest_hex_to_bin("1E415F1C5983AFF2169217277D17BB538CD945A397DDEC541F1CE41AF2C1B74C", exp, 32);
+	qsc_turboshake128_compute(output, 32, msg, 0, QSC_TURBOSHAKE_DOMAIN_ID);
+
+	if (qsc_intutils_are_equal8(output, exp, 32) == false)
+	{
+		qsctest_print_safe("Failure! turboshake_kat: output does not match the known answer -TS1 \n");
+		status = false;
+	}
+
+	/* TurboSHAKE128, M = ptn(17) */
+	qsctest_hex_to_bin("9C97D036A3BAC819DB70EDE0CA554EC6E4C2A1A4FFBFD9EC269CA6A111161233", exp, 32);
+	kt_pattern(msg, 17);
+	qsc_turboshake128_compute(output, 32, msg, 17, QSC_TURBOSHAKE_DOMAIN_ID);
+
+	if (qsc_intutils_are_equal8(output, exp, 32) == false)
+	{
+		qsctest_print_safe("Failure! turboshake_kat: output does not match the known answer -TS2 \n");
+		status = false;
+	}
+
+	/* TurboSHAKE128, M = ptn(17^2), spans two blocks */
+	qsctest_hex_to_bin("96C77C279E0126F7FC07C9B07F5CDAE1E0BE60BDBE10620040E75D7223A624D2", exp, 32);
+	kt_pattern(msg, 289);
+	qsc_turboshake128_compute(output, 32, msg, 289, QSC_TURBOSHAKE_DOMAIN_ID);
+
+	if (qsc_intutils_are_equal8(output, exp, 32) == false)
+	{
+		qsctest_print_safe("Failure! turboshake_kat: output does not match the known answer -TS3 \n");
+		status = false;
+	}
+
+	/* TurboSHAKE128, non-default domain bytes */
+	qsctest_hex_to_bin("012AD664922CE3F81B058735B50AACBDE383F1A9A75180B4B9F929550A5552B5", exp, 32);
+	qsc_memutils_setvalue(msg, 0xFF, 7);
+	qsc_turboshake128_compute(output, 32, msg, 1, 0x01);
+
+	if (qsc_intutils_are_equal8(output, exp, 32) == false)
+	{
+		qsctest_print_safe("Failure! turboshake_kat: output does not match the known answer -TS4 \n");
+		status = false;
+	}
+
+	qsctest_hex_to_bin("3D03988BB59E681851A192F429AE03988E8F444BC06036A3F1A7D2CCD758D174", exp, 32);
+	qsc_turboshake128_compute(output, 32, msg, 3, 0x06);
+
+	if (qsc_intutils_are_equal8(output, exp, 32) == false)
+	{
+		qsctest_print_safe("Failure! turboshake_kat: output does not match the known answer -TS5 \n");
+		status = false;
+	}
+
+	qsctest_hex_to_bin("8DEEAA1AEC47CCEE569F659C21DFA8E112DB3CEE37B18178B2ACD805B799CC37", exp, 32);
+	qsc_turboshake128_compute(output, 32, msg, 7, 0x0B);
+
+	if (qsc_intutils_are_equal8(output, exp, 32) == false)
+	{
+		qsctest_print_safe("Failure! turboshake_kat: output does not match the known answer -TS6 \n");
+		status = false;
+	}
+
+	/* TurboSHAKE256, M = empty, D = 1F */
+	qsctest_hex_to_bin("367A329DAFEA871C7802EC67F905AE13C57695DC2C6663C61035F59A18F8E7DB"
+		"11EDC0E12E91EA60EB6B32DF06DD7F002FBAFABB6E13EC1CC20D995547600DB0", exp, sizeof(exp));
+	qsc_turboshake256_compute(output, 64, msg, 0, QSC_TURBOSHAKE_DOMAIN_ID);
+
+	if (qsc_intutils_are_equal8(output, exp, 64) == false)
+	{
+		qsctest_print_safe("Failure! turboshake_kat: output does not match the known answer -TS7 \n");
+		status = false;
+	}
+
+	/* TurboSHAKE256, non-default domain bytes */
+	qsctest_hex_to_bin("403108CF3FA80ED8A5C80228381E4D0B1A563B11E7A07CC65D175F37CBC6C9A2"
+		"3746B5FC21EC1E6849BD0504CD05C0FD4CAD3141DA35905F5E3A84DF5EC80864", exp, sizeof(exp));
+	qsc_turboshake256_compute(output, 64, msg, 1, 0x01);
+
+	if (qsc_intutils_are_equal8(output, exp, 64) == false)
+	{
+		qsctest_print_safe("Failure! turboshake_kat: output does not match the known answer -TS8 \n");
+		status = false;
+	}
+
+	qsctest_hex_to_bin("BB36764951EC97E9D85F7EE9A67A7718FC005CF42556BE79CE12C0BDE50E5736"
+		"D6632B0D0DFB202D1BBB8FFE3DD74CB00834FA756CB03471BAB13A1E2C16B3C0", exp, sizeof(exp));
+	qsc_turboshake256_compute(output, 64, msg, 7, 0x0B);
+
+	if (qsc_intutils_are_equal8(output, exp, 64) == false)
+	{
+		qsctest_print_safe("Failure! turboshake_kat: output does not match the known answer -TS9 \n");
+		status = false;
+	}
+
+	/* TurboSHAKE256, M = ptn(17) */
+	qsctest_hex_to_bin("B3BAB0300E6A191FBE6137939835923578794EA54843F5011090FA2F3780A9E5"
+		"CB22C59D78B40A0FBFF9E672C0FBE0970BD2C845091C6044D687054DA5D8E9C7", exp, sizeof(exp));
+	kt_pattern(msg, 17);
+	qsc_turboshake256_compute(output, 64, msg, 17, QSC_TURBOSHAKE_DOMAIN_ID);
+
+	if (qsc_intutils_are_equal8(output, exp, 64) == false)
+	{
+		qsctest_print_safe("Failure! turboshake_kat: output does not match the known answer -TS10 \n");
+		status = false;
+	}
+
+	return status;
+}
+
+bool qsctest_parallelhash128_kat()
+{
+	const size_t MSGLEN = 100000;
+	uint8_t cust[21] = { 0 };
+	uint8_t exp[32] = { 0 };
+	uint8_t msg0[24] = { 0 };
+	uint8_t msg1[72] = { 0 };
+	uint8_t output[32] = { 0 };
+	qsc_parallelhash_state ctx;
+	uint8_t* msg;
+	bool status;
+
+	qsctest_hex_to_bin("000102030405060710111213141516172021222324252627", msg0, sizeof(msg0));
+	qsctest_hex_to_bin("000102030405060708090A0B101112131415161718191A1B202122232425262728292A2B"
+		"303132333435363738393A3B404142434445464748494A4B505152535455565758595A5B", msg1, sizeof(msg1));
+	qsctest_hex_to_bin("506172616C6C656C2044617461", cust, 13);
+	status = true;
+
+	/* NIST SP 800-185 ParallelHash128 sample #1 */
+	qsctest_hex_to_bin("BA8DC1D1D979331D3F813603C67F72609AB5E44B94A0B8F9AF46514454A2B4F5", exp, sizeof(exp));
+	qsc_parallelhash128_compute(output, sizeof(output), msg0, sizeof(msg0), NULL, 0, 8);
+
+	if (qsc_intutils_are_equal8(output, exp, sizeof(exp)) == false)
+	{
+		qsctest_print_safe("Failure! parallelhash128_kat: output does not match the known answer -PA1 \n");
+		status = false;
+	}
+
+	/* sample #2 */
+	qsctest_hex_to_bin("FC484DCB3F84DCEEDC353438151BEE58157D6EFED0445A81F165E495795B7206", exp, sizeof(exp));
+	qsc_parallelhash128_compute(output, sizeof(output), msg0, sizeof(msg0), cust, 13, 8);
+
+	if (qsc_intutils_are_equal8(output, exp, sizeof(exp)) == false)
+	{
+		qsctest_print_safe("Failure! parallelhash128_kat: output does not match the known answer -PA2 \n");
+		status = false;
+	}
+
+	/* sample #3 */
+	qsctest_hex_to_bin("F7FD5312896C6685C828AF7E2ADB97E393E7F8D54E3C2EA4B95E5ACA3796E8FC", exp, sizeof(exp));
+	qsc_parallelhash128_compute(output, sizeof(output), msg1, sizeof(msg1), cust, 13, 12);
+
+	if (qsc_intutils_are_equal8(output, exp, sizeof(exp)) == false)
+	{
+		qsctest_print_safe("Failure! parallelhash128_kat: output does not match the known answer -PA3 \n");
+		status = false;
+	}
+
+	/* NIST SP 800-185 ParallelHashXOF128 samples #1 and #3 */
+	qsctest_hex_to_bin("FE47D661E49FFE5B7D999922C062356750CAF552985B8E8CE6667F2727C3C8D3", exp, sizeof(exp));
+	qsc_parallelhash128_xof_compute(output, sizeof(output), msg0, sizeof(msg0), NULL, 0, 8);
+
+	if (qsc_intutils_are_equal8(output, exp, sizeof(exp)) == false)
+	{
+		qsctest_print_safe("Failure! parallelhash128_kat: output does not match the known answer -PA4 \n");
+		status = false;
+	}
+
+	qsctest_hex_to_bin("0127AD9772AB904691987FCC4A24888F341FA0DB2145E872D4EFD255376602F0", exp, sizeof(exp));
+	qsc_parallelhash128_xof_compute(output, sizeof(output), msg1, sizeof(msg1), cust, 13, 12);
+
+	if (qsc_intutils_are_equal8(output, exp, sizeof(exp)) == false)
+	{
+		qsctest_print_safe("Failure! parallelhash128_kat: output does not match the known answer -PA5 \n");
+		status = false;
+	}
+
+	/* a long message with word-sized blocks, one-shot and streamed in uneven updates */
+	msg = (uint8_t*)qsc_memutils_malloc(MSGLEN);
+
+	if (msg != NULL)
+	{
+		for (size_t i = 0; i < MSGLEN; ++i)
+		{
+			msg[i] = (uint8_t)(i % 251);
+		}
+
+		qsctest_hex_to_bin("4D7920546167676564204170706C69636174696F6E", cust, sizeof(cust));
+		qsctest_hex_to_bin("F4492435BCD4B7455EE6C6CD3D627B2D71A0B550F66B03642359201AD280A436", exp, sizeof(exp));
+		qsc_parallelhash128_compute(output, sizeof(output), msg, MSGLEN, cust, sizeof(cust), 1024);
+
+		if (qsc_intutils_are_equal8(output, exp, sizeof(exp)) == false)
+		{
+			qsctest_print_safe("Failure! parallelhash128_kat: output does not match the known answer -PA6 \n");
+			status = false;
+		}
+
+		qsc_intutils_clear8(output, sizeof(output));
+		qsc_parallelhash_initialize(&ctx, qsc_keccak_rate_128, cust, sizeof(cust), 1024);
+		qsc_parallelhash_update(&ctx, msg, 1000);
+		qsc_parallelhash_update(&ctx, msg + 1000, 48);
+		qsc_parallelhash_update(&ctx, msg + 1048, MSGLEN - 1048);
+		qsc_parallelhash_finalize(&ctx, output, sizeof(output));
+
+		if (qsc_intutils_are_equal8(output, exp, sizeof(exp)) == false)
+		{
+			qsctest_print_safe("Failure! parallelhash128_kat: output does not match the known answer -PA7 \n");
+			status = false;
+		}
+
+		qsc_memutils_alloc_free(msg);
+	}
+	else
+	{
+		status = false;
+	}
+
+	return status;
+}
+
+bool qsctest_parallelhash256_kat()
+{
+	const size_t MSGLEN = 100000;
+	uint8_t cust[21] = { 0 };
+	uint8_t exp[64] = { 0 };
+	uint8_t msg0[24] = { 0 };
+	uint8_t msg1[72] = { 0 };
+	uint8_t output[64] = { 0 };
+	qsc_parallelhash_state ctx;
+	uint8_t* msg;
+	bool status;
+
+	qsctest_hex_to_bin("000102030405060710111213141516172021222324252627", msg0, sizeof(msg0));
+	qsctest_hex_to_bin("000102030405060708090A0B101112131415161718191A1B202122232425262728292A2B"
+		"303132333435363738393A3B404142434445464748494A4B505152535455565758595A5B", msg1, sizeof(msg1));
+	qsctest_hex_to_bin("506172616C6C656C2044617461", cust, 13);
+	status = true;
+
+	/* NIST SP 800-185 ParallelHash256 sample #4 */
+	qsctest_hex_to_bin("BC1EF124DA34495E948EAD207DD9842235DA432D2BBC54B4C110E64C45110553"
+		"1B7F2A3E0CE055C02805E7C2DE1FB746AF97A1DD01F43B824E31B87612410429", exp, sizeof(exp));
+	qsc_parallelhash256_compute(output, sizeof(output), msg0, sizeof(msg0), NULL, 0, 8);
+
+	if (qsc_intutils_are_equal8(output, exp, sizeof(exp)) == false)
+	{
+		qsctest_print_safe("Failure! parallelhash256_kat: output does not match the known answer -PB1 \n");
+		status = false;
+	}
+
+	/* sample #5 */
+	qsctest_hex_to_bin("CDF15289B54F6212B4BC270528B49526006DD9B54E2B6ADD1EF6900DDA3963BB"
+		"33A72491F236969CA8AFAEA29C682D47A393C065B38E29FAE651A2091C833110", exp, sizeof(exp));
+	qsc_parallelhash256_compute(output, sizeof(output), msg0, sizeof(msg0), cust, 13, 8);
+
+	if (qsc_intutils_are_equal8(output, exp, sizeof(exp)) == false)
+	{
+		qsctest_print_safe("Failure! parallelhash256_kat: output does not match the known answer -PB2 \n");
+		status = false;
+	}
+
+	/* sample #6 */
+	qsctest_hex_to_bin("69D0FCB764EA055DD09334BC6021CB7E4B61348DFF375DA262671CDEC3EFFA8D"
+		"1B4568A6CCE16B1CAD946DDDE27F6CE2B8DEE4CD1B24851EBF00EB90D43813E9", exp, sizeof(exp));
+	qsc_parallelhash256_compute(output, sizeof(output), msg1, sizeof(msg1), cust, 13, 12);
+
+	if (qsc_intutils_are_equal8(output, exp, sizeof(exp)) == false)
+	{
+		qsctest_print_safe("Failure! parallelhash256_kat: output does not match the known answer -PB3 \n");
+		status = false;
+	}
+
+	/* NIST SP 800-185 ParallelHashXOF256 samples #4 and #5 */
+	qsctest_hex_to_bin("C10A052722614684144D28474850B410757E3CBA87651BA167A5CBDDFF7F4666"
+		"75FBF84BCAE7378AC444BE681D729499AFCA667FB879348BFDDA427863C82F1C", exp, sizeof(exp));
+	qsc_parallelhash256_xof_compute(output, sizeof(output), msg0, sizeof(msg0), NULL, 0, 8);
+
+	if (qsc_intutils_are_equal8(output, exp, sizeof(exp)) == false)
+	{
+		qsctest_print_safe("Failure! parallelhash256_kat: output does not match the known answer -PB4 \n");
+		status = false;
+	}
+
+	qsctest_hex_to_bin("538E105F1A22F44ED2F5CC1674FBD40BE803D9C99BF5F8D90A2C8193F3FE6EA7"
+		"68E5C1A20987E2C9C65FEBED03887A51D35624ED12377594B5585541DC377EFC", exp, sizeof(exp));
+	qsc_parallelhash256_xof_compute(output, sizeof(output), msg0, sizeof(msg0), cust, 13, 8);
+
+	if (qsc_intutils_are_equal8(output, exp, sizeof(exp)) == false)
+	{
+		qsctest_print_safe("Failure! parallelhash256_kat: output does not match the known answer -PB5 \n");
+		status = false;
+	}
+
+	/* a long message with word-sized blocks, one-shot and streamed in uneven updates */
+	msg = (uint8_t*)qsc_memutils_malloc(MSGLEN);
+
+	if (msg != NULL)
+	{
+		for (size_t i = 0; i < MSGLEN; ++i)
+		{
+			msg[i] = (uint8_t)(i % 251);
+		}
+
+		qsctest_hex_to_bin("4D7920546167676564204170706C69636174696F6E", cust, sizeof(cust));
+		qsctest_hex_to_bin("01058483274A2C1C97AAFFAC6379F8BEC2F4B5909A6BEC6EAE0943FEA2B95021"
+			"7AE0E72EB296BC3E651FDC4A756EFD631012D24592B431A12DC7F47ED0A74512", exp, sizeof(exp));
+		qsc_parallelhash256_compute(output, sizeof(output), msg, MSGLEN, cust, sizeof(cust), 1024);
+
+		if (qsc_intutils_are_equal8(output, exp, sizeof(exp)) == false)
+		{
+			qsctest_print_safe("Failure! parallelhash256_kat: output does not match the known answer -PB6 \n");
+			status = false;
+		}
+
+		qsctest_hex_to_bin("430A65B15F60AEF30BC4BC28CAD7B9160BC51D4B620E45A40B8FA0CB7A920EB5"
+			"C08E5DEEE8636C53E0F1802BDB5B560FAC8AD55EF21D2AA32BAA0347C4B9160B", exp, sizeof(exp));
+		qsc_intutils_clear8(output, sizeof(output));
+		qsc_parallelhash_initialize(&ctx, qsc_keccak_rate_256, cust, sizeof(cust), 1024);
+		qsc_parallelhash_update(&ctx, msg, 7);
+		qsc_parallelhash_update(&ctx, msg + 7, 40000);
+		qsc_parallelhash_update(&ctx, msg + 40007, MSGLEN - 40007);
+		qsc_parallelhash_xof_finalize(&ctx, output, sizeof(output));
+
+		if (qsc_intutils_are_equal8(output, exp, sizeof(exp)) == false)
+		{
+			qsctest_print_safe("Failure! parallelhash256_kat: output does not match the known answer -PB7 \n");
+			status = false;
+		}
+
+		qsc_memutils_alloc_free(msg);
+	}
+	else
+	{
+		status = false;
+	}
+
+	return status;
+}
+
+static bool keccak_wipe_is_zero(const uint8_t* input, size_t length)
+{
+	uint8_t acc;
+
+	acc = 0;
+
+	for (size_t i = 0; i < length; ++i)
+	{
+		acc |= input[i];
+	}
+
+	return (acc == 0);
+}
+
+bool qsctest_keccak_wipe()
+{
+	uint8_t key[64] = { 0 };
+	uint8_t msg[QSC_KECCAK_512_RATE + 7] = { 0 };
+	uint8_t output[64] = { 0 };
+	qsc_keccak_state ctx;
+	bool status;
+
+	qsc_memutils_setvalue(key, 0x5A, sizeof(key));
+	qsc_memutils_setvalue(msg, 0xA5, sizeof(msg));
+	status = true;
+
+	/* the partial block of a buffered update is held until finalize or dispose */
+	qsc_sha3_initialize(&ctx);
+	qsc_sha3_update(&ctx, qsc_keccak_rate_512, msg, sizeof(msg));
+
+	if (ctx.dirty == false || ctx.position != sizeof(msg) - QSC_KECCAK_512_RATE)
+	{
+		qsctest_print_safe("Failure! qsctest_keccak_wipe: the buffered update did not mark the buffer -KW1 \n");
+		status = false;
+	}
+
+	qsc_keccak_dispose(&ctx);
+
+	if (ctx.dirty == true || keccak_wipe_is_zero((uint8_t*)ctx.state, sizeof(ctx.state)) == false ||
+		keccak_wipe_is_zero(ctx.buffer, sizeof(ctx.buffer)) == false)
+	{
+		qsctest_print_safe("Failure! qsctest_keccak_wipe: dispose did not erase the state -KW2 \n");
+		status = false;
+	}
+
+	/* the key is absorbed without the buffer, and finalize erases the message bytes,
+	   so the dispose that follows has no buffer to erase */
+	qsc_kmac_initialize(&ctx, qsc_keccak_rate_512, key, sizeof(key), NULL, 0);
+
+	if (ctx.dirty == true)
+	{
+		qsctest_print_safe("Failure! qsctest_keccak_wipe: the key was written to the buffer -KW3 \n");
+		status = false;
+	}
+
+	qsc_kmac_update(&ctx, qsc_keccak_rate_512, msg, sizeof(msg));
+	qsc_kmac_finalize(&ctx, qsc_keccak_rate_512, output, sizeof(output));
+
+	if (ctx.dirty == true || keccak_wipe_is_zero(ctx.buffer, sizeof(ctx.buffer)) == false)
+	{
+		qsctest_print_safe("Failure! qsctest_keccak_wipe: finalize did not erase the buffer -KW4 \n");
+		status = false;
+	}
+
+	qsc_keccak_dispose(&ctx);
+
+	return status;
+}
+
 #if defined(QSC_SYSTEM_HAS_AVX2)
 bool qsctest_kmac128x4_equality()
 {
@@ -2284,6 +3127,78 @@ void qsctest_sha3_run()
 		qsctest_print_safe("Failure! Failed the KPA-512 KAT test. \n");
 	}
 
+	if (qsctest_kpa16_kat() == true)
+	{
+		qsctest_print_safe("Success! Passed the KPA-16 KAT test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the KPA-16 KAT test. \n");
+	}
+
+	if (qsctest_kpa_tree_kat() == true)
+	{
+		qsctest_print_safe("Success! Passed the KPA tree-mode KAT test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the KPA tree-mode KAT test. \n");
+	}
+
+	if (qsctest_kt128_kat() == true)
+	{
+		qsctest_print_safe("Success! Passed the KT128 KAT test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the KT128 KAT test. \n");
+	}
+
+	if (qsctest_kt256_kat() == true)
+	{
+		qsctest_print_safe("Success! Passed the KT256 KAT test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the KT256 KAT test. \n");
+	}
+
+	if (qsctest_turboshake_kat() == true)
+	{
+		qsctest_print_safe("Success! Passed the TurboSHAKE KAT test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the TurboSHAKE KAT test. \n");
+	}
+
+	if (qsctest_parallelhash128_kat() == true)
+	{
+		qsctest_print_safe("Success! Passed the ParallelHash128 KAT test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the ParallelHash128 KAT test. \n");
+	}
+
+	if (qsctest_parallelhash256_kat() == true)
+	{
+		qsctest_print_safe("Success! Passed the ParallelHash256 KAT test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the ParallelHash256 KAT test. \n");
+	}
+
+	if (qsctest_keccak_wipe() == true)
+	{
+		qsctest_print_safe("Success! Passed the Keccak state erasure test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the Keccak state erasure test. \n");
+	}
+
 #if defined(QSC_SYSTEM_HAS_AVX2)
 
 	if (qsctest_kmac128x4_equality() == true)
@@ -163,6 +163,70 @@ bool qsctest_kpa_256_kat(void);
 */
 bool qsctest_kpa_512_kat(void);
 
+/**
+* \brief Tests the KPA-256 tree mode for correct operation using original vectors,
+* and for output equality across thread counts.
+*
+* \return Returns true for success
+*/
+bool qsctest_kpa_tree_kat(void);
+
+/**
+* \brief Tests the 16-leaf Keccak-based Parallel Authentication MAC (KPA-16) function for correct operation,
+* using original vectors.
+*
+* \return Returns true for success
+*/
+bool qsctest_kpa16_kat(void);
+
+/**
+* \brief Tests the KangarooTwelve KT128 function for correct operation,
+* using the RFC 9861 vectors, and the streaming interface for equality.
+*
+* \return Returns true for success
+*/
+bool qsctest_kt128_kat(void);
+
+/**
+* \brief Tests the KangarooTwelve KT256 function for correct operation,
+* using the RFC 9861 vectors, and the streaming interface for equality.
+*
+* \return Returns true for success
+*/
+bool qsctest_kt256_kat(void);
+
+/**
+* \brief Tests the TurboSHAKE128 and TurboSHAKE256 functions for correct operation,
+* using the RFC 9861 vectors.
+*
+* \return Returns true for success
+*/
+bool qsctest_turboshake_kat(void);
+
+/**
+* \brief Tests the ParallelHash128 and ParallelHashXOF128 functions for correct operation,
+* using the NIST SP 800-185 sample vectors, and the streaming interface for equality.
+*
+* \return Returns true for success
+*/
+bool qsctest_parallelhash128_kat(void);
+
+/**
+* \brief Tests the ParallelHash256 and ParallelHashXOF256 functions for correct operation,
+* using the NIST SP 800-185 sample vectors, and the streaming interface for equality.
+*
+* \return Returns true for success
+*/
+bool qsctest_parallelhash256_kat(void);
+
+/**
+* \brief Tests the Keccak state erasure: a buffered update marks the message buffer,
+* and dispose and finalize erase the buffer and clear the mark.
+*
+* \return Returns true for success
+*/
+bool qsctest_keccak_wipe(void);
+
 #if defined(QSC_SYSTEM_HAS_AVX2)
 /**
 * \brief Tests the KMAC-128 AVX2 intrinsics implementation for equality with the sequential implementation.
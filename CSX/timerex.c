@@ -1,9 +1,24 @@
 #include "timerex.h"
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+#	include <Windows.h>
+#endif
+#if defined(QSC_SYSTEM_ARCH_X86_X64)
+#	if defined(QSC_SYSTEM_COMPILER_MSC)
+#		include <intrin.h>
+#	else
+#		include <x86intrin.h>
+#	endif
+#endif
 #if defined(QSC_DEBUG_MODE)
 #	include "consoleutils.h"
 #	include "memutils.h"
 #endif
 
+#if defined(QSC_SYSTEM_ARCH_X86_X64)
+/* the calibrated counter frequency, zero until the first calibration is published */
+static volatile uint64_t timerex_frequency = 0;
+#endif
+
 void qsc_timerex_get_date(char output[QSC_TIMEREX_TIMESTAMP_MAX])
 {
 #if defined(QSC_SYSTEM_OS_WINDOWS)
@@ -158,6 +173,130 @@ uint64_t qsc_timerex_stopwatch_elapsed(clock_t start)
 	return msec;
 }
 
+uint64_t qsc_timerex_monotonic_ns()
+{
+	uint64_t nsec;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	LARGE_INTEGER ctr;
+	LARGE_INTEGER frq;
+
+	QueryPerformanceCounter(&ctr);
+	QueryPerformanceFrequency(&frq);
+	/* split the conversion to avoid overflowing the counter multiplication */
+	nsec = ((uint64_t)(ctr.QuadPart / frq.QuadPart) * 1000000000ULL) +
+		(((uint64_t)(ctr.QuadPart % frq.QuadPart) * 1000000000ULL) / (uint64_t)frq.QuadPart);
+#else
+	struct timespec ts;
+
+#	if defined(CLOCK_MONOTONIC_RAW)
+	/* the raw clock is not slewed by ntp adjustments */
+	clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#	else
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#	endif
+	nsec = ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+#endif
+
+	return nsec;
+}
+
+uint64_t qsc_timerex_stopwatch_elapsed_ns(uint64_t start)
+{
+	return qsc_timerex_monotonic_ns() - start;
+}
+
+uint64_t qsc_timerex_cycles_start()
+{
+	uint64_t cycles;
+
+#if defined(QSC_SYSTEM_ARCH_X86_X64)
+	/* wait for earlier instructions to complete before reading the counter */
+	_mm_lfence();
+	cycles = __rdtsc();
+	_mm_lfence();
+#else
+	cycles = qsc_timerex_monotonic_ns();
+#endif
+
+	return cycles;
+}
+
+uint64_t qsc_timerex_cycles_stop()
+{
+	uint64_t cycles;
+
+#if defined(QSC_SYSTEM_ARCH_X86_X64)
+	uint32_t aux;
+
+	/* rdtscp waits for the timed region to retire, the fence keeps later instructions out */
+	cycles = __rdtscp(&aux);
+	_mm_lfence();
+#else
+	cycles = qsc_timerex_monotonic_ns();
+#endif
+
+	return cycles;
+}
+
+#if defined(QSC_SYSTEM_ARCH_X86_X64)
+static uint64_t timerex_frequency_load()
+{
+#	if defined(QSC_SYSTEM_COMPILER_MSC)
+	return (uint64_t)InterlockedCompareExchange64((volatile LONG64*)&timerex_frequency, 0, 0);
+#	else
+	return __atomic_load_n(&timerex_frequency, __ATOMIC_ACQUIRE);
+#	endif
+}
+
+static void timerex_frequency_publish(uint64_t frequency)
+{
+	/* the first calibration to finish is kept, so every caller returns the same frequency */
+#	if defined(QSC_SYSTEM_COMPILER_MSC)
+	InterlockedCompareExchange64((volatile LONG64*)&timerex_frequency, (LONG64)frequency, 0);
+#	else
+	uint64_t expected;
+
+	expected = 0;
+	__atomic_compare_exchange_n(&timerex_frequency, &expected, frequency, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#	endif
+}
+#endif
+
+uint64_t qsc_timerex_cycles_frequency()
+{
+	uint64_t frequency;
+
+#if defined(QSC_SYSTEM_ARCH_X86_X64)
+	uint64_t cstart;
+	uint64_t nsec;
+	uint64_t tstart;
+
+	frequency = timerex_frequency_load();
+
+	if (frequency == 0)
+	{
+		/* count the cycles over a fixed interval of the monotonic clock */
+		tstart = qsc_timerex_monotonic_ns();
+		cstart = qsc_timerex_cycles_start();
+
+		do
+		{
+			nsec = qsc_timerex_stopwatch_elapsed_ns(tstart);
+		}
+		while (nsec < QSC_TIMEREX_CALIBRATION_NS);
+
+		frequency = (uint64_t)(((double)(qsc_timerex_cycles_stop() - cstart) * 1000000000.0) / (double)nsec);
+		timerex_frequency_publish(frequency);
+		frequency = timerex_frequency_load();
+	}
+#else
+	frequency = 1000000000ULL;
+#endif
+
+	return frequency;
+}
+
 #if defined(QSC_DEBUG_MODE)
 void qsc_timerex_print_values()
 {
@@ -190,5 +329,9 @@ void qsc_timerex_print_values()
 	tms = qsc_timerex_stopwatch_elapsed(elps);
 	qsc_consoleutils_print_ulong(tms);
 	qsc_consoleutils_print_line("");
+
+	qsc_consoleutils_print_safe("Cycle counter frequency: ");
+	qsc_consoleutils_print_ulong(qsc_timerex_cycles_frequency());
+	qsc_consoleutils_print_line("");
 }
 #endif
@@ -34,6 +34,12 @@
 */
 #define QSC_TIMEREX_TIMESTAMP_MAX 80
 
+/*!
+* \def QSC_TIMEREX_CALIBRATION_NS
+* \brief The duration of the time-stamp counter frequency calibration interval in nanoseconds
+*/
+#define QSC_TIMEREX_CALIBRATION_NS 50000000ULL
+
 /**
 * \brief Get the calendar date from the current locale
 *
@@ -71,6 +77,50 @@ QSC_EXPORT_API clock_t qsc_timerex_stopwatch_start();
 */
 QSC_EXPORT_API uint64_t qsc_timerex_stopwatch_elapsed(clock_t start);
 
+/**
+* \brief Returns the value of a monotonic clock in nanoseconds.
+* The clock is not affected by system time changes, and measures elapsed (wall) time
+* rather than process cpu time, so it is valid across threads.
+*
+* \return The monotonic clock time in nanoseconds
+*/
+QSC_EXPORT_API uint64_t qsc_timerex_monotonic_ns();
+
+/**
+* \brief Returns the time difference between a monotonic start time and the current time in nanoseconds
+*
+* \param start: The starting time returned by qsc_timerex_monotonic_ns
+* \return The time difference in nanoseconds
+*/
+QSC_EXPORT_API uint64_t qsc_timerex_stopwatch_elapsed_ns(uint64_t start);
+
+/**
+* \brief Read the time-stamp counter at the start of a timed region.
+* The read is fenced so that earlier instructions retire before the counter is sampled.
+* On systems without a time-stamp counter, the monotonic clock in nanoseconds is returned.
+*
+* \return The starting cycle count
+*/
+QSC_EXPORT_API uint64_t qsc_timerex_cycles_start();
+
+/**
+* \brief Read the time-stamp counter at the end of a timed region, using the serializing rdtscp instruction.
+* On systems without a time-stamp counter, the monotonic clock in nanoseconds is returned.
+*
+* \return The ending cycle count
+*/
+QSC_EXPORT_API uint64_t qsc_timerex_cycles_stop();
+
+/**
+* \brief Returns the time-stamp counter frequency in Hz.
+* The frequency is calibrated against the monotonic clock on the first call and cached.
+* Safe to call from any thread; threads that race on the first call may each calibrate, but all return the first published value.
+* On systems without a time-stamp counter, returns 1000000000 (the cycle functions return nanoseconds).
+*
+* \return The counter frequency in cycles per second
+*/
+QSC_EXPORT_API uint64_t qsc_timerex_cycles_frequency();
+
 #if defined(QSC_DEBUG_MODE)
 /**
 * \brief Print timer function values